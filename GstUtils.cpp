@@ -19,19 +19,27 @@
 
 #include "GstUtils.h"
 #include <inttypes.h>
+#include <atomic>
 #include "PlayerUtils.h"
 
 /**
- * @brief Get the GStreamer Caps based on the provided format and platform.
+ * @brief Caps built so far, one slot per format.
+ *
+ * The platform and its codec specific fields are fixed for the process, so the format alone
+ * identifies the caps. Slots hold one reference each; shared caps are never written to.
+ */
+static std::atomic<GstCaps*> cachedCaps[GST_FORMAT_UNKNOWN + 1];
+
+/**
+ * @brief Build the GStreamer Caps for the provided format and platform.
  *
  * @param format The format of the GStreamer stream output.
- * @param platform The platform type for which the caps are being generated.
- * @return GstCaps* A pointer to the GstCaps object describing the capabilities of the media stream.
+ * @return GstCaps* A new reference to the caps, or NULL for formats without caps.
  */
-GstCaps* GetCaps(GstStreamOutputFormat format)
+static GstCaps* BuildCaps(GstStreamOutputFormat format)
 {
 	GstCaps * caps = NULL;
-	std::shared_ptr<SocInterface> socInterface = SocInterface::CreateSocInterface();
+	static std::shared_ptr<SocInterface> socInterface = SocInterface::CreateSocInterface();
 
 	switch (format)
 	{
@@ -102,6 +110,57 @@ GstCaps* GetCaps(GstStreamOutputFormat format)
 	return caps;
 }
 
+/**
+ * @brief Get the GStreamer Caps based on the provided format and platform.
+ *
+ * Caps are built on first use and shared afterwards, so repeated calls return the same object.
+ *
+ * @param format The format of the GStreamer stream output.
+ * @return GstCaps* A reference to the caps, to be released with gst_caps_unref; NULL for formats without caps.
+ */
+GstCaps* GetCaps(GstStreamOutputFormat format)
+{
+	if (format < GST_FORMAT_INVALID || format > GST_FORMAT_UNKNOWN)
+	{
+		return BuildCaps(format);
+	}
+	std::atomic<GstCaps*> &slot = cachedCaps[format];
+	GstCaps *caps = slot.load(std::memory_order_acquire);
+	if (caps == NULL)
+	{
+		GstCaps *built = BuildCaps(format);
+		if (built == NULL)
+		{
+			return NULL;
+		}
+		if (slot.compare_exchange_strong(caps, built, std::memory_order_acq_rel))
+		{
+			caps = built;
+		}
+		else
+		{ // another thread cached the same caps first
+			gst_caps_unref(built);
+		}
+	}
+	gst_caps_ref(caps);
+	return caps;
+}
+
+/**
+ * @brief Release every cached caps object.
+ */
+void ClearCapsCache()
+{
+	for (auto &slot : cachedCaps)
+	{
+		GstCaps *caps = slot.exchange(NULL);
+		if (caps)
+		{
+			gst_caps_unref(caps);
+		}
+	}
+}
+
 /**
  * @brief Initialize the GStreamer library for the player CLI.
  * @param argc A pointer to the argument count.
@@ -118,5 +177,6 @@ void PlayerCliGstInit(int *argc, char ***argv)
  */
 void PlayerCliGstTerm()
 {
+	ClearCapsCache();
 	gst_deinit();
 }
@@ -107,11 +107,19 @@ void PlayerCliGstTerm();
  * @fn GetCaps
  * @brief Get the GStreamer capabilities for the given format and platform
  * 
+ * Caps are cached per format and shared; the caller owns one reference and must not modify them.
+ *
  * @param[in] format The stream output format
  * @return The GStreamer capabilities
  */
 GstCaps* GetCaps(GstStreamOutputFormat format);
 
+/**
+ * @fn ClearCapsCache
+ * @brief Release the caps cached by GetCaps
+ */
+void ClearCapsCache();
+
 /**
  * @fn GetCurrentTimeMS
  * @brief Get the current time in milliseconds
@@ -32,11 +32,15 @@
 #include <set>
 #include <mutex>
 #include "GstHandlerControl.h"
+#include "PlayerPositionClock.h"
 #include "gstplayertaskpool.h"
 #include <functional>
 #include <condition_variable>
 #include <chrono>
+#include <memory>
 #include <any>
+#include <deque>
+#include <thread>
 #include "SocInterface.h"
 #include "InterfacePlayerRDK.h"
 #include "GstUtils.h"
@@ -133,6 +137,417 @@ static std::map<std::string, std::vector<std::string>> gstMapDecoderLookUptable
 	{"ac-3", {"omxac3dec", "avdec_ac3", "avdec_ac3_fixed"}},
 	{"ac-4", {"omxac4dec"}}};
 
+class Mp4Demux;
+
+/**
+ * @class InjectionBufferPool
+ * @brief Size class GstBufferPools recycling the buffers injected fragments are copied into
+ *
+ * Classes grow by a factor of 4 from 16KiB to 4MiB. Each class holds at most queueBytes/classSize
+ * buffers (bounded by maxBuffers when set), so a track never keeps more than its appsrc queue worth
+ * of idle memory. Pools are created on first use and never block; callers fall back to a plain
+ * allocation when a class is exhausted or the fragment is larger than the biggest class.
+ */
+class InjectionBufferPool
+{
+public:
+	static const int kSizeClassCount = 5;
+	static const size_t kSmallestClassBytes = 16 * 1024;
+
+	InjectionBufferPool();
+	~InjectionBufferPool();
+	InjectionBufferPool(const InjectionBufferPool &) = delete;
+	InjectionBufferPool &operator=(const InjectionBufferPool &) = delete;
+
+	/**
+	 * @brief Set the per-track limits; takes effect for pools created afterwards
+	 * @param[in] queueBytes appsrc max-bytes of the track
+	 * @param[in] maxBuffers upper bound of buffers per class, 0 for no extra bound
+	 */
+	void Configure(size_t queueBytes, int maxBuffers);
+
+	/**
+	 * @brief Get a recycled buffer of exactly len bytes
+	 * @return Buffer returned to its pool on last unref, or NULL if no class fits or the class is exhausted
+	 */
+	GstBuffer *Acquire(size_t len);
+
+	/**
+	 * @brief Deactivate and drop all pools; outstanding buffers are freed when released
+	 */
+	void Reset();
+
+private:
+	GstBufferPool *CreatePool(int sizeClass);
+
+	std::atomic<GstBufferPool *> pools[kSizeClassCount];
+	std::mutex createMutex;
+	size_t queueBytes;
+	int maxBuffers;
+};
+
+/**
+ * @class InjectionStatsCounters
+ * @brief Lock free per-track injection telemetry
+ *
+ * Updated from the injection threads and appsrc signal handlers with relaxed atomics only;
+ * readers take an approximate snapshot through Snapshot().
+ */
+class InjectionStatsCounters
+{
+public:
+	InjectionStatsCounters();
+	InjectionStatsCounters(const InjectionStatsCounters &) = delete;
+	InjectionStatsCounters &operator=(const InjectionStatsCounters &) = delete;
+
+	/**
+	 * @brief Account one gst_app_src_push_buffer/_list call
+	 * @param[in] bytes payload handed over
+	 * @param[in] buffers number of buffers handed over
+	 * @param[in] startUs monotonic time the push started
+	 * @param[in] endUs monotonic time the push returned
+	 * @param[in] ok true if the push returned GST_FLOW_OK
+	 * @param[in] queuedBytes appsrc current-level-bytes after the push
+	 */
+	void RecordPush(uint64_t bytes, uint64_t buffers, gint64 startUs, gint64 endUs, bool ok, uint64_t queuedBytes);
+	void RecordNeedData() { needData.fetch_add(1, std::memory_order_relaxed); }
+	void RecordEnoughData() { enoughData.fetch_add(1, std::memory_order_relaxed); }
+	void RecordBlocked(gint64 us) { blockedUs.fetch_add((uint64_t)(us > 0 ? us : 0), std::memory_order_relaxed); }
+	void Snapshot(PlayerInjectionStats &stats) const;
+	void Reset();
+
+private:
+	std::atomic<uint64_t> bytes;
+	std::atomic<uint64_t> buffers;
+	std::atomic<uint64_t> pushCalls;
+	std::atomic<uint64_t> pushFailures;
+	std::atomic<uint64_t> latency[PlayerInjectionStats::kLatencyBuckets];
+	std::atomic<uint64_t> maxLatencyUs;
+	std::atomic<uint64_t> queuedBytes;
+	std::atomic<uint64_t> maxQueuedBytes;
+	std::atomic<uint64_t> needData;
+	std::atomic<uint64_t> enoughData;
+	std::atomic<uint64_t> blockedUs;
+	std::atomic<gint64> firstPushUs; /**< 0 until the first push */
+	std::atomic<gint64> lastPushUs;
+};
+
+/**
+ * @class AVSyncMonitor
+ * @brief A/V drift histogram, stall counters and adaptive poll rate behind MonitorAV
+ *
+ * Drift magnitudes go to log-linear buckets, exact below 8ms and with 8 sub-buckets per power of two
+ * above, separately for video ahead and video behind. MonitorAV runs on the progress timer; with
+ * backoff allowed, after kStableSamplesToBackOff polls in sync within kStableDriftMs it polls every
+ * other tick, then every fourth, and returns to every tick on the first anomaly. Counters are relaxed
+ * atomics so the API can snapshot them from any thread.
+ */
+class AVSyncMonitor
+{
+public:
+	static const int kSubBucketBits = 3;
+	static const int kSubBuckets = 1 << kSubBucketBits;
+	static const int kMaxExponent = 17;         /**< magnitudes from 2^18 ms up share the last bucket */
+	static const int kBucketCount = (kMaxExponent - kSubBucketBits + 2) * kSubBuckets;
+	static const int kMaxPollIntervalTicks = 4;
+	static const int kStableSamplesToBackOff = 4;
+	static const int kStableDriftMs = 10;
+
+	AVSyncMonitor();
+	AVSyncMonitor(const AVSyncMonitor &) = delete;
+	AVSyncMonitor &operator=(const AVSyncMonitor &) = delete;
+
+	/**
+	 * @brief Called on every progress tick
+	 * @return false if this tick is skipped while backed off
+	 */
+	bool ShouldPoll();
+
+	/**
+	 * @brief Account one poll of a PLAYING pipeline
+	 * @param[in] description MonitorAV classification of this poll
+	 * @param[in] previous classification of the previous poll, NULL for the first one
+	 * @param[in] haveDrift true if both tracks reported a position
+	 * @param[in] driftMs video minus audio position
+	 * @param[in] outOfSync true if driftMs is outside the configured thresholds
+	 * @param[in] elapsedMs time since the previous poll
+	 * @param[in] backoff true to poll less often while in sync, false to poll on every tick
+	 */
+	void RecordPoll(const char *description, const char *previous, bool haveDrift, int driftMs, bool outOfSync, long long elapsedMs, bool backoff);
+	void Snapshot(PlayerAVSyncStats &stats) const;
+	void Reset();
+
+	static int GetBucketIndex(unsigned magnitude);
+	static unsigned GetBucketMidpoint(int index);
+
+private:
+	std::atomic<uint64_t> ahead[kBucketCount];  /**< drift >= 0 */
+	std::atomic<uint64_t> behind[kBucketCount]; /**< drift < 0, by magnitude */
+	std::atomic<uint64_t> polls;
+	std::atomic<uint64_t> skippedPolls;
+	std::atomic<uint64_t> driftSamples;
+	std::atomic<uint64_t> outOfSyncSamples;
+	std::atomic<uint64_t> stalls;
+	std::atomic<uint64_t> videoFreezes;
+	std::atomic<uint64_t> audioDrops;
+	std::atomic<uint64_t> jumps;
+	std::atomic<uint64_t> stalledMs;
+	std::atomic<int> minDriftMs;
+	std::atomic<int> maxDriftMs;
+	std::atomic<int> lastDriftMs;
+	std::atomic<int> pollIntervalTicks;
+	std::atomic<int> ticksUntilPoll;
+	std::atomic<int> stableSamples;
+};
+
+/**
+ * @class TuneTimelineRecorder
+ * @brief Lock free recorder of the monotonic time each tune milestone was first reached
+ *
+ * Milestones are marked from the application, bus and streaming threads; only the first mark
+ * after Start() is kept. Marks before Start() are ignored.
+ */
+class TuneTimelineRecorder
+{
+public:
+	TuneTimelineRecorder();
+	TuneTimelineRecorder(const TuneTimelineRecorder &) = delete;
+	TuneTimelineRecorder &operator=(const TuneTimelineRecorder &) = delete;
+
+	/**
+	 * @brief Start a timeline unless one is already running
+	 */
+	void Start();
+	void Mark(PlayerTuneMilestone milestone);
+	void MarkTrack(int mediaType, PlayerTuneTrackMilestone milestone);
+	void Snapshot(PlayerTuneTimeline &timeline) const;
+	void Reset();
+
+	static const char *GetMilestoneName(PlayerTuneMilestone milestone);
+	static const char *GetTrackMilestoneName(PlayerTuneTrackMilestone milestone);
+
+private:
+	static void MarkOnce(std::atomic<gint64> &slot);
+
+	std::atomic<gint64> startUs;
+	std::atomic<gint64> milestoneUs[eTUNE_MILESTONE_COUNT];
+	std::atomic<gint64> trackMilestoneUs[PlayerTuneTimeline::kTrackCount][eTUNE_TRACK_MILESTONE_COUNT];
+};
+
+/**
+ * @class WarmPlaybinPool
+ * @brief Process wide pool of video and audio playbins built ahead of time and set to READY
+ *
+ * SetupStream claims a pooled playbin instead of creating one, which skips the factory lookup,
+ * playbin construction and the NULL->READY transition on channel change. A worker thread builds
+ * replacements after every claim. Pooled playbins have no uri and no signal handlers; the claiming
+ * player configures them exactly like a freshly created playbin.
+ */
+class WarmPlaybinPool
+{
+public:
+	static WarmPlaybinPool &GetInstance();
+
+	/**
+	 * @brief Set the number of playbins kept per track and start the refill worker
+	 * @param[in] perTrack playbins kept per track, 0 releases the pool
+	 * @param[in] videoSink optional sink factory preset as video-sink, e.g. "fakesink" for measurements
+	 * @param[in] audioSink optional sink factory preset as audio-sink
+	 */
+	void Configure(int perTrack, const char *videoSink = NULL, const char *audioSink = NULL);
+
+	/**
+	 * @brief Take a READY playbin for a track
+	 * @return Owned reference, or NULL if the track is not pooled or the pool is empty
+	 */
+	GstElement *Claim(int mediaType);
+
+	/**
+	 * @brief Number of playbins currently pooled for a track
+	 */
+	int Available(int mediaType);
+
+	/**
+	 * @brief Stop the refill worker and release all pooled playbins
+	 */
+	void Clear();
+
+private:
+	WarmPlaybinPool();
+	~WarmPlaybinPool();
+	WarmPlaybinPool(const WarmPlaybinPool &) = delete;
+	WarmPlaybinPool &operator=(const WarmPlaybinPool &) = delete;
+
+	static int GetSlot(int mediaType);
+	static GstElement *Build(int slot, const std::string &sinkFactory);
+	static void Discard(GstElement *playbin);
+	void RefillLoop();
+
+	static const int kSlotCount = 2; /**< video, audio */
+	std::mutex lifecycleMutex; /**< serialises Configure and Clear, held across the worker start and join */
+	std::mutex mutex;
+	std::condition_variable refillCond;
+	std::deque<GstElement *> playbins[kSlotCount];
+	std::string sinkFactory[kSlotCount];
+	int target;
+	unsigned generation;  /**< bumped whenever pooled playbins become stale, so in-flight builds are dropped */
+	bool stopWorker;
+	std::thread worker;
+};
+
+/**
+ * @class PlayerMainLoopThread
+ * @brief Optional per-player GMainContext with a thread running it
+ *
+ * Carries the player's bus watch and glib timers so a slow callback of one player delays neither
+ * other players nor the application's main loop. Until Start() the helpers below use the default
+ * main context, so callers need not know which one is in use. Once started, the context is kept
+ * until Stop(), so every source id the helpers return stays valid for RemoveSource().
+ */
+class PlayerMainLoopThread
+{
+public:
+	PlayerMainLoopThread();
+	~PlayerMainLoopThread();
+	PlayerMainLoopThread(const PlayerMainLoopThread &) = delete;
+	PlayerMainLoopThread &operator=(const PlayerMainLoopThread &) = delete;
+
+	/**
+	 * @brief Create the context and start dispatching it; no-op if already running
+	 */
+	void Start();
+
+	/**
+	 * @brief Quit the loop and join the thread; pending sources are destroyed without being dispatched
+	 *
+	 * The mutex is released before joining, so callbacks still running may add and remove sources
+	 * until the loop quits. Called from the loop thread itself (a callback destroying its player),
+	 * the thread is detached and exits once the callback returns.
+	 */
+	void Stop();
+
+	/**
+	 * @brief Context sources should be attached to; NULL for the default main context
+	 */
+	GMainContext *GetContext();
+
+	/**
+	 * @brief g_timeout_add_full() on GetContext()
+	 */
+	guint AddTimeout(gint priority, guint intervalMs, GSourceFunc function, gpointer data);
+
+	/**
+	 * @brief g_source_remove() on GetContext(); ignores sources that already completed
+	 */
+	void RemoveSource(guint sourceId);
+
+	/**
+	 * @brief Add a bus watch dispatched on GetContext(), removable with gst_bus_remove_watch()
+	 */
+	guint AddBusWatch(GstBus *bus, GstBusFunc function, gpointer data);
+
+private:
+	static void Run(GMainContext *context, GMainLoop *loop);
+	static gboolean QuitLoop(gpointer loop);
+
+	std::mutex mutex;
+	GMainContext *context;
+	GMainLoop *loop;
+	std::thread thread;
+};
+
+/**
+ * @class PipelineReaper
+ * @brief Process wide worker that sets outgoing pipelines to NULL and releases them off the caller's thread
+ *
+ * Stop() detaches every callback and the bus handlers before handing a pipeline over, so the reaper
+ * never calls back into a player. The next tune may start while the old pipeline is still torn down;
+ * WaitForPending() bounds that overlap for platforms that cannot allocate a decoder twice.
+ */
+class PipelineReaper
+{
+public:
+	static PipelineReaper &GetInstance();
+
+	/**
+	 * @brief Queue a detached pipeline for teardown; ownership of every reference passes to the reaper
+	 * @param[in] pipeline pipeline to set to NULL and unref
+	 * @param[in] bus pipeline bus with its watch and sync handler removed, may be NULL
+	 * @param[in] taskPool task pool of the pipeline's streaming threads, may be NULL
+	 */
+	void Reap(GstElement *pipeline, GstBus *bus, GstTaskPool *taskPool);
+
+	/**
+	 * @brief Block until at most maxPending pipelines remain to be torn down
+	 * @return true if the limit was reached within timeoutMs, false on timeout
+	 */
+	bool WaitForPending(int maxPending, int timeoutMs);
+
+	/**
+	 * @brief Number of pipelines queued or being torn down
+	 */
+	int Pending();
+
+private:
+	struct Job
+	{
+		GstElement *pipeline;
+		GstBus *bus;
+		GstTaskPool *taskPool;
+	};
+
+	PipelineReaper();
+	PipelineReaper(const PipelineReaper &) = delete;
+	PipelineReaper &operator=(const PipelineReaper &) = delete;
+
+	static void Release(const Job &job);
+	void ReapLoop();
+
+	std::mutex mutex;
+	std::condition_variable jobCond;
+	std::condition_variable doneCond;
+	std::deque<Job> jobs;
+	int pending;  /**< queued jobs plus the one in progress */
+	std::thread worker;
+};
+
+/**
+ * @enum GstElementRole
+ * @brief Roles of a pipeline element, cached on the element by GstPlayer_GetElementRoles()
+ *
+ * The bus handlers test message sources against these bits instead of matching element names
+ * through SocInterface on every message. The ELEMENT_ROLE_KEY_* bits record the player
+ * configuration the roles were derived under, so a cached tag from a different configuration
+ * is recomputed instead of trusted.
+ */
+enum GstElementRole
+{
+	ELEMENT_ROLE_VIDEO_SINK             = 1 << 0,  /**< SocInterface::IsVideoSink */
+	ELEMENT_ROLE_VIDEO_DECODER          = 1 << 1,  /**< SocInterface::IsVideoDecoder */
+	ELEMENT_ROLE_AV_DECODER             = 1 << 2,  /**< SocInterface::IsAudioOrVideoDecoder */
+	ELEMENT_ROLE_AUDIO_SINK_OR_DECODER  = 1 << 3,  /**< SocInterface::IsAudioSinkOrAudioDecoder */
+	ELEMENT_ROLE_PLAYBIN                = 1 << 4,
+	ELEMENT_ROLE_PLAYBIN_SOURCE         = 1 << 5,  /**< playbin's "source" element */
+	ELEMENT_ROLE_RIALTO_VIDEO_SINK      = 1 << 6,
+	ELEMENT_ROLE_RIALTO_AUDIO_SINK      = 1 << 7,
+	ELEMENT_ROLE_RTK_AUDIO_SINK         = 1 << 8,
+	ELEMENT_ROLE_DECRYPTOR              = 1 << 9,  /**< PlayReady, Widevine, ClearKey or Verimatrix decryptor */
+	ELEMENT_ROLE_KEY_RIALTO             = 1 << 29, /**< classified with usingRialtoSink set */
+	ELEMENT_ROLE_KEY_WESTEROS           = 1 << 30, /**< classified with using_westerossink set */
+	ELEMENT_ROLE_CLASSIFIED             = 1u << 31,
+	ELEMENT_ROLE_KEY_MASK               = ELEMENT_ROLE_KEY_RIALTO | ELEMENT_ROLE_KEY_WESTEROS | ELEMENT_ROLE_CLASSIFIED
+};
+
+/**
+ * @enum GstSourceState
+ * @brief Readiness of a stream's appsrc as seen by the injection threads
+ */
+enum GstSourceState
+{
+	eGST_SOURCE_UNCONFIGURED, /**< No source yet, or source not yet set up by playbin */
+	eGST_SOURCE_CONFIGURED,   /**< Source ready; buffers are pushed without taking sourceLock */
+	eGST_SOURCE_TEARDOWN      /**< Source being torn down by TearDownStream; pushers fall back to the locked path */
+};
 
 
 struct gst_media_stream
@@ -144,18 +559,78 @@ struct gst_media_stream
 	bool resetPosition;                       /**< To indicate that the position of the stream is reset */
 	bool bufferUnderrun;
 	bool eosReached;           /**< To indicate the status of End of Stream reached */
-	bool sourceConfigured; /**< To indicate that the current source is initialized and configured */
-	pthread_mutex_t sourceLock;
+	std::atomic<int> sourceState;   /**< GstSourceState; CONFIGURED lets SendHelper skip sourceLock */
+	std::atomic<int> activePushers; /**< Injection calls currently on the lock free path; drained before teardown */
+	std::mutex pushersMutex;        /**< Guards pushersDrained */
+	std::condition_variable pushersDrained; /**< Signalled when the last lock free pusher leaves during teardown */
+	pthread_mutex_t sourceLock;     /**< Serialises source setup and teardown against the slow injection path */
 	uint32_t timeScale;
 	int32_t trackId;                   /**< Current Audio Track Id,so far it is implemented for AC4 track selection only */
 	bool firstBufferProcessed; /**< Indicates if the first buffer is processed in this stream */
 	GstPad *demuxPad;                  /**< Demux src pad >*/
 	gulong demuxProbeId;       /**< Demux pad probe ID >*/
+	std::shared_ptr<std::atomic<int>> zeroCopyBuffersOutstanding; /**< Caller owned fragments still referenced by the pipeline; shared so release can outlive the stream */
+	InjectionBufferPool bufferPool; /**< Recycled buffers for copied fragments when useBufferPool is set */
+	InjectionStatsCounters injectionStats; /**< Push, queue and backpressure telemetry, see GetInjectionStats */
+	std::atomic<GstClockTime> queuedEndPts; /**< End of the latest buffer pushed since the last flush, GST_CLOCK_TIME_NONE if none */
+	Mp4Demux *mp4Demux;        /**< Demux context kept across fragments when useMp4Demux is set; owned, released by GstPlayerPriv/TearDownStream */
 
 	gst_media_stream() : sinkbin(NULL), source(NULL), format(GST_FORMAT_INVALID),
 	pendingSeek(false), resetPosition(false),
-	bufferUnderrun(false), eosReached(false), sourceConfigured(false), sourceLock(PTHREAD_MUTEX_INITIALIZER), timeScale(1), trackId(-1), firstBufferProcessed(false), demuxPad(NULL), demuxProbeId(0)
+	bufferUnderrun(false), eosReached(false), sourceState(eGST_SOURCE_UNCONFIGURED), activePushers(0), pushersMutex(), pushersDrained(), sourceLock(PTHREAD_MUTEX_INITIALIZER), timeScale(1), trackId(-1), firstBufferProcessed(false), demuxPad(NULL), demuxProbeId(0),
+	zeroCopyBuffersOutstanding(std::make_shared<std::atomic<int>>(0)), bufferPool(), injectionStats(), queuedEndPts(GST_CLOCK_TIME_NONE), mp4Demux(NULL)
+	{
+	}
+
+	/**
+	 * @brief true once the source is set up and until teardown starts
+	 */
+	bool IsSourceConfigured() const
+	{
+		return sourceState.load(std::memory_order_acquire) == eGST_SOURCE_CONFIGURED;
+	}
+
+	/**
+	 * @brief Enter the lock free injection path if the source is configured
+	 * @return true if the caller may push without sourceLock and must call LeaveConfiguredSource after;
+	 *         false if the caller has to take the locked path
+	 * @note Pairs with DrainPushers, which writes the state before reading activePushers; both sides
+	 *       are seq_cst so a pusher either sees TEARDOWN or is counted by the drain
+	 */
+	bool EnterConfiguredSource()
+	{
+		activePushers.fetch_add(1, std::memory_order_seq_cst);
+		if (sourceState.load(std::memory_order_seq_cst) == eGST_SOURCE_CONFIGURED)
+		{
+			return true;
+		}
+		LeaveConfiguredSource();
+		return false;
+	}
+
+	/**
+	 * @brief Leave the lock free injection path; the last pusher out wakes a waiting DrainPushers
+	 */
+	void LeaveConfiguredSource()
+	{
+		if (activePushers.fetch_sub(1, std::memory_order_seq_cst) == 1 &&
+			sourceState.load(std::memory_order_seq_cst) != eGST_SOURCE_CONFIGURED)
+		{
+			std::lock_guard<std::mutex> lock(pushersMutex);
+			pushersDrained.notify_all();
+		}
+	}
+
+	/**
+	 * @brief Move the source to TEARDOWN and wait for lock free pushers to leave
+	 * @return false if pushers were still active after timeoutMs; the state stays TEARDOWN either way
+	 */
+	bool DrainPushers(int timeoutMs)
 	{
+		sourceState.store(eGST_SOURCE_TEARDOWN, std::memory_order_seq_cst);
+		std::unique_lock<std::mutex> lock(pushersMutex);
+		return pushersDrained.wait_for(lock, std::chrono::milliseconds(timeoutMs), [this]()
+				{ return activePushers.load(std::memory_order_seq_cst) == 0; });
 	}
 
 	~gst_media_stream()
@@ -180,6 +655,8 @@ struct GstPlayerPriv
 
 	gst_media_stream stream[GST_TRACK_COUNT];
 	MonitorAVState monitorAVstate;
+	AVSyncMonitor avSyncMonitor; /**< Drift histogram and stall counters, see GetAVSyncStats */
+	PlayerMainLoopThread mainLoopThread; /**< Own bus and timer context when dedicatedMainContext is set */
 	GstElement *pipeline; /**< GstPipeline used for playback. */
 	GstBus *bus;              /**< Bus for receiving GstEvents from pipeline. */
 	guint64 total_bytes;
@@ -267,6 +744,8 @@ struct GstPlayerPriv
 
 	bool filterAudioDemuxBuffers; /**< flag to filter audio demux buffers */
 	double seekPosition;              /**< the position to seek the pipeline to in seconds */
+	TuneTimelineRecorder tuneTimeline; /**< Tune milestones, see GetTuneTimeline */
+	PlayerPositionClock positionClock; /**< Last sampled position, extrapolated by GetPositionMilliseconds */
 	GstPlayerPriv();
 	~GstPlayerPriv();
 };
@@ -320,6 +799,8 @@ class InterfacePlayerPriv
 		/**
 		 * @fn ForwardBuffersToAuxPipeline
 		 *
+		 * With Configs::shareAuxAudioBuffers the aux appsrc gets an extra reference to buffer,
+		 * otherwise a copy; buffer itself stays owned by the caller either way.
 		 * @param[in] buffer - input buffer to be forwarded
 		 */
 		void ForwardBuffersToAuxPipeline(GstBuffer *buffer, bool pauseInjector, void *user_data);
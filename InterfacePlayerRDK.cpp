@@ -28,6 +28,7 @@
 #include <sys/time.h>
 #include "PlayerExternalsInterface.h"						//ToDo: Replace once outputprotection moved to middleware
 #include <inttypes.h>
+#include <sched.h>
 #include "TextStyleAttributes.h"
 #include <memory>
 #include <gst/gst.h>
@@ -35,12 +36,15 @@
 #include "player-xternal-stats.h"
 #endif
 #include "PlayerUtils.h"
+#include "PlayerJsonObject.h"
 
 #define DEFAULT_BUFFERING_TO_MS 10                       /**< TimeOut interval to check buffer fullness */
 #define DEFAULT_BUFFERING_MAX_MS (1000)                  /**< max buffering time */
 #define DEFAULT_BUFFERING_MAX_CNT (DEFAULT_BUFFERING_MAX_MS/DEFAULT_BUFFERING_TO_MS)   /**< max buffering timeout count */
 #define NORMAL_PLAY_RATE 1
 #define DEFAULT_TIMEOUT_FOR_SOURCE_SETUP (1000)          /**< Default timeout value in milliseconds */
+#define SOURCE_DRAIN_TIMEOUT_MS (200)                    /**< Wait in milliseconds for lock free pushers before a source being torn down is flushed, then between progress logs */
+#define PIPELINE_REAPER_WAIT_TIMEOUT_MS (2000)           /**< Max wait in milliseconds for outgoing pipelines before a new one leaves READY */
 #define DEFAULT_AVSYNC_FREERUN_THRESHOLD_SECS 12         /**< Currently MAX FRAG DURATION + 2*/
 #define INVALID_RATE -9999
 
@@ -84,7 +88,14 @@ mSourceSetupCV(), mScheduler(), callbackMap(), setupStreamCallbackMap(), mDrmSys
 /* InterfacePlayerRDK destructor*/
 InterfacePlayerRDK::~InterfacePlayerRDK()
 {
+	// no bus message or timer may reach this instance, or the pipeline it is about to release, once its context stops
+	interfacePlayerPriv->gstPrivateContext->aSyncControl.disable();
+	interfacePlayerPriv->gstPrivateContext->aSyncControl.waitForDone(100, "bus_message");
+	RemoveMainLoopTimers();
+	interfacePlayerPriv->gstPrivateContext->mainLoopThread.Stop();
 	DestroyPipeline();
+	// parked streaming threads stay only as long as some player still asks for them
+	gst_player_taskpool_set_max_idle_threads(this, 0);
 	if (mDrmSystem)
 	{
 		delete[] mDrmSystem;
@@ -162,6 +173,7 @@ GstPlayerPriv::~GstPlayerPriv()
 	for (int i = 0; i < GST_TRACK_COUNT; i++)
 	{
 		g_clear_object(&protectionEvent[i]);
+		MW_SAFE_DELETE(stream[i].mp4Demux);
 	}
 	g_clear_object(&positionQuery);
 	g_clear_object(&durationQuery);
@@ -175,6 +187,14 @@ GstPlayerPriv::~GstPlayerPriv()
  */
 static GstFlowReturn InterfacePlayerRDK_OnVideoSample(GstElement *object, void *_this);
 
+/**
+ * @brief Push a buffer into the stream's appsrc and account it in the track telemetry
+ * @param[in] stream stream whose source receives the buffer
+ * @param[in] buffer buffer to push; ownership passes to the appsrc
+ * @return The flow return status.
+ */
+static GstFlowReturn PushBufferWithStats(gst_media_stream *stream, GstBuffer *buffer);
+
 InterfacePlayerPriv* InterfacePlayerRDK::GetPrivatePlayer()
 {
 	return interfacePlayerPriv;
@@ -258,6 +278,7 @@ void InterfacePlayerRDK::ConfigurePipeline(int format, int audioFormat, int auxF
 										   bool isSubEnable, int32_t trackId, gint rate, const char *pipelineName, int PipelinePriority, bool FirstFrameFlag, std::string manifestUrl)
 {
 	mFirstFrameRequired = FirstFrameFlag;
+	interfacePlayerPriv->gstPrivateContext->tuneTimeline.Start();
 	GstStreamOutputFormat gstFormat 	= static_cast<GstStreamOutputFormat>(format);
 	GstStreamOutputFormat gstAudioFormat 	= static_cast<GstStreamOutputFormat>(audioFormat);
 	GstStreamOutputFormat gstAuxFormat 	= static_cast<GstStreamOutputFormat>(auxFormat);
@@ -405,6 +426,8 @@ void InterfacePlayerRDK::ConfigurePipeline(int format, int audioFormat, int auxF
 		}
 	}
 #endif
+	int setupTracks[GST_TRACK_COUNT];
+	int setupCount = 0;
 	for (int i = 0; i < GST_TRACK_COUNT; i++)
 	{
 		gst_media_stream *stream = &interfacePlayerPriv->gstPrivateContext->stream[i];
@@ -417,19 +440,57 @@ void InterfacePlayerRDK::ConfigurePipeline(int format, int audioFormat, int auxF
 			TearDownStream((int)i);
 			stream->format = newFormat[i];
 			stream->trackId = trackId;
+			setupTracks[setupCount++] = i;
+		}
+	}
 
-			/* Sets up the stream for the given MediaType */
-			if(0 != InterfacePlayer_SetupStream((GstMediaType)i, manifestUrl))
+	/* Sets up the streams for the selected MediaTypes; the pipeline state is only changed once all of them are done */
+	int setupResult[GST_TRACK_COUNT] = {};
+	if (m_gstConfigParam->parallelStreamSetup && setupCount > 1)
+	{
+		SetupStreamsConcurrently(setupTracks, setupCount, manifestUrl, setupResult);
+	}
+	else
+	{
+		for (int n = 0; n < setupCount; n++)
+		{
+			setupResult[n] = InterfacePlayer_SetupStream(setupTracks[n], manifestUrl);
+			if (setupResult[n] != 0 && eGST_MEDIATYPE_SUBTITLE != (GstMediaType)setupTracks[n])
 			{
-				MW_LOG_ERR("InterfacePlayerRDK: track %d failed", i);
-				//Don't kill the tune for subtitles
-				if (eGST_MEDIATYPE_SUBTITLE != (GstMediaType)i)
-				{
-					return;
-				}
+				break;
 			}
-
-
+		}
+	}
+	for (int n = 0; n < setupCount; n++)
+	{
+		if (0 != setupResult[n])
+		{
+			MW_LOG_ERR("InterfacePlayerRDK: track %d failed", setupTracks[n]);
+			//Don't kill the tune for subtitles
+			if (eGST_MEDIATYPE_SUBTITLE != (GstMediaType)setupTracks[n])
+			{
+				return;
+			}
+		}
+	}
+	if (m_gstConfigParam->asyncPipelineTeardown)
+	{
+		/* Decoders are allocated once the pipeline leaves READY; bound the overlap with pipelines still being reaped */
+		int maxPending = (m_gstConfigParam->asyncTeardownMaxPending > 0) ? m_gstConfigParam->asyncTeardownMaxPending : 0;
+		if (!PipelineReaper::GetInstance().WaitForPending(maxPending, PIPELINE_REAPER_WAIT_TIMEOUT_MS))
+		{ // going on would allocate decoders the outgoing pipelines still hold; fail the tune instead
+			MW_LOG_ERR("InterfacePlayerRDK: %d outgoing pipeline(s) still tearing down after %d ms", PipelineReaper::GetInstance().Pending(), PIPELINE_REAPER_WAIT_TIMEOUT_MS);
+			if (busMessageCallback)
+			{
+				BusEventData busEvent;
+				busEvent.msgType = MESSAGE_ERROR;
+				busEvent.msg = "Outgoing pipeline teardown timed out";
+				busEvent.setPlaybackRate = false;
+				busEvent.firstBufferProcessed = false;
+				busEvent.receivedFirstFrame = false;
+				busMessageCallback(busEvent);
+			}
+			return;
 		}
 	}
 	if ((interfacePlayerPriv->gstPrivateContext->usingRialtoSink) && (m_gstConfigParam->media != eGST_MEDIAFORMAT_PROGRESSIVE))
@@ -619,6 +680,11 @@ void MonitorAV( InterfacePlayerRDK *pInterfacePlayerRDK )
 	InterfacePlayerPriv* privatePlayer = pInterfacePlayerRDK->GetPrivatePlayer();
 	GstClockTime timeout = 0;
 	gint64 av_position[2] = {0,0};
+	AVSyncMonitor &avSyncMonitor = privatePlayer->gstPrivateContext->avSyncMonitor;
+	if( !avSyncMonitor.ShouldPoll() )
+	{ // backed off while A/V is steadily in sync
+		return;
+	}
 	gint rc = gst_element_get_state(privatePlayer->gstPrivateContext->pipeline, &state, &pending, timeout );
 	if( rc == GST_STATE_CHANGE_SUCCESS )
 	{
@@ -629,6 +695,8 @@ void MonitorAV( InterfacePlayerRDK *pInterfacePlayerRDK )
 			int numTracks = 0;
 			bool bigJump = false;
 			long long tNow = GetCurrentTimeMS();
+			long long elapsedMs = monitorAVState->tLastSampled ? (tNow - monitorAVState->tLastSampled) : 0;
+			bool outOfSync = false;
 			if( !monitorAVState->tLastReported )
 			{
 				monitorAVState->tLastReported = tNow;
@@ -683,6 +751,7 @@ void MonitorAV( InterfacePlayerRDK *pInterfacePlayerRDK )
 					int delta = (int)(av_position[eGST_MEDIATYPE_VIDEO] - av_position[eGST_MEDIATYPE_AUDIO]);
 					if( delta > AVSYNC_POSITIVE_THRESHOLD_MS  || delta < AVSYNC_NEGATIVE_THRESHOLD_MS )
 					{
+						outOfSync = true;
 						if( !description )
 						{ // both moving, but diverged
 							description = "avsync";
@@ -701,6 +770,9 @@ void MonitorAV( InterfacePlayerRDK *pInterfacePlayerRDK )
 			{ // fill in OK if nothing flagged
 				description = "ok";
 			}
+			avSyncMonitor.RecordPoll( description, monitorAVState->description, (numTracks == 2),
+									 (int)(av_position[eGST_MEDIATYPE_VIDEO] - av_position[eGST_MEDIATYPE_AUDIO]), outOfSync, elapsedMs,
+									 pInterfacePlayerRDK->m_gstConfigParam->monitorAvBackoff );
 			if( monitorAVState->description!=description )
 			{ // log only when interpretation of AV state has changed
 				if( monitorAVState->description )
@@ -800,6 +872,7 @@ gboolean InterfacePlayerRDK::IdleCallbackFirstVideoFrameDisplayed(gpointer user_
 }
 
 bool gst_StartsWith( const char *inputStr, const char *prefix );
+guint GstPlayer_GetElementRoles(GstObject *object, InterfacePlayerRDK *pInterfacePlayerRDK);
 /**
  *@brief set the encrypted content, should be used by playready plugin
  */
@@ -902,6 +975,8 @@ void InterfacePlayerRDK::SetSeekPosition(double positionSecs)
 	for (int i = 0; i < GST_TRACK_COUNT; i++)
 	{
 		interfacePlayerPriv->gstPrivateContext->stream[i].pendingSeek = true;
+		// queued data is about to be flushed
+		interfacePlayerPriv->gstPrivateContext->stream[i].queuedEndPts.store(GST_CLOCK_TIME_NONE);
 	}
 }
 
@@ -999,7 +1074,7 @@ void InterfacePlayerRDK::TimerRemove(guint& taskId, const char* timerName)
 	if ( 0 != taskId )
 	{
 		MW_LOG_INFO("InterfacePlayerRDK: Remove timer '%.50s', %d", (nullptr!=timerName) ? timerName : "unknown", taskId);
-		g_source_remove(taskId);                                        /* Removes the source as per the taskId */
+		interfacePlayerPriv->gstPrivateContext->mainLoopThread.RemoveSource(taskId);   /* Removes the source as per the taskId */
 		taskId = 0;
 	}
 	else
@@ -1007,6 +1082,16 @@ void InterfacePlayerRDK::TimerRemove(guint& taskId, const char* timerName)
 		MW_LOG_TRACE("Interface Timer '%.50s' with taskId = %d already removed.", (nullptr!=timerName) ? timerName : "unknown", taskId);
 	}
 }
+
+/**
+ * @brief Remove the progress, buffering timeout and EOS check timers this player runs on its main loop
+ */
+void InterfacePlayerRDK::RemoveMainLoopTimers()
+{
+	TimerRemove(interfacePlayerPriv->gstPrivateContext->periodicProgressCallbackIdleTaskId, "periodicProgressCallbackIdleTaskId");
+	TimerRemove(interfacePlayerPriv->gstPrivateContext->bufferingTimeoutTimerId, "bufferingTimeoutTimerId");
+	TimerRemove(interfacePlayerPriv->gstPrivateContext->ptsCheckForEosOnUnderflowIdleTaskId, "ptsCheckForEosOnUnderflowIdleTaskId");
+}
 /**
  * @fn RemoveProbes
  * @brief Remove probes from the pipeline
@@ -1037,6 +1122,26 @@ void InterfacePlayerRDK::RemoveProbe(int type)
 	}
 }
 
+/**
+ *  @brief Detach the pipeline and hand it to the reaper thread, which sets it to NULL and releases it
+ */
+void InterfacePlayerRDK::ReapPipeline()
+{
+	GstPlayerPriv *privateContext = interfacePlayerPriv->gstPrivateContext;
+	MW_LOG_MIL("Interface handing gstreamer pipeline %s to reaper", GST_ELEMENT_NAME(privateContext->pipeline));
+	if (privateContext->bus)
+	{
+		/* The bus watch is removed by Stop; the sync handler would still call into this player */
+		gst_bus_set_sync_handler(privateContext->bus, NULL, NULL, NULL);
+	}
+	PipelineReaper::GetInstance().Reap(privateContext->pipeline, privateContext->bus, privateContext->task_pool);
+	privateContext->pipeline = NULL;
+	privateContext->bus = NULL;
+	privateContext->task_pool = NULL;
+	//video decoder handle will change with new pipeline
+	privateContext->decoderHandleNotified = false;
+}
+
 /**
  *  @brief Cleanup an existing Gstreamer pipeline and associated resources
  */
@@ -1230,6 +1335,20 @@ static void LogStatus(GstElement* pElementOrBin)
 	MW_LOG_MIL("InterfacePlayerRDK: %s Status: %s",SafeName(pElementOrBin).c_str(), GetStatus(pElementOrBin, recursionCount).c_str());
 }
 
+/**
+ *  @brief Leave the injection path entered through gst_media_stream::EnterConfiguredSource or sourceLock
+ */
+static void LeaveSource(gst_media_stream *stream, bool fastPath)
+{
+	if (fastPath)
+	{
+		stream->LeaveConfiguredSource();
+	}
+	else
+	{
+		pthread_mutex_unlock(&stream->sourceLock);
+	}
+}
 
 /**
  * @brief wraps gst_element_set_state and adds log messages where applicable
@@ -1308,6 +1427,12 @@ void InterfacePlayerRDK::TearDownStream(int type)
 
 	if (stream->format != GST_FORMAT_INVALID)
 	{
+		// new pushers take the locked path from here; the ones already pushing leave within a push
+		bool drained = stream->DrainPushers(SOURCE_DRAIN_TIMEOUT_MS);
+		if (!drained)
+		{
+			MW_LOG_WARN("InterfacePlayerRDK::TearDownStream: mediaType[%d] pushers still active, flushing source first", type);
+		}
 		pthread_mutex_lock(&stream->sourceLock);
 		if (interfacePlayerPriv->gstPrivateContext->pipeline)
 		{
@@ -1334,11 +1459,30 @@ void InterfacePlayerRDK::TearDownStream(int type)
 		{
 			interfacePlayerPriv->gstPrivateContext->decoderHandleNotified = false;
 		}
+		// the NULL state change above fails any push still in progress; a pusher still reads source,
+		// mp4Demux, bufferPool and injectionStats after its push, so none of them is released before it leaves
+		while (!drained)
+		{
+			drained = stream->DrainPushers(SOURCE_DRAIN_TIMEOUT_MS);
+			if (!drained)
+			{
+				MW_LOG_ERR("InterfacePlayerRDK::TearDownStream: mediaType[%d] %d pushers still active, waiting", type, stream->activePushers.load());
+			}
+		}
 		stream->format = GST_FORMAT_INVALID;
 		g_clear_object(&stream->sinkbin);
 		g_clear_object(&stream->source);
-		stream->sourceConfigured = false;
+		stream->sourceState.store(eGST_SOURCE_UNCONFIGURED);
+		MW_SAFE_DELETE(stream->mp4Demux);
+		stream->bufferPool.Reset();
+		stream->injectionStats.Reset();
+		stream->queuedEndPts.store(GST_CLOCK_TIME_NONE);
 		pthread_mutex_unlock(&stream->sourceLock);
+		int outstanding = stream->zeroCopyBuffersOutstanding->load();
+		if (outstanding)
+		{
+			MW_LOG_WARN("InterfacePlayerRDK::TearDownStream: %d caller owned fragment(s) still referenced for mediaType = %d, released on last unref", outstanding, mediaType);
+		}
 	}
 	if (mediaType == eGST_MEDIATYPE_VIDEO)
 	{
@@ -1379,21 +1523,12 @@ void InterfacePlayerRDK::Stop(bool keepLastFrame)
 		interfacePlayerPriv->gstPrivateContext->firstVideoFrameReceived = false;
 		interfacePlayerPriv->gstPrivateContext->firstAudioFrameReceived = false ;
 	}
+	interfacePlayerPriv->gstPrivateContext->tuneTimeline.Reset();
+	interfacePlayerPriv->gstPrivateContext->avSyncMonitor.Reset();
+	interfacePlayerPriv->gstPrivateContext->positionClock.Invalidate();
 	IdleTaskRemove(interfacePlayerPriv->gstPrivateContext->firstProgressCallbackIdleTask);
 
-	this->TimerRemove(interfacePlayerPriv->gstPrivateContext->periodicProgressCallbackIdleTaskId, "periodicProgressCallbackIdleTaskId");
-	if (interfacePlayerPriv->gstPrivateContext->bufferingTimeoutTimerId)
-	{
-		MW_LOG_MIL("InterfacePlayerRDK: Remove bufferingTimeoutTimerId %d", interfacePlayerPriv->gstPrivateContext->bufferingTimeoutTimerId);
-		g_source_remove(interfacePlayerPriv->gstPrivateContext->bufferingTimeoutTimerId);
-		interfacePlayerPriv->gstPrivateContext->bufferingTimeoutTimerId = PLAYER_TASK_ID_INVALID;
-	}
-	if (interfacePlayerPriv->gstPrivateContext->ptsCheckForEosOnUnderflowIdleTaskId)
-	{
-		MW_LOG_MIL("InterfacePlayerRDK: Remove ptsCheckForEosCallbackIdleTaskId %d",interfacePlayerPriv->gstPrivateContext->ptsCheckForEosOnUnderflowIdleTaskId);
-		g_source_remove(interfacePlayerPriv->gstPrivateContext->ptsCheckForEosOnUnderflowIdleTaskId);
-		interfacePlayerPriv->gstPrivateContext->ptsCheckForEosOnUnderflowIdleTaskId = PLAYER_TASK_ID_INVALID;
-	}
+	RemoveMainLoopTimers();
 	if (interfacePlayerPriv->gstPrivateContext->eosCallbackIdleTaskPending)
 	{
 		MW_LOG_MIL("InterfacePlayerRDK: Remove eosCallbackIdleTaskId %d",interfacePlayerPriv->gstPrivateContext->eosCallbackIdleTaskId);
@@ -1425,6 +1560,7 @@ void InterfacePlayerRDK::Stop(bool keepLastFrame)
 	// Remove probes before setting the pipeline to NULL
 	RemoveProbes();
 
+	bool reapPipeline = false;
 	if (interfacePlayerPriv->gstPrivateContext->pipeline)
 	{
 		const auto EOSMode = m_gstConfigParam->eosInjectionMode;
@@ -1435,14 +1571,41 @@ void InterfacePlayerRDK::Stop(bool keepLastFrame)
 		}
 
 		interfacePlayerPriv->gstPrivateContext->buffering_in_progress = false;   /* stopping pipeline, don't want to change state if GST_MESSAGE_ASYNC_DONE message comes in */
-		SetStateWithWarnings(interfacePlayerPriv->gstPrivateContext->pipeline, GST_STATE_NULL);
-		MW_LOG_MIL(" InterfacePlayerRDK: Pipeline state set to null");
+		if (m_gstConfigParam->asyncPipelineTeardown)
+		{
+			reapPipeline = true;
+		}
+		else
+		{
+			SetStateWithWarnings(interfacePlayerPriv->gstPrivateContext->pipeline, GST_STATE_NULL);
+			MW_LOG_MIL(" InterfacePlayerRDK: Pipeline state set to null");
+		}
 	}
 	if(PlayerExternalsInterface::IsPlayerExternalsInterfaceInstanceActive())
 	{
 		std::shared_ptr<PlayerExternalsInterface> pInstance = PlayerExternalsInterface::GetPlayerExternalsInterfaceInstance();
 		pInstance->setGstElement((GstElement *)(NULL));
 	}
+	if (reapPipeline)
+	{
+		/* Streams are torn down below without a pipeline, so TearDownStream can no longer fail a stuck
+		 * push by setting the sinkbin to NULL; drain every source while the pipeline is still ours */
+		for (int i = 0; i < GST_TRACK_COUNT; i++)
+		{
+			gst_media_stream *stream = &interfacePlayerPriv->gstPrivateContext->stream[i];
+			if (stream->format != GST_FORMAT_INVALID && !stream->DrainPushers(SOURCE_DRAIN_TIMEOUT_MS))
+			{
+				MW_LOG_WARN("InterfacePlayerRDK::Stop: mediaType[%d] pushers still active, flushing source before reaping the pipeline", i);
+				if (stream->sinkbin)
+				{
+					SetStateWithWarnings(GST_ELEMENT(stream->sinkbin), GST_STATE_NULL);
+				}
+			}
+		}
+		/* Otherwise the sinkbins are only released by TearDownStream and reach NULL together with the
+		 * pipeline on the reaper thread */
+		ReapPipeline();
+	}
 	for(int i = 0; i<GST_TRACK_COUNT;i++)
 	{
 		TearDownStream((int(i)));
@@ -1524,19 +1687,89 @@ bool InterfacePlayerRDK::IsUsingRialtoSink()
 }
 
 /**
- *  @brief Flush cached GstBuffers and set seek position & rate
+ *  @brief Convert seconds to a clock time, as done for the double based SendHelper variants
  */
-bool InterfacePlayerRDK::Flush(double position, int rate, bool shouldTearDown, bool isAppSeek)
+static inline GstClockTime SecondsToClockTime(double seconds)
 {
-	GstState aud_current;
-	GstState aud_pending;
-	GstState current;
-	GstState pending;
+	return (seconds > 0) ? (GstClockTime)(seconds * GST_SECOND) : 0;
+}
 
-	gst_media_stream *stream = &interfacePlayerPriv->gstPrivateContext->stream[eGST_MEDIATYPE_VIDEO];
-	interfacePlayerPriv->gstPrivateContext->rate = rate;
-	interfacePlayerPriv->gstPrivateContext->stream[eGST_MEDIATYPE_VIDEO].bufferUnderrun = false;
-	interfacePlayerPriv->gstPrivateContext->stream[eGST_MEDIATYPE_AUDIO].bufferUnderrun = false;
+/**
+ * @brief Minimum queued data left after an in-buffer seek target
+ */
+#define IN_BUFFER_SEEK_MARGIN (500 * GST_MSECOND)
+
+/**
+ *  @brief Skip forward to a position already queued on every track using a flushing step event
+ *
+ *  The sinks drop the data up to the target and adjust their running time, so nothing queued
+ *  after the target is discarded and no new segment or preroll is needed.
+ */
+bool InterfacePlayerRDK::SeekWithinQueuedData(double position)
+{
+	GstPlayerPriv *privateContext = interfacePlayerPriv->gstPrivateContext;
+	if (privateContext->pipeline == NULL || privateContext->rate != GST_NORMAL_PLAY_RATE || m_gstConfigParam->enablePTSReStamp ||
+		eGST_MEDIAFORMAT_PROGRESSIVE == static_cast<GstMediaFormat>(m_gstConfigParam->media))
+	{ // queued timestamps are only comparable with the position when not restamped
+		return false;
+	}
+	GstState current = GST_STATE_VOID_PENDING;
+	GstState pending = GST_STATE_VOID_PENDING;
+	if (gst_element_get_state(privateContext->pipeline, &current, &pending, 0) != GST_STATE_CHANGE_SUCCESS ||
+		(current != GST_STATE_PLAYING && current != GST_STATE_PAUSED))
+	{
+		return false;
+	}
+	gint64 positionNs = 0;
+	if (!gst_element_query_position(privateContext->pipeline, GST_FORMAT_TIME, &positionNs) || positionNs < 0)
+	{
+		return false;
+	}
+	// same conversion as the buffer PTS recorded in queuedEndPts
+	GstClockTime target = SecondsToClockTime(position);
+	if (target <= (GstClockTime)positionNs)
+	{ // backward seeks need the flushed data back
+		return false;
+	}
+	bool anyTrack = false;
+	for (int i = 0; i < GST_TRACK_COUNT; i++)
+	{
+		const gst_media_stream *stream = &privateContext->stream[i];
+		if (i == eGST_MEDIATYPE_SUBTITLE || stream->format == GST_FORMAT_INVALID)
+		{
+			continue;
+		}
+		GstClockTime queuedEnd = stream->queuedEndPts.load();
+		if (queuedEnd == GST_CLOCK_TIME_NONE || target + IN_BUFFER_SEEK_MARGIN > queuedEnd)
+		{
+			MW_LOG_INFO("mediaType %d target %" GST_TIME_FORMAT " beyond queued end %" GST_TIME_FORMAT, i, GST_TIME_ARGS(target), GST_TIME_ARGS(queuedEnd));
+			return false;
+		}
+		anyTrack = true;
+	}
+	if (!anyTrack)
+	{
+		return false;
+	}
+	guint64 amount = target - (GstClockTime)positionNs;
+	GstEvent *step = gst_event_new_step(GST_FORMAT_TIME, amount, 1.0, TRUE, FALSE);
+	if (!step || !gst_element_send_event(privateContext->pipeline, step))
+	{
+		MW_LOG_WARN("Step of %" GST_TIME_FORMAT " rejected, caller has to flush", GST_TIME_ARGS(amount));
+		return false;
+	}
+	MW_LOG_MIL("In-buffer seek from %" GST_TIME_FORMAT " to %" GST_TIME_FORMAT " without flush", GST_TIME_ARGS(positionNs), GST_TIME_ARGS(target));
+	privateContext->positionClock.Invalidate();
+	privateContext->eosSignalled = false;
+	RemovePendingSeekCallbacks();
+	return true;
+}
+
+/**
+ *  @brief Remove the EOS and buffering timeout callbacks scheduled for the playback position before a seek
+ */
+void InterfacePlayerRDK::RemovePendingSeekCallbacks()
+{
 	if (interfacePlayerPriv->gstPrivateContext->eosCallbackIdleTaskPending)
 	{
 		MW_LOG_MIL("InterfacePlayerRDK: Remove eosCallbackIdleTaskId %d", interfacePlayerPriv->gstPrivateContext->eosCallbackIdleTaskId);
@@ -1548,17 +1781,35 @@ bool InterfacePlayerRDK::Flush(double position, int rate, bool shouldTearDown, b
 	if (interfacePlayerPriv->gstPrivateContext->ptsCheckForEosOnUnderflowIdleTaskId)
 	{
 		MW_LOG_MIL("InterfacePlayerRDK: Remove ptsCheckForEosCallbackIdleTaskId %d", interfacePlayerPriv->gstPrivateContext->ptsCheckForEosOnUnderflowIdleTaskId);
-		g_source_remove(interfacePlayerPriv->gstPrivateContext->ptsCheckForEosOnUnderflowIdleTaskId);
+		interfacePlayerPriv->gstPrivateContext->mainLoopThread.RemoveSource(interfacePlayerPriv->gstPrivateContext->ptsCheckForEosOnUnderflowIdleTaskId);
 		interfacePlayerPriv->gstPrivateContext->ptsCheckForEosOnUnderflowIdleTaskId = PLAYER_TASK_ID_INVALID;
 
 	}
 	if (interfacePlayerPriv->gstPrivateContext->bufferingTimeoutTimerId)
 	{
 		MW_LOG_MIL("InterfacePlayerRDK: Remove bufferingTimeoutTimerId %d", interfacePlayerPriv->gstPrivateContext->bufferingTimeoutTimerId);
-		g_source_remove(interfacePlayerPriv->gstPrivateContext->bufferingTimeoutTimerId);
+		interfacePlayerPriv->gstPrivateContext->mainLoopThread.RemoveSource(interfacePlayerPriv->gstPrivateContext->bufferingTimeoutTimerId);
 		interfacePlayerPriv->gstPrivateContext->bufferingTimeoutTimerId = PLAYER_TASK_ID_INVALID;
 
 	}
+}
+
+/**
+ *  @brief Flush cached GstBuffers and set seek position & rate
+ */
+bool InterfacePlayerRDK::Flush(double position, int rate, bool shouldTearDown, bool isAppSeek)
+{
+	GstState aud_current;
+	GstState aud_pending;
+	GstState current;
+	GstState pending;
+
+	gst_media_stream *stream = &interfacePlayerPriv->gstPrivateContext->stream[eGST_MEDIATYPE_VIDEO];
+	interfacePlayerPriv->gstPrivateContext->positionClock.Invalidate();
+	interfacePlayerPriv->gstPrivateContext->rate = rate;
+	interfacePlayerPriv->gstPrivateContext->stream[eGST_MEDIATYPE_VIDEO].bufferUnderrun = false;
+	interfacePlayerPriv->gstPrivateContext->stream[eGST_MEDIATYPE_AUDIO].bufferUnderrun = false;
+	RemovePendingSeekCallbacks();
 
 	// If the pipeline is not setup, we will cache the value for later
 	SetSeekPosition(position);
@@ -1733,6 +1984,7 @@ static void gst_need_data(void *source, guint size, void *_this)
 		struct gst_media_stream *stream = &privatePlayer->gstPrivateContext->stream[mediaType];
 		if(stream)
 		{
+			stream->injectionStats.RecordNeedData();
 			int media = static_cast<int>(mediaType);
 			pInterfacePlayerRDK->NeedDataCb(media);
 		}
@@ -1757,6 +2009,7 @@ static void gst_enough_data(GstElement *source, void *_this)
 				struct gst_media_stream *stream = &privatePlayer->gstPrivateContext->stream[mediaType];
 				if(stream)
 				{
+					stream->injectionStats.RecordEnoughData();
 					int media = static_cast<int>(mediaType);
 					pInterfacePlayerRDK->EnoughDataCb(media);
 				}
@@ -1788,6 +2041,7 @@ void InterfacePlayerRDK::InitializeSourceForPlayer(void *PlayerInstance, void *
 		int MaxGstVideoBufBytes = m_gstConfigParam->videoBufBytes;
 		MW_LOG_INFO("Setting gst Video buffer max bytes to %d", MaxGstVideoBufBytes);
 		g_object_set(source, "max-bytes", (guint64)MaxGstVideoBufBytes, NULL);			/* Sets the maximum video buffer bytes as per configuration*/
+		stream->bufferPool.Configure((size_t)MaxGstVideoBufBytes, m_gstConfigParam->bufferPoolMaxBuffers);
 	}
 	else if (eGST_MEDIATYPE_AUDIO == mediaType || eGST_MEDIATYPE_AUX_AUDIO == mediaType)
 	{
@@ -1795,6 +2049,14 @@ void InterfacePlayerRDK::InitializeSourceForPlayer(void *PlayerInstance, void *
 		int MaxGstAudioBufBytes = m_gstConfigParam->audioBufBytes;
 		MW_LOG_INFO("Setting gst Audio buffer max bytes to %d", MaxGstAudioBufBytes);
 		g_object_set(source, "max-bytes", (guint64)MaxGstAudioBufBytes, NULL);			/* Sets the maximum audio buffer bytes as per configuration*/
+		stream->bufferPool.Configure((size_t)MaxGstAudioBufBytes, m_gstConfigParam->bufferPoolMaxBuffers);
+		if (eGST_MEDIATYPE_AUX_AUDIO == mediaType && m_gstConfigParam->shareAuxAudioBuffers &&
+			g_object_class_find_property(G_OBJECT_GET_CLASS(source), "leaky-type") != NULL)
+		{
+			/* A full aux queue drops its oldest buffers instead of growing, so a slow aux sink can't hold main audio memory */
+			g_object_set(source, "leaky-type", 2 /* GST_APP_LEAKY_TYPE_DOWNSTREAM */, NULL);
+			MW_LOG_INFO("Aux audio appsrc set to drop old buffers when full");
+		}
 	}
 	g_object_set(source, "min-percent", 50, NULL);								/* Trigger the need data event when the queued bytes fall below 50% */
 	/* "format" can be used to perform seek or query/conversion operation*/
@@ -1806,7 +2068,20 @@ void InterfacePlayerRDK::InitializeSourceForPlayer(void *PlayerInstance, void *
 	}
 	if (caps != NULL)
 	{
-		gst_app_src_set_caps(GST_APP_SRC(source), caps);
+		/* GetCaps shares one caps object per format, so a pointer match is the common case */
+		GstCaps *currentCaps = gst_app_src_get_caps(GST_APP_SRC(source));
+		if (currentCaps != caps && !(currentCaps && gst_caps_is_equal(currentCaps, caps)))
+		{
+			gst_app_src_set_caps(GST_APP_SRC(source), caps);
+		}
+		else
+		{
+			MW_LOG_INFO("Caps unchanged for mediaType %d, skip set_caps", mediaType);
+		}
+		if (currentCaps)
+		{
+			gst_caps_unref(currentCaps);
+		}
 		gst_caps_unref(caps);
 	}
 	else
@@ -1816,7 +2091,11 @@ void InterfacePlayerRDK::InitializeSourceForPlayer(void *PlayerInstance, void *
 		 */
 		g_object_set(source, "typefind", TRUE, NULL);
 	}
-	stream->sourceConfigured = true;
+	if( stream->format!=GST_FORMAT_ISO_BMFF || !m_gstConfigParam->useMp4Demux )
+	{ // Mp4Demux sets the caps once the init header arrives
+		privatePlayer->gstPrivateContext->tuneTimeline.MarkTrack(mediaType, eTUNE_TRACK_CAPS_SET);
+	}
+	stream->sourceState.store(eGST_SOURCE_CONFIGURED, std::memory_order_release);
 }
 
 static GstPadProbeReturn InterfacePlayerRDK_DemuxPadProbeCallback(GstPad * pad, GstPadProbeInfo * info, void* _this)
@@ -1880,7 +2159,7 @@ static void GstPlayer_OnDemuxPadAddedCb(GstElement* demux, GstPad* newPad, void*
 		bool found = false;
 		while (parent)
 		{
-			if (gst_StartsWith(GST_ELEMENT_NAME(parent), "playbin"))
+			if (GstPlayer_GetElementRoles(GST_OBJECT(parent), pInterfacePlayerRDK) & ELEMENT_ROLE_PLAYBIN)
 			{
 				for (int i = 0; i < GST_TRACK_COUNT; i++)
 				{
@@ -1924,6 +2203,8 @@ static void GstPlayer_OnDemuxPadAddedCb(GstElement* demux, GstPad* newPad, void*
 }
 static void element_setup_cb(void *playbin, void *element, void *instance)
 {
+	// classify now, on the streaming thread, so the bus handlers only read the cached tag
+	(void)GstPlayer_GetElementRoles(GST_OBJECT(element), (InterfacePlayerRDK *)instance);
 	gchar* elemName = gst_element_get_name((GstElement*)element);
 	if (elemName && gst_StartsWith(elemName, "qtdemux"))
 	{
@@ -1949,7 +2230,7 @@ static void gstInitializeSource(void *_this, GObject *source, int iMediaType = e
 	gst_media_stream *stream = &privatePlayer->gstPrivateContext->stream[mediaType];
 
 	pInterfacePlayerRDK->InitializeSourceForPlayer(pInterfacePlayerRDK,source, (int)mediaType);
-	stream->sourceConfigured = true;
+	stream->sourceState.store(eGST_SOURCE_CONFIGURED, std::memory_order_release);
 }
 /**
  * @brief Callback when source is added by playbin
@@ -2167,8 +2448,23 @@ int InterfacePlayerRDK::SetupStream(int streamId,  void *playerInstance, std::st
 	}
 	else
 	{
-		MW_LOG_INFO("using playbin");						/* Media is not subtitle, use the generic playbin */
-		stream->sinkbin = GST_ELEMENT(gst_object_ref_sink(gst_element_factory_make("playbin", NULL)));	/* Creates a new element of "playbin" type and returns a new GstElement */
+		GstElement *warmPlaybin = NULL;
+		if (m_gstConfigParam->warmPlaybinCount > 0 && !m_gstConfigParam->tcpServerSink && !interfacePlayerPriv->gstPrivateContext->usingRialtoSink)
+		{ // claim a pre-built READY playbin; the pool refills in the background for the next tune
+			WarmPlaybinPool &pool = WarmPlaybinPool::GetInstance();
+			pool.Configure(m_gstConfigParam->warmPlaybinCount);
+			warmPlaybin = pool.Claim(streamId);
+		}
+		if (warmPlaybin)
+		{
+			MW_LOG_MIL("using pre-built playbin for mediaType %d", streamId);
+			stream->sinkbin = warmPlaybin;
+		}
+		else
+		{
+			MW_LOG_INFO("using playbin");						/* Media is not subtitle, use the generic playbin */
+			stream->sinkbin = GST_ELEMENT(gst_object_ref_sink(gst_element_factory_make("playbin", NULL)));	/* Creates a new element of "playbin" type and returns a new GstElement */
+		}
 
 		if (m_gstConfigParam->tcpServerSink)
 		{
@@ -2369,6 +2665,7 @@ void InterfacePlayerPriv::SendGstEvents(int mediaType, GstClockTime pts, int ena
 		{
 			gstPrivateContext->segmentStart = 0;
 		}
+		gstPrivateContext->positionClock.Invalidate();
 	}
 
 	if (stream->format == GST_FORMAT_ISO_BMFF)
@@ -2555,6 +2852,62 @@ long long InterfacePlayerRDK::GetPositionMilliseconds(void)
 		MW_LOG_INFO("Pipeline is in %s state %s target state, paused=%d returning position as %lld", gst_element_state_get_name(interfacePlayerPriv->gstPrivateContext->pipelineState), gst_element_state_get_name(GST_STATE_TARGET(interfacePlayerPriv->gstPrivateContext->pipeline)), interfacePlayerPriv->gstPrivateContext->paused, rc);
 		return rc;
 	}
+	int sampleIntervalMs = m_gstConfigParam->positionSampleIntervalMs;
+	double slope;
+	if (sampleIntervalMs <= 0 || interfacePlayerPriv->gstPrivateContext->rate != GST_NORMAL_PLAY_RATE)
+	{ // trickplay positions are scaled by the rate and stepped; always query
+		QueryPositionMilliseconds(rc);
+		return rc;
+	}
+	if (interfacePlayerPriv->gstPrivateContext->pipelineState == GST_STATE_PLAYING && !interfacePlayerPriv->gstPrivateContext->paused)
+	{
+		slope = 1.0;
+	}
+	else if (interfacePlayerPriv->gstPrivateContext->pipelineState == GST_STATE_PAUSED && interfacePlayerPriv->gstPrivateContext->paused)
+	{
+		slope = 0.0;
+	}
+	else
+	{ // on its way to PLAYING, position is not advancing steadily yet
+		QueryPositionMilliseconds(rc);
+		return rc;
+	}
+	PlayerPositionClock &clock = interfacePlayerPriv->gstPrivateContext->positionClock;
+	int64_t ageUs = 0;
+	bool haveSample = clock.Read(PlayerPositionClock::NowUs(), rc, ageUs);
+	if (haveSample && ageUs < (int64_t)sampleIntervalMs * 1000)
+	{
+		return rc;
+	}
+	if (!clock.TryBeginRefresh())
+	{ // another thread is sampling the pipeline
+		if (!haveSample)
+		{
+			QueryPositionMilliseconds(rc);
+		}
+		return rc;
+	}
+	long long position = 0;
+	if (QueryPositionMilliseconds(position))
+	{
+		clock.Publish(position, PlayerPositionClock::NowUs(), slope);
+		rc = position;
+	}
+	else if (!haveSample)
+	{
+		rc = 0;
+	}
+	clock.EndRefresh();
+	return rc;
+}
+
+/**
+ *  @brief Query the pipeline for the playback position in MS
+ */
+bool InterfacePlayerRDK::QueryPositionMilliseconds(long long &positionMs)
+{
+	bool ret = false;
+	long long rc = 0;
 	gst_media_stream* video = &interfacePlayerPriv->gstPrivateContext->stream[eGST_MEDIATYPE_VIDEO];
 	// segment.start needs to be queried
 	if (interfacePlayerPriv->gstPrivateContext->segmentStart == -1)
@@ -2598,8 +2951,10 @@ long long InterfacePlayerRDK::GetPositionMilliseconds(void)
 		}
 		//MW_LOG_MIL("InterfacePlayerRDK: with positionQuery pos - %" G_GINT64_FORMAT " rc - %lld", GST_TIME_AS_MSECONDS(pos), rc);
 		//positionQuery is not unref-ed here, because it could be reused for future position queries
+		ret = true;
 	}
-	return rc;
+	positionMs = rc;
+	return ret;
 }
 
 /**
@@ -2803,7 +3158,7 @@ bool InterfacePlayerRDK::WaitForSourceSetup(int mediaType)
 		}
 		else
 		{
-			if (stream->sourceConfigured)
+			if (stream->IsSourceConfigured())
 			{
 				MW_LOG_MIL("Source element[%p] for track[%d] setup completed!", stream->source, type);
 				ret = true;
@@ -2831,7 +3186,7 @@ void InterfacePlayerPriv::ForwardBuffersToAuxPipeline(GstBuffer *buffer, bool pa
 {
 	gst_media_stream *stream = &gstPrivateContext->stream[eGST_MEDIATYPE_AUX_AUDIO];
 	InterfacePlayerRDK *instance = static_cast<InterfacePlayerRDK*>(user_data);
-	if (!stream->sourceConfigured && stream->format != GST_FORMAT_INVALID)
+	if (!stream->IsSourceConfigured() && stream->format != GST_FORMAT_INVALID)
 	{
 		bool status = instance->WaitForSourceSetup((int)eGST_MEDIATYPE_AUX_AUDIO);
 		if (pauseInjecter && !status)
@@ -2841,17 +3196,25 @@ void InterfacePlayerPriv::ForwardBuffersToAuxPipeline(GstBuffer *buffer, bool pa
 		}
 	}
 
-	GstBuffer *fwdBuffer = gst_buffer_new();
-	if (fwdBuffer != NULL)
+	GstBuffer *fwdBuffer = NULL;
+	if (instance->m_gstConfigParam->shareAuxAudioBuffers)
+	{ // both appsrcs hold a reference; the buffer is read only from here on, so neither branch can alter the other's view
+		fwdBuffer = gst_buffer_ref(buffer);
+	}
+	else
 	{
-		if (FALSE == gst_buffer_copy_into(fwdBuffer, buffer, GST_BUFFER_COPY_ALL, 0, -1))
+		fwdBuffer = gst_buffer_new();
+		if (fwdBuffer != NULL && FALSE == gst_buffer_copy_into(fwdBuffer, buffer, GST_BUFFER_COPY_ALL, 0, -1))
 		{
 			MW_LOG_ERR("Error while copying audio buffer to auxiliary buffer!!");
 			gst_buffer_unref(fwdBuffer);
 			return;
 		}
+	}
+	if (fwdBuffer != NULL)
+	{
 		//MW_LOG_TRACE("Forward audio buffer to auxiliary pipeline!!");
-		GstFlowReturn ret = gst_app_src_push_buffer(GST_APP_SRC(stream->source), fwdBuffer);
+		GstFlowReturn ret = PushBufferWithStats(stream, fwdBuffer);
 		if (ret != GST_FLOW_OK)
 		{
 			MW_LOG_ERR("gst_app_src_push_buffer error: %d[%s] mediaType %d", ret, gst_flow_get_name (ret), (int)eGST_MEDIATYPE_AUX_AUDIO);
@@ -2872,72 +3235,1361 @@ void InterfacePlayerRDK::SetPlayerName(std::string name)
 	interfacePlayerPriv->mPlayerName = name;
 }
 
-/**
- *  @brief Inject stream buffer to gstreamer pipeline
- */
-bool InterfacePlayerRDK::SendHelper(int type, const void *ptr, size_t len, double fpts, double fdts, double fDuration, double fragmentPTSoffset, bool copy, bool initFragment, bool &discontinuity, bool &notifyFirstBufferProcessed, bool &sendNewSegmentEvent, bool &resetTrickUTC, bool &firstBufferPushed)
+InjectionBufferPool::InjectionBufferPool() : createMutex(), queueBytes(0), maxBuffers(0)
 {
-	GstMediaType mediaType = static_cast<GstMediaType>(type);
-	GstClockTime pts = (GstClockTime)(fpts * GST_SECOND);
-	GstClockTime dts = (GstClockTime)(fdts * GST_SECOND);
-	GstClockTime duration = (GstClockTime)(fDuration * 1000000000LL);
-	gst_media_stream *stream = &interfacePlayerPriv->gstPrivateContext->stream[mediaType];
-	if (eGST_MEDIATYPE_SUBTITLE == mediaType && discontinuity)
+	for (int i = 0; i < kSizeClassCount; i++)
 	{
-		MW_LOG_WARN( "[%d] Discontinuity detected - setting subtitle clock to %" GST_TIME_FORMAT " dAR %d rP %d init %d sC %d",
-					mediaType,
-					GST_TIME_ARGS(pts),
-					!mPauseInjector,
-					stream->resetPosition,
-					initFragment,
-					stream->sourceConfigured );
-		//gst_element_seek_simple(GST_ELEMENT(stream->source), GST_FORMAT_TIME, GST_SEEK_FLAG_NONE, pts);
+		pools[i] = NULL;
 	}
+}
 
-	bool segmentEventSent = false;
-	bool isFirstBuffer = stream->resetPosition;
-	// Make sure source element is present before data is injected
-	// If format is FORMAT_INVALID, we don't know what we are doing here
-	pthread_mutex_lock(&stream->sourceLock);
+InjectionBufferPool::~InjectionBufferPool()
+{
+	Reset();
+}
 
-	if (!stream->sourceConfigured && stream->format != GST_FORMAT_INVALID)
-	{
-		bool status = WaitForSourceSetup(type);
+/**
+ * @brief Set the per-track limits of the buffer pools
+ */
+void InjectionBufferPool::Configure(size_t queueBytes, int maxBuffers)
+{
+	std::lock_guard<std::mutex> guard(createMutex);
+	this->queueBytes = queueBytes;
+	this->maxBuffers = maxBuffers;
+}
 
-		if (mPauseInjector || !status)
-		{
-			pthread_mutex_unlock(&stream->sourceLock);
-			return false;
-		}
+/**
+ * @brief Create and activate the pool of one size class
+ */
+GstBufferPool *InjectionBufferPool::CreatePool(int sizeClass)
+{
+	guint size = (guint)(kSmallestClassBytes << (2 * sizeClass));
+	guint max = (guint)(queueBytes / size);
+	if (maxBuffers > 0 && max > (guint)maxBuffers)
+	{
+		max = (guint)maxBuffers;
 	}
-	if (isFirstBuffer)
+	if (max < 2)
+	{ // one in the appsrc queue and one being filled
+		max = 2;
+	}
+	GstBufferPool *pool = gst_buffer_pool_new();
+	GstStructure *config = gst_buffer_pool_get_config(pool);
+	gst_buffer_pool_config_set_params(config, NULL, size, 0, max);
+	if (!gst_buffer_pool_set_config(pool, config) || !gst_buffer_pool_set_active(pool, TRUE))
 	{
-		//Send Gst Event when first buffer received after new tune, seek or period change
-		int enableGstQuery = m_gstConfigParam->enableGstPosQuery;
-		interfacePlayerPriv->SendGstEvents((int)mediaType, pts, enableGstQuery, m_gstConfigParam->enablePTSReStamp, m_gstConfigParam->vodTrickModeFPS);
-
-		if (mediaType == eGST_MEDIATYPE_AUDIO && ForwardAudioBuffersToAux())
-		{
-			interfacePlayerPriv->SendGstEvents((int)eGST_MEDIATYPE_AUX_AUDIO, pts, enableGstQuery, m_gstConfigParam->enablePTSReStamp, m_gstConfigParam->vodTrickModeFPS);
-		}
-
-		// included to fix av sync / trickmode speed issues
-		// Also add check for trick-play on 1st frame.
-		if (interfacePlayerPriv->socInterface->IsPlatformSegmentReady() && sendNewSegmentEvent == true)
-		{
-			interfacePlayerPriv->SendNewSegmentEvent(mediaType, pts, 0);
-			segmentEventSent = true;
-		}
-		MW_LOG_DEBUG("mediaType[%d] SendGstEvents - first buffer received !!! initFragment: %d, pts: %" G_GUINT64_FORMAT, mediaType, initFragment, pts);
-
+		MW_LOG_WARN("Unable to activate %u byte injection buffer pool", size);
+		gst_object_unref(pool);
+		return NULL;
 	}
+	MW_LOG_INFO("Injection buffer pool created, size %u max buffers %u", size, max);
+	return pool;
+}
 
-	sendNewSegmentEvent = segmentEventSent;
-	bool bPushBuffer = !mPauseInjector;
-	if(bPushBuffer)
+/**
+ * @brief Get a recycled buffer of exactly len bytes
+ */
+GstBuffer *InjectionBufferPool::Acquire(size_t len)
+{
+	int sizeClass = 0;
+	while (sizeClass < kSizeClassCount && (kSmallestClassBytes << (2 * sizeClass)) < len)
 	{
-		GstBuffer *buffer;
+		sizeClass++;
+	}
+	if (sizeClass == kSizeClassCount)
+	{
+		return NULL;
+	}
+	GstBufferPool *pool = pools[sizeClass].load(std::memory_order_acquire);
+	if (!pool)
+	{
+		std::lock_guard<std::mutex> guard(createMutex);
+		pool = pools[sizeClass].load(std::memory_order_relaxed);
+		if (!pool)
+		{
+			pool = CreatePool(sizeClass);
+			if (!pool)
+			{
+				return NULL;
+			}
+			pools[sizeClass].store(pool, std::memory_order_release);
+		}
+	}
+	GstBuffer *buffer = NULL;
+	GstBufferPoolAcquireParams params = {};
+	params.flags = GST_BUFFER_POOL_ACQUIRE_FLAG_DONTWAIT;
+	if (gst_buffer_pool_acquire_buffer(pool, &buffer, &params) != GST_FLOW_OK)
+	{ // all buffers of this class are still queued downstream
+		return NULL;
+	}
+	// the pool restores the full size when the buffer comes back
+	gst_buffer_set_size(buffer, (gssize)len);
+	return buffer;
+}
+
+/**
+ * @brief Deactivate and drop all pools
+ */
+void InjectionBufferPool::Reset()
+{
+	std::lock_guard<std::mutex> guard(createMutex);
+	for (int i = 0; i < kSizeClassCount; i++)
+	{
+		GstBufferPool *pool = pools[i].exchange(NULL);
+		if (pool)
+		{
+			gst_buffer_pool_set_active(pool, FALSE);
+			gst_object_unref(pool);
+		}
+	}
+}
+
+TuneTimelineRecorder::TuneTimelineRecorder()
+{
+	Reset();
+}
+
+/**
+ * @brief Start a timeline at eTUNE_MILESTONE_CONFIGURE unless one is running
+ */
+void TuneTimelineRecorder::Start()
+{
+	gint64 unset = 0;
+	gint64 now = g_get_monotonic_time();
+	if (startUs.compare_exchange_strong(unset, now))
+	{
+		milestoneUs[eTUNE_MILESTONE_CONFIGURE].store(now);
+	}
+}
+
+/**
+ * @brief Keep the first time a milestone is reached while a timeline is running
+ */
+void TuneTimelineRecorder::MarkOnce(std::atomic<gint64> &slot)
+{
+	gint64 unset = 0;
+	slot.compare_exchange_strong(unset, g_get_monotonic_time());
+}
+
+void TuneTimelineRecorder::Mark(PlayerTuneMilestone milestone)
+{
+	if (startUs.load() && milestone >= 0 && milestone < eTUNE_MILESTONE_COUNT)
+	{
+		MarkOnce(milestoneUs[milestone]);
+	}
+}
+
+void TuneTimelineRecorder::MarkTrack(int mediaType, PlayerTuneTrackMilestone milestone)
+{
+	if (startUs.load() && mediaType >= 0 && mediaType < PlayerTuneTimeline::kTrackCount &&
+		milestone >= 0 && milestone < eTUNE_TRACK_MILESTONE_COUNT)
+	{
+		MarkOnce(trackMilestoneUs[mediaType][milestone]);
+	}
+}
+
+/**
+ * @brief Copy the timeline as offsets from its origin
+ */
+void TuneTimelineRecorder::Snapshot(PlayerTuneTimeline &timeline) const
+{
+	gint64 start = startUs.load();
+	timeline.startUs = start;
+	for (int i = 0; i < eTUNE_MILESTONE_COUNT; i++)
+	{
+		gint64 at = milestoneUs[i].load();
+		timeline.milestoneUs[i] = (start && at) ? at - start : -1;
+	}
+	for (int track = 0; track < PlayerTuneTimeline::kTrackCount; track++)
+	{
+		for (int i = 0; i < eTUNE_TRACK_MILESTONE_COUNT; i++)
+		{
+			gint64 at = trackMilestoneUs[track][i].load();
+			timeline.trackMilestoneUs[track][i] = (start && at) ? at - start : -1;
+		}
+	}
+}
+
+/**
+ * @brief Discard the timeline; marks are ignored until the next Start
+ */
+void TuneTimelineRecorder::Reset()
+{
+	startUs.store(0);
+	for (int i = 0; i < eTUNE_MILESTONE_COUNT; i++)
+	{
+		milestoneUs[i].store(0);
+	}
+	for (int track = 0; track < PlayerTuneTimeline::kTrackCount; track++)
+	{
+		for (int i = 0; i < eTUNE_TRACK_MILESTONE_COUNT; i++)
+		{
+			trackMilestoneUs[track][i].store(0);
+		}
+	}
+}
+
+const char *TuneTimelineRecorder::GetMilestoneName(PlayerTuneMilestone milestone)
+{
+	static const char *name[eTUNE_MILESTONE_COUNT] =
+	{
+		"configure",
+		"pipeline_created",
+		"paused",
+		"playing",
+		"first_frame",
+	};
+	return (milestone >= 0 && milestone < eTUNE_MILESTONE_COUNT) ? name[milestone] : "unknown";
+}
+
+const char *TuneTimelineRecorder::GetTrackMilestoneName(PlayerTuneTrackMilestone milestone)
+{
+	static const char *name[eTUNE_TRACK_MILESTONE_COUNT] =
+	{
+		"setup_start",
+		"setup_done",
+		"caps_set",
+		"first_buffer_pushed",
+		"first_frame_decoded",
+	};
+	return (milestone >= 0 && milestone < eTUNE_TRACK_MILESTONE_COUNT) ? name[milestone] : "unknown";
+}
+
+WarmPlaybinPool::WarmPlaybinPool() : lifecycleMutex(), mutex(), refillCond(), target(0), generation(0), stopWorker(false), worker()
+{
+}
+
+WarmPlaybinPool::~WarmPlaybinPool()
+{
+	Clear();
+}
+
+/**
+ * @brief Get the process wide pool; intentionally never destroyed so no GStreamer call runs during static destruction
+ */
+WarmPlaybinPool &WarmPlaybinPool::GetInstance()
+{
+	static WarmPlaybinPool *instance = new WarmPlaybinPool();
+	return *instance;
+}
+
+/**
+ * @brief Map a media type to its pool slot
+ * @return slot index, or -1 for tracks that are not pooled
+ */
+int WarmPlaybinPool::GetSlot(int mediaType)
+{
+	switch (mediaType)
+	{
+		case eGST_MEDIATYPE_VIDEO:
+			return 0;
+		case eGST_MEDIATYPE_AUDIO:
+			return 1;
+		default:
+			return -1;
+	}
+}
+
+/**
+ * @brief Create a playbin, preset its sink and bring it to READY
+ */
+GstElement *WarmPlaybinPool::Build(int slot, const std::string &sinkFactory)
+{
+	GstElement *playbin = gst_element_factory_make("playbin", NULL);
+	if (!playbin)
+	{
+		MW_LOG_ERR("Cannot create playbin for warm pool");
+		return NULL;
+	}
+	playbin = GST_ELEMENT(gst_object_ref_sink(playbin));
+	if (!sinkFactory.empty())
+	{
+		GstElement *sink = gst_element_factory_make(sinkFactory.c_str(), NULL);
+		if (sink)
+		{
+			g_object_set(playbin, (slot == 0) ? "video-sink" : "audio-sink", sink, NULL);
+		}
+		else
+		{
+			MW_LOG_WARN("Cannot create %s for warm pool", sinkFactory.c_str());
+		}
+	}
+	if (GST_STATE_CHANGE_FAILURE == gst_element_set_state(playbin, GST_STATE_READY))
+	{
+		MW_LOG_ERR("Warm pool playbin failed to reach READY");
+		Discard(playbin);
+		return NULL;
+	}
+	return playbin;
+}
+
+/**
+ * @brief Release a pooled playbin that was never claimed
+ */
+void WarmPlaybinPool::Discard(GstElement *playbin)
+{
+	gst_element_set_state(playbin, GST_STATE_NULL);
+	gst_object_unref(playbin);
+}
+
+/**
+ * @brief Set the pool size and sink presets; stale playbins are dropped when the presets change
+ */
+void WarmPlaybinPool::Configure(int perTrack, const char *videoSink, const char *audioSink)
+{
+	if (perTrack <= 0)
+	{
+		Clear();
+		return;
+	}
+	std::lock_guard<std::mutex> lifecycle(lifecycleMutex);
+	std::vector<GstElement *> stale;
+	{
+		std::lock_guard<std::mutex> guard(mutex);
+		std::string sinks[kSlotCount] = {videoSink ? videoSink : "", audioSink ? audioSink : ""};
+		for (int slot = 0; slot < kSlotCount; slot++)
+		{
+			if (sinks[slot] != sinkFactory[slot])
+			{
+				sinkFactory[slot] = sinks[slot];
+				stale.insert(stale.end(), playbins[slot].begin(), playbins[slot].end());
+				playbins[slot].clear();
+				generation++;
+			}
+		}
+		target = perTrack;
+		if (!worker.joinable())
+		{
+			stopWorker = false;
+			worker = std::thread(&WarmPlaybinPool::RefillLoop, this);
+		}
+	}
+	refillCond.notify_one();
+	for (GstElement *playbin : stale)
+	{
+		Discard(playbin);
+	}
+}
+
+/**
+ * @brief Take a pooled playbin and wake the worker to build its replacement
+ */
+GstElement *WarmPlaybinPool::Claim(int mediaType)
+{
+	int slot = GetSlot(mediaType);
+	GstElement *playbin = NULL;
+	if (slot >= 0)
+	{
+		std::lock_guard<std::mutex> guard(mutex);
+		if (!playbins[slot].empty())
+		{
+			playbin = playbins[slot].front();
+			playbins[slot].pop_front();
+		}
+	}
+	if (playbin)
+	{
+		refillCond.notify_one();
+	}
+	return playbin;
+}
+
+/**
+ * @brief Number of playbins pooled for a track
+ */
+int WarmPlaybinPool::Available(int mediaType)
+{
+	int slot = GetSlot(mediaType);
+	if (slot < 0)
+	{
+		return 0;
+	}
+	std::lock_guard<std::mutex> guard(mutex);
+	return (int)playbins[slot].size();
+}
+
+/**
+ * @brief Stop the worker and release every pooled playbin
+ *
+ * The lifecycle lock is held until the worker has been joined, so a concurrent Configure cannot
+ * clear stopWorker and start a second worker while this one is still being stopped.
+ */
+void WarmPlaybinPool::Clear()
+{
+	std::lock_guard<std::mutex> lifecycle(lifecycleMutex);
+	std::thread stopping;
+	std::vector<GstElement *> stale;
+	{
+		std::lock_guard<std::mutex> guard(mutex);
+		stopWorker = true;
+		target = 0;
+		generation++;
+		stopping = std::move(worker);
+		for (int slot = 0; slot < kSlotCount; slot++)
+		{
+			stale.insert(stale.end(), playbins[slot].begin(), playbins[slot].end());
+			playbins[slot].clear();
+		}
+	}
+	refillCond.notify_one();
+	if (stopping.joinable())
+	{
+		stopping.join();
+	}
+	for (GstElement *playbin : stale)
+	{
+		Discard(playbin);
+	}
+}
+
+/**
+ * @brief Worker keeping every slot at the target count; playbins are built outside the lock
+ */
+void WarmPlaybinPool::RefillLoop()
+{
+	std::unique_lock<std::mutex> lock(mutex);
+	while (!stopWorker)
+	{
+		int slot = -1;
+		for (int i = 0; i < kSlotCount; i++)
+		{
+			if ((int)playbins[i].size() < target)
+			{
+				slot = i;
+				break;
+			}
+		}
+		if (slot < 0)
+		{
+			refillCond.wait(lock);
+			continue;
+		}
+		std::string sink = sinkFactory[slot];
+		unsigned buildGeneration = generation;
+		lock.unlock();
+		GstElement *playbin = Build(slot, sink);
+		lock.lock();
+		if (!playbin)
+		{ // avoid spinning when playbin is unavailable; retried on the next claim or configure
+			refillCond.wait_for(lock, std::chrono::seconds(1));
+		}
+		else if (stopWorker || buildGeneration != generation || (int)playbins[slot].size() >= target)
+		{
+			lock.unlock();
+			Discard(playbin);
+			lock.lock();
+		}
+		else
+		{
+			playbins[slot].push_back(playbin);
+		}
+	}
+}
+
+PlayerMainLoopThread::PlayerMainLoopThread() : mutex(), context(NULL), loop(NULL), thread()
+{
+}
+
+PlayerMainLoopThread::~PlayerMainLoopThread()
+{
+	Stop();
+}
+
+void PlayerMainLoopThread::Start()
+{
+	std::lock_guard<std::mutex> guard(mutex);
+	if (!loop)
+	{
+		context = g_main_context_new();
+		loop = g_main_loop_new(context, FALSE);
+		thread = std::thread(&PlayerMainLoopThread::Run, g_main_context_ref(context), g_main_loop_ref(loop));
+		MW_LOG_MIL("PlayerMainLoopThread: started context %p", context);
+	}
+}
+
+/**
+ * @brief Thread body; owns a reference to the context and loop so it can outlive a detaching Stop()
+ */
+void PlayerMainLoopThread::Run(GMainContext *context, GMainLoop *loop)
+{
+	g_main_context_push_thread_default(context);
+	g_main_loop_run(loop);
+	g_main_context_pop_thread_default(context);
+	g_main_loop_unref(loop);
+	g_main_context_unref(context);
+}
+
+/**
+ * @brief Quit from inside the loop, so a quit requested before g_main_loop_run() started is not lost
+ */
+gboolean PlayerMainLoopThread::QuitLoop(gpointer loop)
+{
+	g_main_loop_quit((GMainLoop *)loop);
+	return G_SOURCE_REMOVE;
+}
+
+void PlayerMainLoopThread::Stop()
+{
+	GMainContext *stopContext;
+	GMainLoop *stopLoop;
+	std::thread stopThread;
+	{
+		std::lock_guard<std::mutex> guard(mutex);
+		if (!loop || !thread.joinable())
+		{ // not started, or another Stop() is already joining
+			return;
+		}
+		stopContext = g_main_context_ref(context);
+		stopLoop = g_main_loop_ref(loop);
+		stopThread = std::move(thread);
+	}
+	/* Not holding the mutex from here on: callbacks still being dispatched may add and remove
+	 * sources on the context until the loop quits */
+	GSource *quitSource = g_idle_source_new();
+	g_source_set_priority(quitSource, G_PRIORITY_HIGH);
+	g_source_set_callback(quitSource, QuitLoop, g_main_loop_ref(stopLoop), (GDestroyNotify)g_main_loop_unref);
+	g_source_attach(quitSource, stopContext);
+	g_source_unref(quitSource);
+	if (stopThread.get_id() == std::this_thread::get_id())
+	{
+		stopThread.detach();
+	}
+	else
+	{
+		stopThread.join();
+	}
+	{
+		std::lock_guard<std::mutex> guard(mutex);
+		g_main_loop_unref(loop);
+		g_main_context_unref(context);
+		loop = NULL;
+		context = NULL;
+	}
+	g_main_loop_unref(stopLoop);
+	g_main_context_unref(stopContext);
+	MW_LOG_MIL("PlayerMainLoopThread: stopped");
+}
+
+GMainContext *PlayerMainLoopThread::GetContext()
+{
+	std::lock_guard<std::mutex> guard(mutex);
+	return context;
+}
+
+guint PlayerMainLoopThread::AddTimeout(gint priority, guint intervalMs, GSourceFunc function, gpointer data)
+{
+	std::lock_guard<std::mutex> guard(mutex);
+	if (!context)
+	{
+		return (priority == G_PRIORITY_DEFAULT) ? g_timeout_add(intervalMs, function, data) : g_timeout_add_full(priority, intervalMs, function, data, NULL);
+	}
+	GSource *source = g_timeout_source_new(intervalMs);
+	g_source_set_priority(source, priority);
+	g_source_set_callback(source, function, data, NULL);
+	guint sourceId = g_source_attach(source, context);
+	g_source_unref(source);
+	return sourceId;
+}
+
+void PlayerMainLoopThread::RemoveSource(guint sourceId)
+{
+	std::lock_guard<std::mutex> guard(mutex);
+	if (!context)
+	{
+		g_source_remove(sourceId);
+		return;
+	}
+	GSource *source = g_main_context_find_source_by_id(context, sourceId);
+	if (source)
+	{
+		g_source_destroy(source);
+	}
+}
+
+guint PlayerMainLoopThread::AddBusWatch(GstBus *bus, GstBusFunc function, gpointer data)
+{
+	std::lock_guard<std::mutex> guard(mutex);
+	// gst_bus_add_watch() attaches to the thread default context
+	if (context)
+	{
+		g_main_context_push_thread_default(context);
+	}
+	guint watchId = gst_bus_add_watch(bus, function, data);
+	if (context)
+	{
+		g_main_context_pop_thread_default(context);
+	}
+	return watchId;
+}
+
+PipelineReaper::PipelineReaper() : mutex(), jobCond(), doneCond(), jobs(), pending(0), worker()
+{
+}
+
+/**
+ * @brief Get the process wide reaper; intentionally never destroyed so no GStreamer call runs during static destruction
+ */
+PipelineReaper &PipelineReaper::GetInstance()
+{
+	static PipelineReaper *instance = new PipelineReaper();
+	return *instance;
+}
+
+/**
+ * @brief Queue a pipeline and start the worker on first use
+ */
+void PipelineReaper::Reap(GstElement *pipeline, GstBus *bus, GstTaskPool *taskPool)
+{
+	{
+		std::lock_guard<std::mutex> guard(mutex);
+		jobs.push_back(Job{pipeline, bus, taskPool});
+		pending++;
+		if (!worker.joinable())
+		{
+			worker = std::thread(&PipelineReaper::ReapLoop, this);
+		}
+	}
+	jobCond.notify_one();
+}
+
+/**
+ * @brief Wait for the backlog to drop to maxPending
+ */
+bool PipelineReaper::WaitForPending(int maxPending, int timeoutMs)
+{
+	std::unique_lock<std::mutex> lock(mutex);
+	return doneCond.wait_for(lock, std::chrono::milliseconds(timeoutMs), [this, maxPending] { return pending <= maxPending; });
+}
+
+/**
+ * @brief Number of pipelines not yet released
+ */
+int PipelineReaper::Pending()
+{
+	std::lock_guard<std::mutex> guard(mutex);
+	return pending;
+}
+
+/**
+ * @brief Set a pipeline to NULL and drop the references handed over with it
+ */
+void PipelineReaper::Release(const Job &job)
+{
+	if (job.bus)
+	{ // nobody reads this bus any more; drop the messages posted during the state change
+		gst_bus_set_flushing(job.bus, TRUE);
+	}
+	if (GST_STATE_CHANGE_FAILURE == gst_element_set_state(job.pipeline, GST_STATE_NULL))
+	{
+		MW_LOG_ERR("PipelineReaper: failed to set %s to NULL", GST_ELEMENT_NAME(job.pipeline));
+	}
+	MW_LOG_MIL("PipelineReaper: destroying gstreamer pipeline %s", GST_ELEMENT_NAME(job.pipeline));
+	gst_object_unref(job.pipeline);
+	if (job.bus)
+	{
+		gst_object_unref(job.bus);
+	}
+	if (job.taskPool)
+	{
+		gst_object_unref(job.taskPool);
+	}
+}
+
+/**
+ * @brief Worker releasing queued pipelines in order; runs for the lifetime of the process
+ */
+void PipelineReaper::ReapLoop()
+{
+	std::unique_lock<std::mutex> lock(mutex);
+	while (true)
+	{
+		if (jobs.empty())
+		{
+			jobCond.wait(lock);
+			continue;
+		}
+		Job job = jobs.front();
+		jobs.pop_front();
+		lock.unlock();
+		gint64 startUs = g_get_monotonic_time();
+		Release(job);
+		MW_LOG_INFO("PipelineReaper: teardown took %" G_GINT64_FORMAT " us", g_get_monotonic_time() - startUs);
+		lock.lock();
+		pending--;
+		doneCond.notify_all();
+	}
+}
+
+InjectionStatsCounters::InjectionStatsCounters()
+{
+	Reset();
+}
+
+/**
+ * @brief Raise an atomic maximum without taking a lock
+ */
+static void UpdateAtomicMax(std::atomic<uint64_t> &target, uint64_t value)
+{
+	uint64_t current = target.load(std::memory_order_relaxed);
+	while (value > current && !target.compare_exchange_weak(current, value, std::memory_order_relaxed))
+	{
+	}
+}
+
+/**
+ * @brief Account one appsrc push
+ */
+void InjectionStatsCounters::RecordPush(uint64_t pushedBytes, uint64_t pushedBuffers, gint64 startUs, gint64 endUs, bool ok, uint64_t level)
+{
+	uint64_t elapsedUs = (endUs > startUs) ? (uint64_t)(endUs - startUs) : 0;
+	int bucket = 0;
+	for (uint64_t limit = 10; bucket < PlayerInjectionStats::kLatencyBuckets - 1 && elapsedUs >= limit; limit *= 10)
+	{
+		bucket++;
+	}
+	latency[bucket].fetch_add(1, std::memory_order_relaxed);
+	UpdateAtomicMax(maxLatencyUs, elapsedUs);
+	pushCalls.fetch_add(1, std::memory_order_relaxed);
+	if (ok)
+	{
+		bytes.fetch_add(pushedBytes, std::memory_order_relaxed);
+		buffers.fetch_add(pushedBuffers, std::memory_order_relaxed);
+	}
+	else
+	{
+		pushFailures.fetch_add(1, std::memory_order_relaxed);
+	}
+	queuedBytes.store(level, std::memory_order_relaxed);
+	UpdateAtomicMax(maxQueuedBytes, level);
+	gint64 unset = 0;
+	firstPushUs.compare_exchange_strong(unset, startUs, std::memory_order_relaxed);
+	lastPushUs.store(endUs, std::memory_order_relaxed);
+}
+
+/**
+ * @brief Copy the counters into stats and derive the average throughput
+ */
+void InjectionStatsCounters::Snapshot(PlayerInjectionStats &stats) const
+{
+	stats.bytesPushed = bytes.load(std::memory_order_relaxed);
+	stats.buffersPushed = buffers.load(std::memory_order_relaxed);
+	stats.pushCalls = pushCalls.load(std::memory_order_relaxed);
+	stats.pushFailures = pushFailures.load(std::memory_order_relaxed);
+	for (int i = 0; i < PlayerInjectionStats::kLatencyBuckets; i++)
+	{
+		stats.pushLatencyHistogram[i] = latency[i].load(std::memory_order_relaxed);
+	}
+	stats.maxPushLatencyUs = maxLatencyUs.load(std::memory_order_relaxed);
+	stats.queuedBytes = queuedBytes.load(std::memory_order_relaxed);
+	stats.maxQueuedBytes = maxQueuedBytes.load(std::memory_order_relaxed);
+	stats.needDataCount = needData.load(std::memory_order_relaxed);
+	stats.enoughDataCount = enoughData.load(std::memory_order_relaxed);
+	stats.blockedTimeUs = blockedUs.load(std::memory_order_relaxed);
+	gint64 first = firstPushUs.load(std::memory_order_relaxed);
+	gint64 last = lastPushUs.load(std::memory_order_relaxed);
+	stats.activeTimeUs = (first > 0 && last > first) ? (uint64_t)(last - first) : 0;
+	stats.bytesPerSecond = stats.activeTimeUs ? (stats.bytesPushed * 1000000.0) / stats.activeTimeUs : 0;
+}
+
+/**
+ * @brief Clear all counters
+ */
+void InjectionStatsCounters::Reset()
+{
+	bytes.store(0, std::memory_order_relaxed);
+	buffers.store(0, std::memory_order_relaxed);
+	pushCalls.store(0, std::memory_order_relaxed);
+	pushFailures.store(0, std::memory_order_relaxed);
+	for (int i = 0; i < PlayerInjectionStats::kLatencyBuckets; i++)
+	{
+		latency[i].store(0, std::memory_order_relaxed);
+	}
+	maxLatencyUs.store(0, std::memory_order_relaxed);
+	queuedBytes.store(0, std::memory_order_relaxed);
+	maxQueuedBytes.store(0, std::memory_order_relaxed);
+	needData.store(0, std::memory_order_relaxed);
+	enoughData.store(0, std::memory_order_relaxed);
+	blockedUs.store(0, std::memory_order_relaxed);
+	firstPushUs.store(0, std::memory_order_relaxed);
+	lastPushUs.store(0, std::memory_order_relaxed);
+}
+
+AVSyncMonitor::AVSyncMonitor()
+{
+	Reset();
+}
+
+/**
+ * @brief Map a drift magnitude in ms to its log-linear bucket
+ */
+int AVSyncMonitor::GetBucketIndex(unsigned magnitude)
+{
+	if (magnitude < (unsigned)kSubBuckets)
+	{
+		return (int)magnitude;
+	}
+	int exponent = 31 - __builtin_clz(magnitude);
+	if (exponent > kMaxExponent)
+	{
+		return kBucketCount - 1;
+	}
+	int shift = exponent - kSubBucketBits;
+	return (shift + 1) * kSubBuckets + (int)((magnitude >> shift) & (kSubBuckets - 1));
+}
+
+/**
+ * @brief Middle of the magnitude range covered by a bucket
+ */
+unsigned AVSyncMonitor::GetBucketMidpoint(int index)
+{
+	if (index < kSubBuckets)
+	{
+		return (unsigned)index;
+	}
+	int shift = index / kSubBuckets - 1;
+	unsigned lower = (unsigned)(kSubBuckets + index % kSubBuckets) << shift;
+	return lower + ((1u << shift) >> 1);
+}
+
+bool AVSyncMonitor::ShouldPoll()
+{
+	int remaining = ticksUntilPoll.load(std::memory_order_relaxed);
+	if (remaining > 0)
+	{
+		ticksUntilPoll.store(remaining - 1, std::memory_order_relaxed);
+		skippedPolls.fetch_add(1, std::memory_order_relaxed);
+		return false;
+	}
+	return true;
+}
+
+static bool IsStallDescription(const char *description)
+{
+	return description && (strcmp(description, "stall") == 0 || strcmp(description, "video freeze") == 0 || strcmp(description, "audio drop") == 0);
+}
+
+void AVSyncMonitor::RecordPoll(const char *description, const char *previous, bool haveDrift, int driftMs, bool outOfSync, long long elapsedMs, bool backoff)
+{
+	polls.fetch_add(1, std::memory_order_relaxed);
+	if (!previous || strcmp(description, previous) != 0)
+	{ // count each episode once, on entry
+		if (strcmp(description, "stall") == 0)
+		{
+			stalls.fetch_add(1, std::memory_order_relaxed);
+		}
+		else if (strcmp(description, "video freeze") == 0)
+		{
+			videoFreezes.fetch_add(1, std::memory_order_relaxed);
+		}
+		else if (strcmp(description, "audio drop") == 0)
+		{
+			audioDrops.fetch_add(1, std::memory_order_relaxed);
+		}
+		else if (strcmp(description, "jump") == 0)
+		{
+			jumps.fetch_add(1, std::memory_order_relaxed);
+		}
+	}
+	if (IsStallDescription(description) && elapsedMs > 0)
+	{ // positions did not move since the previous poll
+		stalledMs.fetch_add((uint64_t)elapsedMs, std::memory_order_relaxed);
+	}
 
+	bool stable = false;
+	if (haveDrift)
+	{
+		uint64_t previousSamples = driftSamples.fetch_add(1, std::memory_order_relaxed);
+		if (outOfSync)
+		{
+			outOfSyncSamples.fetch_add(1, std::memory_order_relaxed);
+		}
+		if (driftMs >= 0)
+		{
+			ahead[GetBucketIndex((unsigned)driftMs)].fetch_add(1, std::memory_order_relaxed);
+		}
+		else
+		{
+			behind[GetBucketIndex(0u - (unsigned)driftMs)].fetch_add(1, std::memory_order_relaxed);
+		}
+		if (previousSamples == 0)
+		{
+			minDriftMs.store(driftMs, std::memory_order_relaxed);
+			maxDriftMs.store(driftMs, std::memory_order_relaxed);
+		}
+		else
+		{
+			if (driftMs < minDriftMs.load(std::memory_order_relaxed))
+			{
+				minDriftMs.store(driftMs, std::memory_order_relaxed);
+			}
+			if (driftMs > maxDriftMs.load(std::memory_order_relaxed))
+			{
+				maxDriftMs.store(driftMs, std::memory_order_relaxed);
+			}
+			int change = driftMs - lastDriftMs.load(std::memory_order_relaxed);
+			stable = !outOfSync && strcmp(description, "ok") == 0 && change <= kStableDriftMs && change >= -kStableDriftMs;
+		}
+		lastDriftMs.store(driftMs, std::memory_order_relaxed);
+	}
+
+	int interval = pollIntervalTicks.load(std::memory_order_relaxed);
+	if (!stable || !backoff)
+	{
+		interval = 1;
+		stableSamples.store(0, std::memory_order_relaxed);
+	}
+	else if (stableSamples.fetch_add(1, std::memory_order_relaxed) + 1 >= kStableSamplesToBackOff && interval < kMaxPollIntervalTicks)
+	{
+		interval *= 2;
+		stableSamples.store(0, std::memory_order_relaxed);
+	}
+	pollIntervalTicks.store(interval, std::memory_order_relaxed);
+	ticksUntilPoll.store(interval - 1, std::memory_order_relaxed);
+}
+
+/**
+ * @brief Copy the counters into stats and derive the drift percentiles
+ */
+void AVSyncMonitor::Snapshot(PlayerAVSyncStats &stats) const
+{
+	uint64_t aheadCounts[kBucketCount];
+	uint64_t behindCounts[kBucketCount];
+	uint64_t total = 0;
+	for (int i = 0; i < kBucketCount; i++)
+	{
+		aheadCounts[i] = ahead[i].load(std::memory_order_relaxed);
+		behindCounts[i] = behind[i].load(std::memory_order_relaxed);
+		total += aheadCounts[i] + behindCounts[i];
+	}
+	stats.polls = polls.load(std::memory_order_relaxed);
+	stats.skippedPolls = skippedPolls.load(std::memory_order_relaxed);
+	stats.driftSamples = driftSamples.load(std::memory_order_relaxed);
+	stats.outOfSyncSamples = outOfSyncSamples.load(std::memory_order_relaxed);
+	stats.stallEvents = stalls.load(std::memory_order_relaxed);
+	stats.videoFreezeEvents = videoFreezes.load(std::memory_order_relaxed);
+	stats.audioDropEvents = audioDrops.load(std::memory_order_relaxed);
+	stats.jumpEvents = jumps.load(std::memory_order_relaxed);
+	stats.stalledTimeMs = stalledMs.load(std::memory_order_relaxed);
+	stats.minDriftMs = minDriftMs.load(std::memory_order_relaxed);
+	stats.maxDriftMs = maxDriftMs.load(std::memory_order_relaxed);
+	stats.pollIntervalTicks = pollIntervalTicks.load(std::memory_order_relaxed);
+
+	const int permille[] = {500, 900, 990, 999};
+	int *results[] = {&stats.p50DriftMs, &stats.p90DriftMs, &stats.p99DriftMs, &stats.p999DriftMs};
+	for (int p = 0; p < 4; p++)
+	{
+		int value = 0;
+		if (total)
+		{
+			uint64_t rank = (total * permille[p] + 999) / 1000;
+			uint64_t seen = 0;
+			bool found = false;
+			// walk from the most negative drift to the most positive
+			for (int i = kBucketCount - 1; i >= 0 && !found; i--)
+			{
+				seen += behindCounts[i];
+				if (seen >= rank)
+				{
+					value = -(int)GetBucketMidpoint(i);
+					found = true;
+				}
+			}
+			for (int i = 0; i < kBucketCount && !found; i++)
+			{
+				seen += aheadCounts[i];
+				if (seen >= rank)
+				{
+					value = (int)GetBucketMidpoint(i);
+					found = true;
+				}
+			}
+			// bucket midpoints may overshoot the observed range
+			if (value < stats.minDriftMs)
+			{
+				value = stats.minDriftMs;
+			}
+			if (value > stats.maxDriftMs)
+			{
+				value = stats.maxDriftMs;
+			}
+		}
+		*results[p] = value;
+	}
+}
+
+/**
+ * @brief Clear all counters and poll on every tick again
+ */
+void AVSyncMonitor::Reset()
+{
+	for (int i = 0; i < kBucketCount; i++)
+	{
+		ahead[i].store(0, std::memory_order_relaxed);
+		behind[i].store(0, std::memory_order_relaxed);
+	}
+	polls.store(0, std::memory_order_relaxed);
+	skippedPolls.store(0, std::memory_order_relaxed);
+	driftSamples.store(0, std::memory_order_relaxed);
+	outOfSyncSamples.store(0, std::memory_order_relaxed);
+	stalls.store(0, std::memory_order_relaxed);
+	videoFreezes.store(0, std::memory_order_relaxed);
+	audioDrops.store(0, std::memory_order_relaxed);
+	jumps.store(0, std::memory_order_relaxed);
+	stalledMs.store(0, std::memory_order_relaxed);
+	minDriftMs.store(0, std::memory_order_relaxed);
+	maxDriftMs.store(0, std::memory_order_relaxed);
+	lastDriftMs.store(0, std::memory_order_relaxed);
+	pollIntervalTicks.store(1, std::memory_order_relaxed);
+	ticksUntilPoll.store(0, std::memory_order_relaxed);
+	stableSamples.store(0, std::memory_order_relaxed);
+}
+
+/**
+ * @brief Extend the stream's queued range to the end of a buffer about to be pushed
+ */
+static void UpdateQueuedEnd(gst_media_stream *stream, GstBuffer *buffer)
+{
+	if (buffer && GST_BUFFER_PTS_IS_VALID(buffer))
+	{
+		GstClockTime end = GST_BUFFER_PTS(buffer);
+		if (GST_BUFFER_DURATION_IS_VALID(buffer))
+		{
+			end += GST_BUFFER_DURATION(buffer);
+		}
+		GstClockTime current = stream->queuedEndPts.load(std::memory_order_relaxed);
+		while ((current == GST_CLOCK_TIME_NONE || end > current) &&
+			   !stream->queuedEndPts.compare_exchange_weak(current, end, std::memory_order_relaxed))
+		{
+		}
+	}
+}
+
+/**
+ * @brief Push a buffer into the stream's appsrc and account it in the track telemetry
+ */
+static GstFlowReturn PushBufferWithStats(gst_media_stream *stream, GstBuffer *buffer)
+{
+	uint64_t len = gst_buffer_get_size(buffer);
+	UpdateQueuedEnd(stream, buffer);
+	gint64 startUs = g_get_monotonic_time();
+	GstFlowReturn ret = gst_app_src_push_buffer(GST_APP_SRC(stream->source), buffer);
+	gint64 endUs = g_get_monotonic_time();
+	stream->injectionStats.RecordPush(len, 1, startUs, endUs, ret == GST_FLOW_OK, gst_app_src_get_current_level_bytes(GST_APP_SRC(stream->source)));
+	return ret;
+}
+
+/**
+ * @brief Push a buffer list into the stream's appsrc and account it in the track telemetry
+ */
+static GstFlowReturn PushBufferListWithStats(gst_media_stream *stream, GstBufferList *bufferList)
+{
+	uint64_t len = gst_buffer_list_calculate_size(bufferList);
+	uint64_t count = gst_buffer_list_length(bufferList);
+	if (count > 0)
+	{
+		UpdateQueuedEnd(stream, gst_buffer_list_get(bufferList, (guint)count - 1));
+	}
+	gint64 startUs = g_get_monotonic_time();
+	GstFlowReturn ret = gst_app_src_push_buffer_list(GST_APP_SRC(stream->source), bufferList);
+	gint64 endUs = g_get_monotonic_time();
+	stream->injectionStats.RecordPush(len, count, startUs, endUs, ret == GST_FLOW_OK, gst_app_src_get_current_level_bytes(GST_APP_SRC(stream->source)));
+	return ret;
+}
+
+/**
+ * @struct ZeroCopyReleaseData
+ * @brief Tracks a caller owned fragment wrapped by SendHelperZeroCopy until GStreamer drops its last reference
+ */
+struct ZeroCopyReleaseData
+{
+	PlayerBufferReleaseCallback releaseCb;
+	void *ptr;
+	void *userData;
+	std::shared_ptr<std::atomic<int>> outstanding;
+
+	ZeroCopyReleaseData(PlayerBufferReleaseCallback cb, void *data, void *user, std::shared_ptr<std::atomic<int>> counter) :
+		releaseCb(cb), ptr(data), userData(user), outstanding(counter)
+	{
+		(*outstanding)++;
+	}
+
+	~ZeroCopyReleaseData()
+	{
+		(*outstanding)--;
+		releaseCb(ptr, userData);
+	}
+
+	ZeroCopyReleaseData(const ZeroCopyReleaseData &) = delete;
+	ZeroCopyReleaseData &operator=(const ZeroCopyReleaseData &) = delete;
+};
+
+/**
+ * @brief GDestroyNotify for wrapped caller owned memory; may run on any streaming thread
+ */
+static void ZeroCopyReleaseNotify(gpointer data)
+{
+	delete static_cast<ZeroCopyReleaseData *>(data);
+}
+
+/**
+ *  @brief Convert media timescale ticks to a clock time with exact integer scaling
+ */
+static inline GstClockTime TicksToClockTime(uint64_t ticks, uint32_t timescale)
+{
+	return gst_util_uint64_scale(ticks, GST_SECOND, timescale);
+}
+
+/**
+ *  @brief Clock times of a batch entry; tick fields take precedence when a timescale is set
+ */
+static void FragmentClockTimes(const PlayerFragmentDesc &fragment, GstClockTime &pts, GstClockTime &dts, GstClockTime &duration)
+{
+	if (fragment.timescale)
+	{
+		pts = TicksToClockTime(fragment.ptsTicks, fragment.timescale);
+		dts = TicksToClockTime(fragment.dtsTicks, fragment.timescale);
+		duration = TicksToClockTime(fragment.durationTicks, fragment.timescale);
+	}
+	else
+	{
+		pts = SecondsToClockTime(fragment.fpts);
+		dts = SecondsToClockTime(fragment.fdts);
+		duration = SecondsToClockTime(fragment.fDuration);
+	}
+}
+
+/**
+ *  @brief Inject stream buffer to gstreamer pipeline
+ */
+bool InterfacePlayerRDK::SendHelper(int type, const void *ptr, size_t len, double fpts, double fdts, double fDuration, double fragmentPTSoffset, bool copy, bool initFragment, bool &discontinuity, bool &notifyFirstBufferProcessed, bool &sendNewSegmentEvent, bool &resetTrickUTC, bool &firstBufferPushed)
+{
+	return SendHelperInternal(type, ptr, len, SecondsToClockTime(fpts), SecondsToClockTime(fdts), SecondsToClockTime(fDuration), fragmentPTSoffset, copy, nullptr, nullptr, initFragment, false, false, discontinuity, notifyFirstBufferProcessed, sendNewSegmentEvent, resetTrickUTC, firstBufferPushed);
+}
+
+/**
+ *  @brief Inject a fragment with timestamps in media timescale ticks
+ */
+bool InterfacePlayerRDK::SendHelperTicks(int type, const void *ptr, size_t len, uint64_t ptsTicks, uint64_t dtsTicks, uint64_t durationTicks, uint32_t timescale, double fragmentPTSoffset, bool copy, bool initFragment, bool &discontinuity, bool &notifyFirstBufferProcessed, bool &sendNewSegmentEvent, bool &resetTrickUTC, bool &firstBufferPushed)
+{
+	if (!timescale)
+	{
+		MW_LOG_ERR("mediaType[%d] invalid timescale 0, fragment dropped", type);
+		return false;
+	}
+	return SendHelperInternal(type, ptr, len, TicksToClockTime(ptsTicks, timescale), TicksToClockTime(dtsTicks, timescale), TicksToClockTime(durationTicks, timescale), fragmentPTSoffset, copy, nullptr, nullptr, initFragment, false, false, discontinuity, notifyFirstBufferProcessed, sendNewSegmentEvent, resetTrickUTC, firstBufferPushed);
+}
+
+/**
+ *  @brief Inject a partial byte range of a low latency segment
+ */
+bool InterfacePlayerRDK::SendHelperChunk(int type, const void *ptr, size_t len, double fpts, double fdts, double fDuration, double fragmentPTSoffset, bool copy, bool segmentStart, bool &discontinuity, bool &notifyFirstBufferProcessed, bool &sendNewSegmentEvent, bool &resetTrickUTC, bool &firstBufferPushed)
+{
+	return SendHelperInternal(type, ptr, len, SecondsToClockTime(fpts), SecondsToClockTime(fdts), SecondsToClockTime(fDuration), fragmentPTSoffset, copy, nullptr, nullptr, false, true, segmentStart, discontinuity, notifyFirstBufferProcessed, sendNewSegmentEvent, resetTrickUTC, firstBufferPushed);
+}
+
+/**
+ *  @brief Inject a partial byte range of a low latency segment with timestamps in media timescale ticks
+ */
+bool InterfacePlayerRDK::SendHelperChunkTicks(int type, const void *ptr, size_t len, uint64_t ptsTicks, uint64_t dtsTicks, uint64_t durationTicks, uint32_t timescale, double fragmentPTSoffset, bool copy, bool segmentStart, bool &discontinuity, bool &notifyFirstBufferProcessed, bool &sendNewSegmentEvent, bool &resetTrickUTC, bool &firstBufferPushed)
+{
+	if (!timescale)
+	{
+		MW_LOG_ERR("mediaType[%d] invalid timescale 0, chunk dropped", type);
+		return false;
+	}
+	return SendHelperInternal(type, ptr, len, TicksToClockTime(ptsTicks, timescale), TicksToClockTime(dtsTicks, timescale), TicksToClockTime(durationTicks, timescale), fragmentPTSoffset, copy, nullptr, nullptr, false, true, segmentStart, discontinuity, notifyFirstBufferProcessed, sendNewSegmentEvent, resetTrickUTC, firstBufferPushed);
+}
+
+/**
+ *  @brief Inject caller owned stream buffer to gstreamer pipeline without copying it
+ */
+bool InterfacePlayerRDK::SendHelperZeroCopy(int type, const void *ptr, size_t len, PlayerBufferReleaseCallback releaseCb, void *releaseData, double fpts, double fdts, double fDuration, double fragmentPTSoffset, bool initFragment, bool &discontinuity, bool &notifyFirstBufferProcessed, bool &sendNewSegmentEvent, bool &resetTrickUTC, bool &firstBufferPushed)
+{
+	if (!releaseCb)
+	{
+		MW_LOG_ERR("release callback missing for mediaType[%d], falling back to copy", type);
+		return SendHelperInternal(type, ptr, len, SecondsToClockTime(fpts), SecondsToClockTime(fdts), SecondsToClockTime(fDuration), fragmentPTSoffset, true, nullptr, nullptr, initFragment, false, false, discontinuity, notifyFirstBufferProcessed, sendNewSegmentEvent, resetTrickUTC, firstBufferPushed);
+	}
+	return SendHelperInternal(type, ptr, len, SecondsToClockTime(fpts), SecondsToClockTime(fdts), SecondsToClockTime(fDuration), fragmentPTSoffset, false, releaseCb, releaseData, initFragment, false, false, discontinuity, notifyFirstBufferProcessed, sendNewSegmentEvent, resetTrickUTC, firstBufferPushed);
+}
+
+/**
+ *  @brief Inject caller owned stream buffer without copying it, with timestamps in media timescale ticks
+ */
+bool InterfacePlayerRDK::SendHelperZeroCopyTicks(int type, const void *ptr, size_t len, PlayerBufferReleaseCallback releaseCb, void *releaseData, uint64_t ptsTicks, uint64_t dtsTicks, uint64_t durationTicks, uint32_t timescale, double fragmentPTSoffset, bool initFragment, bool &discontinuity, bool &notifyFirstBufferProcessed, bool &sendNewSegmentEvent, bool &resetTrickUTC, bool &firstBufferPushed)
+{
+	if (!timescale)
+	{
+		MW_LOG_ERR("mediaType[%d] invalid timescale 0, fragment dropped", type);
+		if (releaseCb)
+		{
+			releaseCb((void *)ptr, releaseData);
+		}
+		return false;
+	}
+	GstClockTime pts = TicksToClockTime(ptsTicks, timescale);
+	GstClockTime dts = TicksToClockTime(dtsTicks, timescale);
+	GstClockTime duration = TicksToClockTime(durationTicks, timescale);
+	if (!releaseCb)
+	{
+		MW_LOG_ERR("release callback missing for mediaType[%d], falling back to copy", type);
+		return SendHelperInternal(type, ptr, len, pts, dts, duration, fragmentPTSoffset, true, nullptr, nullptr, initFragment, false, false, discontinuity, notifyFirstBufferProcessed, sendNewSegmentEvent, resetTrickUTC, firstBufferPushed);
+	}
+	return SendHelperInternal(type, ptr, len, pts, dts, duration, fragmentPTSoffset, false, releaseCb, releaseData, initFragment, false, false, discontinuity, notifyFirstBufferProcessed, sendNewSegmentEvent, resetTrickUTC, firstBufferPushed);
+}
+
+/**
+ * @brief Create the GstBuffer carrying one fragment or sample
+ *
+ * copy allocates and fills a new buffer, releaseCb borrows caller owned memory and
+ * anything else transfers ownership of g_malloc'd memory to the buffer.
+ * @return the new buffer or NULL on failure; caller owned memory is released on failure
+ */
+static GstBuffer *CreateFragmentBuffer(const void *ptr, size_t len, bool copy, PlayerBufferReleaseCallback releaseCb, void *releaseData, const std::shared_ptr<std::atomic<int>> &outstanding, InjectionBufferPool *pool)
+{
+	GstBuffer *buffer = NULL;
+	if (copy)
+	{
+		if (pool)
+		{
+			buffer = pool->Acquire(len);
+		}
+		if (!buffer)
+		{
+			buffer = gst_buffer_new_and_alloc((guint)len);
+		}
+		if (buffer)
+		{
+			GstMapInfo map;
+			gst_buffer_map(buffer, &map, GST_MAP_WRITE);
+			memcpy(map.data, ptr, len);
+			gst_buffer_unmap(buffer, &map);
+		}
+	}
+	else if (releaseCb)
+	{ // borrow caller owned memory; released from ZeroCopyReleaseNotify once the last reference is dropped
+		ZeroCopyReleaseData *releaseInfo = new ZeroCopyReleaseData(releaseCb, (void *)ptr, releaseData, outstanding);
+		buffer = gst_buffer_new_wrapped_full(GST_MEMORY_FLAG_READONLY, (gpointer)ptr, (gsize)len, 0, (gsize)len, releaseInfo, ZeroCopyReleaseNotify);
+		if (!buffer)
+		{
+			delete releaseInfo;
+		}
+	}
+	else
+	{ // transfer
+		buffer = gst_buffer_new_wrapped((gpointer)ptr,(gsize)len);
+	}
+	return buffer;
+}
+
+/**
+ * @brief Log and classify a failed appsrc push
+ */
+static void HandlePushFailure(GstFlowReturn ret, GstMediaType mediaType, gst_media_stream *stream)
+{
+	MW_LOG_ERR("gst_app_src_push_buffer error: %d[%s] mediaType %d", ret, gst_flow_get_name (ret), (int)mediaType);
+	if (ret != GST_FLOW_EOS && ret !=  GST_FLOW_FLUSHING)
+	{ // an unexpected error has occurred
+		if (mediaType == eGST_MEDIATYPE_SUBTITLE)
+		{ // occurs sometimes when injecting subtitle fragments
+			if (!stream->source)
+			{
+				MW_LOG_ERR("subtitle appsrc is NULL");
+			}
+			else if (!GST_IS_APP_SRC(stream->source))
+			{
+				MW_LOG_ERR("subtitle appsrc is invalid");
+			}
+		}
+		else
+		{ // if we get here, something has gone terribly wrong
+			assert(0);
+		}
+	}
+}
+
+/**
+ *  @brief Send the gstreamer events due ahead of the first buffer after a new tune, seek or period change
+ */
+bool InterfacePlayerRDK::SendFirstBufferEvents(int type, GstClockTime pts, bool initFragment, bool sendNewSegmentEvent)
+{
+	GstMediaType mediaType = static_cast<GstMediaType>(type);
+	bool segmentEventSent = false;
+	int enableGstQuery = m_gstConfigParam->enableGstPosQuery;
+	interfacePlayerPriv->SendGstEvents((int)mediaType, pts, enableGstQuery, m_gstConfigParam->enablePTSReStamp, m_gstConfigParam->vodTrickModeFPS);
+
+	if (mediaType == eGST_MEDIATYPE_AUDIO && ForwardAudioBuffersToAux())
+	{
+		interfacePlayerPriv->SendGstEvents((int)eGST_MEDIATYPE_AUX_AUDIO, pts, enableGstQuery, m_gstConfigParam->enablePTSReStamp, m_gstConfigParam->vodTrickModeFPS);
+	}
+
+	// included to fix av sync / trickmode speed issues
+	// Also add check for trick-play on 1st frame.
+	if (interfacePlayerPriv->socInterface->IsPlatformSegmentReady() && sendNewSegmentEvent == true)
+	{
+		interfacePlayerPriv->SendNewSegmentEvent(mediaType, pts, 0);
+		segmentEventSent = true;
+	}
+	MW_LOG_DEBUG("mediaType[%d] SendGstEvents - first buffer received !!! initFragment: %d, pts: %" G_GUINT64_FORMAT, mediaType, initFragment, pts);
+	return segmentEventSent;
+}
+
+/**
+ *  @brief Common injection path; caller owned memory is released exactly once when releaseCb is set
+ */
+bool InterfacePlayerRDK::SendHelperInternal(int type, const void *ptr, size_t len, GstClockTime pts, GstClockTime dts, GstClockTime duration, double fragmentPTSoffset, bool copy, PlayerBufferReleaseCallback releaseCb, void *releaseData, bool initFragment, bool chunked, bool segmentStart, bool &discontinuity, bool &notifyFirstBufferProcessed, bool &sendNewSegmentEvent, bool &resetTrickUTC, bool &firstBufferPushed)
+{
+	GstMediaType mediaType = static_cast<GstMediaType>(type);
+	gst_media_stream *stream = &interfacePlayerPriv->gstPrivateContext->stream[mediaType];
+	if (eGST_MEDIATYPE_SUBTITLE == mediaType && discontinuity)
+	{
+		MW_LOG_WARN( "[%d] Discontinuity detected - setting subtitle clock to %" GST_TIME_FORMAT " dAR %d rP %d init %d sC %d",
+					mediaType,
+					GST_TIME_ARGS(pts),
+					!mPauseInjector,
+					stream->resetPosition,
+					initFragment,
+					stream->IsSourceConfigured() );
+		//gst_element_seek_simple(GST_ELEMENT(stream->source), GST_FORMAT_TIME, GST_SEEK_FLAG_NONE, pts);
+	}
+
+	bool segmentEventSent = false;
+	bool isFirstBuffer = stream->resetPosition;
+	// Steady state is lock free; only setup and teardown transitions take sourceLock
+	bool fastPath = stream->EnterConfiguredSource();
+	if (!fastPath)
+	{
+		// Make sure source element is present before data is injected
+		// If format is FORMAT_INVALID, we don't know what we are doing here
+		pthread_mutex_lock(&stream->sourceLock);
+	}
+
+	if (!fastPath && !stream->IsSourceConfigured() && stream->format != GST_FORMAT_INVALID)
+	{
+		gint64 waitStartUs = g_get_monotonic_time();
+		bool status = WaitForSourceSetup(type);
+		stream->injectionStats.RecordBlocked(g_get_monotonic_time() - waitStartUs);
+
+		if (mPauseInjector || !status)
+		{
+			LeaveSource(stream, fastPath);
+			if (releaseCb)
+			{
+				releaseCb((void *)ptr, releaseData);
+			}
+			return false;
+		}
+	}
+	if (isFirstBuffer)
+	{
+		//Send Gst Event when first buffer received after new tune, seek or period change
+		segmentEventSent = SendFirstBufferEvents(type, pts, initFragment, sendNewSegmentEvent);
+	}
+
+	sendNewSegmentEvent = segmentEventSent;
+	bool bPushBuffer = !mPauseInjector;
+	if(bPushBuffer)
+	{
 		// If pts restamp is enabled in config
 		// we need to set the pts offset used for subtitles else set it to 0
 		gint64 pts_offset;
@@ -2951,51 +4603,36 @@ bool InterfacePlayerRDK::SendHelper(int type, const void *ptr, size_t len, doubl
 			pts_offset = 0;
 		}
 
-		if(copy)
+		bool pooled = m_gstConfigParam->useBufferPool;
+#ifdef SUPPORTS_MP4DEMUX
+		// demuxed samples share the fragment's memory, so its buffer comes back to the pool non-writable
+		// and is discarded rather than recycled
+		pooled = pooled && !m_gstConfigParam->useMp4Demux;
+#endif
+		GstBuffer *buffer = CreateFragmentBuffer(ptr, len, copy, releaseCb, releaseData, stream->zeroCopyBuffersOutstanding, pooled ? &stream->bufferPool : nullptr);
+		if (buffer)
 		{
-			buffer = gst_buffer_new_and_alloc((guint)len);
+			GST_BUFFER_PTS(buffer) = pts;
+			GST_BUFFER_DTS(buffer) = dts;
+			GST_BUFFER_DURATION(buffer) = duration;
+			if (mediaType == eGST_MEDIATYPE_SUBTITLE)
+				GST_BUFFER_OFFSET(buffer) = pts_offset;
 
-			if (buffer)
+			if (copy)
 			{
-				GstMapInfo map;
-				gst_buffer_map(buffer, &map, GST_MAP_WRITE);
-				memcpy(map.data, ptr, len);
-				gst_buffer_unmap(buffer, &map);
-				GST_BUFFER_PTS(buffer) = pts;
-				GST_BUFFER_DTS(buffer) = dts;
-				GST_BUFFER_DURATION(buffer) = duration;
-				if (mediaType == eGST_MEDIATYPE_SUBTITLE)
-					GST_BUFFER_OFFSET(buffer) = pts_offset;
-
 				MW_LOG_DEBUG("Sending segment for mediaType[%d]. pts %" G_GUINT64_FORMAT " dts %" G_GUINT64_FORMAT, mediaType, pts, dts);
 				MW_LOG_DEBUG(" fragmentPTSoffset %" G_GINT64_FORMAT, pts_offset);
 			}
 			else
 			{
-				bPushBuffer = false;
-			}
-		}
-		else
-		{ // transfer
-			buffer = gst_buffer_new_wrapped((gpointer)ptr,(gsize)len);
-
-			if (buffer)
-			{
-				GST_BUFFER_PTS(buffer) = pts;
-				GST_BUFFER_DTS(buffer) = dts;
-				GST_BUFFER_DURATION(buffer) = duration;
-				if (mediaType == eGST_MEDIATYPE_SUBTITLE)
-					GST_BUFFER_OFFSET(buffer) = pts_offset;
-
 				MW_LOG_INFO("Sending segment for mediaType[%d]. pts %" G_GUINT64_FORMAT " dts %" G_GUINT64_FORMAT" len:%zu init:%d discontinuity:%d dur:%" G_GUINT64_FORMAT,
 							mediaType, pts, dts, len, initFragment, discontinuity,duration);
-
-			}
-			else
-			{
-				bPushBuffer = false;
 			}
 		}
+		else
+		{
+			bPushBuffer = false;
+		}
 
 		if (bPushBuffer)
 		{
@@ -3006,76 +4643,77 @@ bool InterfacePlayerRDK::SendHelper(int type, const void *ptr, size_t len, doubl
 #ifdef SUPPORTS_MP4DEMUX
 			if( m_gstConfigParam->useMp4Demux )
 			{
-				static uint32_t timescale[2]; // FIXME!
-				// some lldash streams don't have timescale in media segments
-				Mp4Demux *mp4Demux = new Mp4Demux(ptr,len,timescale[mediaType]);
-				int count = mp4Demux->count();
+				// context persists across fragments; some lldash streams don't have timescale in media segments
+				if( !stream->mp4Demux )
+				{
+					stream->mp4Demux = new Mp4Demux();
+				}
+				Mp4Demux *mp4Demux = stream->mp4Demux;
+				int count;
+				bool initHeader;
+				if( chunked )
+				{ // low latency chunk; samples are emitted as soon as their bytes have arrived
+					if( isFirstBuffer || segmentStart )
+					{ // drop whatever is left of an earlier segment cut short, e.g. by an ABR switch or aborted download
+						mp4Demux->ResetChunkParser();
+					}
+					count = mp4Demux->ParseChunk(ptr,len);
+					initHeader = mp4Demux->gotInitHeader();
+				}
+				else
+				{
+					mp4Demux->Parse(ptr,len);
+					count = mp4Demux->count();
+					initHeader = (count == 0);
+				}
+				if( initHeader )
+				{ // init header; caps are only renegotiated when they change
+					// with several pssh boxes, advertise the DRM system the application selected
+					mp4Demux->setPreferredProtectionSystem(mDrmSystem);
+					if( mp4Demux->setCaps( GST_APP_SRC(stream->source) ) )
+					{
+						MW_LOG_MIL("mediaType[%d] caps updated from init header, timescale %" PRIu32, mediaType, mp4Demux->timescale);
+						interfacePlayerPriv->gstPrivateContext->tuneTimeline.MarkTrack(mediaType, eTUNE_TRACK_CAPS_SET);
+					}
+				}
 				if( count>0 )
-				{ // media segment
+				{ // media segment; hand all samples over in a single push
+					GstBufferList *sampleList = gst_buffer_list_new_sized(count);
 					for( int i=0; i<count; i++ )
+					{ // samples share the memory of the fragment buffer, no per-sample allocation or copy
+						GstBuffer *gstBuffer = mp4Demux->getBuffer(buffer, i);
+						if( gstBuffer )
+						{
+							gst_buffer_list_add(sampleList, gstBuffer);
+						}
+						else
+						{
+							MW_LOG_WARN("mediaType[%d] sample %d outside fragment, dropped", mediaType, i);
+						}
+					}
+					GstFlowReturn ret = PushBufferListWithStats(stream, sampleList);
+					if( ret == GST_FLOW_OK )
 					{
-						size_t len = mp4Demux->getLen(i);
-						double pts = mp4Demux->getPts(i);
-						double dts = mp4Demux->getDts(i);
-						double dur = mp4Demux->getDuration(i);
-						gpointer data = g_malloc(len);
-						if( data )
+						stream->bufferUnderrun = false;
+						if( isFirstBuffer )
 						{
-							memcpy( data, mp4Demux->getPtr(i), len );
-							GstBuffer *gstBuffer = gst_buffer_new_wrapped( data, len);
-							GST_BUFFER_PTS(gstBuffer) = (GstClockTime)(pts * GST_SECOND);
-							GST_BUFFER_DTS(gstBuffer) = (GstClockTime)(dts * GST_SECOND);
-							GST_BUFFER_DURATION(gstBuffer) = (GstClockTime)(dur * 1000000000LL);
-							GstFlowReturn ret = gst_app_src_push_buffer(GST_APP_SRC(stream->source),gstBuffer);
-							if( ret == GST_FLOW_OK )
-							{
-								stream->bufferUnderrun = false;
-								if( isFirstBuffer )
-								{
-									firstBufferPushed = true;
-									stream->firstBufferProcessed = true;
-								}
-							}
+							firstBufferPushed = true;
+							interfacePlayerPriv->gstPrivateContext->tuneTimeline.MarkTrack(mediaType, eTUNE_TRACK_FIRST_BUFFER_PUSHED);
+							stream->firstBufferProcessed = true;
 						}
 					}
 				}
-				else
-				{ // init header
-					timescale[mediaType] = mp4Demux->timescale;
-					mp4Demux->setCaps( GST_APP_SRC(stream->source) );
-				}
-				delete mp4Demux;
-				if( !copy )
-				{
-					g_free((gpointer)ptr);
-				}
+				// sample sub-buffers hold their own references to the fragment memory
+				gst_buffer_unref(buffer);
 			}
 			else
 #endif // SUPPORTS_MP4DEMUX
 			{
-				GstFlowReturn ret = gst_app_src_push_buffer(GST_APP_SRC(stream->source), buffer);
+				GstFlowReturn ret = PushBufferWithStats(stream, buffer);
 				
 				if (ret != GST_FLOW_OK)
 				{
-					MW_LOG_ERR("gst_app_src_push_buffer error: %d[%s] mediaType %d", ret, gst_flow_get_name (ret), (int)mediaType);
-					if (ret != GST_FLOW_EOS && ret !=  GST_FLOW_FLUSHING)
-					{ // an unexpected error has occurred
-						if (mediaType == eGST_MEDIATYPE_SUBTITLE)
-						{ // occurs sometimes when injecting subtitle fragments
-							if (!stream->source)
-							{
-								MW_LOG_ERR("subtitle appsrc is NULL");
-							}
-							else if (!GST_IS_APP_SRC(stream->source))
-							{
-								MW_LOG_ERR("subtitle appsrc is invalid");
-							}
-						}
-						else
-						{ // if we get here, something has gone terribly wrong
-							assert(0);
-						}
-					}
+					HandlePushFailure(ret, mediaType, stream);
 				}
 				else if (stream->bufferUnderrun)
 				{
@@ -3084,7 +4722,10 @@ bool InterfacePlayerRDK::SendHelper(int type, const void *ptr, size_t len, doubl
 				
 				// PROFILE_BUCKET_FIRST_BUFFER after successful push of first gst buffer
 				if (isFirstBuffer == true && ret == GST_FLOW_OK)
+				{
 					firstBufferPushed = true;
+					interfacePlayerPriv->gstPrivateContext->tuneTimeline.MarkTrack(mediaType, eTUNE_TRACK_FIRST_BUFFER_PUSHED);
+				}
 				if (!stream->firstBufferProcessed && !initFragment)
 				{
 					stream->firstBufferProcessed = true;
@@ -3092,8 +4733,12 @@ bool InterfacePlayerRDK::SendHelper(int type, const void *ptr, size_t len, doubl
 			}
 		}
 	}
+	else if (releaseCb)
+	{ // injector paused, nothing wrapped yet; hand the memory straight back
+		releaseCb((void *)ptr, releaseData);
+	}
 	discontinuity = isFirstBuffer || discontinuity;
-	pthread_mutex_unlock(&stream->sourceLock);
+	LeaveSource(stream, fastPath);
 	if (isFirstBuffer)
 	{
 		if(!interfacePlayerPriv->gstPrivateContext->using_westerossink)
@@ -3109,6 +4754,125 @@ bool InterfacePlayerRDK::SendHelper(int type, const void *ptr, size_t len, doubl
 	return bPushBuffer;
 }
 
+/**
+ *  @brief Inject a batch of media fragments or samples with a single appsrc push
+ */
+bool InterfacePlayerRDK::SendHelperBatch(int type, const std::vector<PlayerFragmentDesc> &fragments, double fragmentPTSoffset, bool copy, bool &discontinuity, bool &notifyFirstBufferProcessed, bool &sendNewSegmentEvent, bool &resetTrickUTC, bool &firstBufferPushed)
+{
+	GstMediaType mediaType = static_cast<GstMediaType>(type);
+	gst_media_stream *stream = &interfacePlayerPriv->gstPrivateContext->stream[mediaType];
+	if (fragments.empty())
+	{
+		return false;
+	}
+	GstClockTime firstPts, firstDts, firstDuration;
+	FragmentClockTimes(fragments.front(), firstPts, firstDts, firstDuration);
+
+	bool segmentEventSent = false;
+	bool isFirstBuffer = stream->resetPosition;
+	bool fastPath = stream->EnterConfiguredSource();
+	if (!fastPath)
+	{
+		pthread_mutex_lock(&stream->sourceLock);
+	}
+
+	bool bPushBuffer = true;
+	if (!fastPath && !stream->IsSourceConfigured() && stream->format != GST_FORMAT_INVALID)
+	{
+		gint64 waitStartUs = g_get_monotonic_time();
+		bPushBuffer = WaitForSourceSetup(type);
+		stream->injectionStats.RecordBlocked(g_get_monotonic_time() - waitStartUs);
+	}
+	bPushBuffer = bPushBuffer && !mPauseInjector;
+	if (!bPushBuffer)
+	{
+		LeaveSource(stream, fastPath);
+		for (const auto &fragment : fragments)
+		{
+			if (!copy && fragment.releaseCb)
+			{
+				fragment.releaseCb((void *)fragment.ptr, fragment.releaseData);
+			}
+		}
+		return false;
+	}
+	if (isFirstBuffer)
+	{
+		//Send Gst Event when first buffer received after new tune, seek or period change
+		segmentEventSent = SendFirstBufferEvents(type, firstPts, false, sendNewSegmentEvent);
+	}
+	sendNewSegmentEvent = segmentEventSent;
+
+	gint64 pts_offset = 0;
+	if (m_gstConfigParam->enablePTSReStamp)
+	{
+		pts_offset = -(gint64)(fragmentPTSoffset * 1000L);
+	}
+	bool forwardToAux = (mediaType == eGST_MEDIATYPE_AUDIO && ForwardAudioBuffersToAux());
+	InjectionBufferPool *bufferPool = m_gstConfigParam->useBufferPool ? &stream->bufferPool : nullptr;
+	GstBufferList *bufferList = gst_buffer_list_new_sized((guint)fragments.size());
+	for (const auto &fragment : fragments)
+	{
+		GstBuffer *buffer = CreateFragmentBuffer(fragment.ptr, fragment.len, copy, copy ? nullptr : fragment.releaseCb, fragment.releaseData, stream->zeroCopyBuffersOutstanding, bufferPool);
+		if (buffer)
+		{
+			FragmentClockTimes(fragment, GST_BUFFER_PTS(buffer), GST_BUFFER_DTS(buffer), GST_BUFFER_DURATION(buffer));
+			if (mediaType == eGST_MEDIATYPE_SUBTITLE)
+				GST_BUFFER_OFFSET(buffer) = pts_offset;
+			if (forwardToAux)
+			{
+				interfacePlayerPriv->ForwardBuffersToAuxPipeline(buffer, mPauseInjector, this);
+			}
+			gst_buffer_list_add(bufferList, buffer);
+		}
+	}
+	guint count = gst_buffer_list_length(bufferList);
+	MW_LOG_INFO("Sending %u buffers for mediaType[%d]. first pts %" G_GUINT64_FORMAT " discontinuity:%d", count, mediaType, firstPts, discontinuity);
+
+	GstFlowReturn ret = GST_FLOW_ERROR;
+	if (count > 0)
+	{
+		ret = PushBufferListWithStats(stream, bufferList);
+	}
+	else
+	{
+		gst_buffer_list_unref(bufferList);
+	}
+	if (count == 0)
+	{
+		MW_LOG_WARN("No buffers created for mediaType[%d]", mediaType);
+	}
+	else if (ret != GST_FLOW_OK)
+	{
+		HandlePushFailure(ret, mediaType, stream);
+	}
+	else
+	{
+		stream->bufferUnderrun = false;
+		if (isFirstBuffer)
+		{
+			firstBufferPushed = true;
+			interfacePlayerPriv->gstPrivateContext->tuneTimeline.MarkTrack(mediaType, eTUNE_TRACK_FIRST_BUFFER_PUSHED);
+		}
+		stream->firstBufferProcessed = true;
+	}
+	discontinuity = isFirstBuffer || discontinuity;
+	LeaveSource(stream, fastPath);
+	if (isFirstBuffer)
+	{
+		if(!interfacePlayerPriv->gstPrivateContext->using_westerossink)
+		{
+			notifyFirstBufferProcessed = true;
+		}
+		resetTrickUTC = interfacePlayerPriv->socInterface->ResetTrickUTC();
+	}
+	if (eGST_MEDIATYPE_VIDEO == mediaType)
+	{
+		interfacePlayerPriv->gstPrivateContext->numberOfVideoBuffersSent += count;
+	}
+	return (count > 0);
+}
+
 void InterfacePlayerRDK::PauseInjector()
 {
 	std::unique_lock<std::mutex> lock(mSourceSetupMutex);
@@ -3249,6 +5013,7 @@ static GstState validateStateWithMsTimeout( InterfacePlayerRDK *pInterfacePlayer
 bool InterfacePlayerRDK::Pause(bool pause , bool forceStopGstreamerPreBuffering)
 {
 	bool retValue = true;
+	interfacePlayerPriv->gstPrivateContext->positionClock.Invalidate();
 	if (interfacePlayerPriv->gstPrivateContext->pipeline != NULL)
 	{
 		GstState nextState = pause ? GST_STATE_PAUSED : GST_STATE_PLAYING;
@@ -3391,7 +5156,7 @@ bool InterfacePlayerRDK::PipelineConfiguredForMedia(int type)
 	gst_media_stream *stream = &interfacePlayerPriv->gstPrivateContext->stream[type];
 	if (stream)
 	{
-		pipelineConfigured = stream->sourceConfigured;
+		pipelineConfigured = stream->IsSourceConfigured();
 	}
 	return pipelineConfigured;
 }
@@ -3419,13 +5184,112 @@ bool InterfacePlayerRDK::GetBufferControlData(int iMediaType)
 	}
 	return GstWaitingForData;
 }
+
+/**
+ * @brief Get a snapshot of the injection counters of a track
+ */
+bool InterfacePlayerRDK::GetInjectionStats(int mediaType, PlayerInjectionStats &stats)
+{
+	if (mediaType < 0 || mediaType >= GST_TRACK_COUNT)
+	{
+		MW_LOG_WARN("Invalid mediaType %d", mediaType);
+		return false;
+	}
+	interfacePlayerPriv->gstPrivateContext->stream[mediaType].injectionStats.Snapshot(stats);
+	return true;
+}
+
+/**
+ * @brief Get the milestones of the current tune
+ */
+void InterfacePlayerRDK::GetTuneTimeline(PlayerTuneTimeline &timeline)
+{
+	interfacePlayerPriv->gstPrivateContext->tuneTimeline.Snapshot(timeline);
+}
+
+/**
+ * @brief Get the milestones of the current tune as JSON
+ */
+std::string InterfacePlayerRDK::GetTuneTimelineJson()
+{
+	PlayerTuneTimeline timeline;
+	GetTuneTimeline(timeline);
+	PlayerJsonObject json;
+	PlayerJsonObject milestones;
+	PlayerJsonObject tracks;
+	json.add("start_us", (double)timeline.startUs);
+	for (int i = 0; i < eTUNE_MILESTONE_COUNT; i++)
+	{
+		if (timeline.milestoneUs[i] >= 0)
+		{
+			milestones.add(TuneTimelineRecorder::GetMilestoneName((PlayerTuneMilestone)i), (double)timeline.milestoneUs[i]);
+		}
+	}
+	json.add("milestones", milestones);
+	for (int track = 0; track < PlayerTuneTimeline::kTrackCount; track++)
+	{
+		PlayerJsonObject entries;
+		bool reached = false;
+		for (int i = 0; i < eTUNE_TRACK_MILESTONE_COUNT; i++)
+		{
+			if (timeline.trackMilestoneUs[track][i] >= 0)
+			{
+				entries.add(TuneTimelineRecorder::GetTrackMilestoneName((PlayerTuneTrackMilestone)i), (double)timeline.trackMilestoneUs[track][i]);
+				reached = true;
+			}
+		}
+		if (reached)
+		{
+			tracks.add(gstGetMediaTypeName((GstMediaType)track), entries);
+		}
+	}
+	json.add("tracks", tracks);
+	return json.print_UnFormatted();
+}
+
+/**
+ * @brief Discard the current tune timeline
+ */
+void InterfacePlayerRDK::ResetTuneTimeline()
+{
+	interfacePlayerPriv->gstPrivateContext->tuneTimeline.Reset();
+}
+
+/**
+ * @brief Clear the injection counters of a track
+ */
+void InterfacePlayerRDK::ResetInjectionStats(int mediaType)
+{
+	if (mediaType >= 0 && mediaType < GST_TRACK_COUNT)
+	{
+		interfacePlayerPriv->gstPrivateContext->stream[mediaType].injectionStats.Reset();
+	}
+}
+
+/**
+ * @brief Get a snapshot of the A/V sync monitor
+ */
+bool InterfacePlayerRDK::GetAVSyncStats(PlayerAVSyncStats &stats)
+{
+	interfacePlayerPriv->gstPrivateContext->avSyncMonitor.Snapshot(stats);
+	return m_gstConfigParam->monitorAV;
+}
+
+/**
+ * @brief Clear the A/V sync monitor
+ */
+void InterfacePlayerRDK::ResetAVSyncStats()
+{
+	interfacePlayerPriv->gstPrivateContext->avSyncMonitor.Reset();
+}
+
 bool InterfacePlayerRDK::IsStreamReady(int mediaType)
 {
 	bool StreamReady = false;
 
 	const gst_media_stream *stream = &interfacePlayerPriv->gstPrivateContext->stream[mediaType];
 
-	StreamReady = stream->sinkbin && stream->sourceConfigured;
+	StreamReady = stream->sinkbin && stream->IsSourceConfigured();
 	return StreamReady;
 }
 /**
@@ -3517,7 +5381,7 @@ void InterfacePlayerRDK::TimerAdd(GSourceFunc funcPtr, int repeatTimeout, guint&
 		if (0 == taskId)
 		{
 			/* Sets the function pointed by functPtr to be called at regular intervals of repeatTimeout, supplying user_data to the function */
-			taskId = g_timeout_add(repeatTimeout, funcPtr, user_data);
+			taskId = interfacePlayerPriv->gstPrivateContext->mainLoopThread.AddTimeout(G_PRIORITY_DEFAULT, repeatTimeout, funcPtr, user_data);
 			MW_LOG_INFO("InterfacePlayerRDK: Added timer '%.50s', %d", (nullptr!=timerName) ? timerName : "unknown" , taskId);
 		}
 		else
@@ -3614,10 +5478,12 @@ void InterfacePlayerRDK::NotifyFirstFrame(int mediaType)
 	bool notifyFirstBuffer = false;
 	bool audioOnly = false;
 	bool requireFirstVideoFrameDisplay = false;
+	interfacePlayerPriv->gstPrivateContext->tuneTimeline.MarkTrack(mediaType, eTUNE_TRACK_FIRST_FRAME_DECODED);
 	if (!interfacePlayerPriv->gstPrivateContext->firstFrameReceived && (interfacePlayerPriv->gstPrivateContext->firstVideoFrameReceived
 												   || (1 == interfacePlayerPriv->gstPrivateContext->NumberOfTracks && (interfacePlayerPriv->gstPrivateContext->firstAudioFrameReceived || interfacePlayerPriv->gstPrivateContext->firstVideoFrameReceived))))
 	{
 		interfacePlayerPriv->gstPrivateContext->firstFrameReceived = true;
+		interfacePlayerPriv->gstPrivateContext->tuneTimeline.Mark(eTUNE_MILESTONE_FIRST_FRAME);
 		notifyFirstBuffer = true;
 		PlayerLogManager::setLogLevel(mLOGLEVEL_WARN);				//Align with player LogTuneComplete once the first frame starts, required for prod builds
 	}
@@ -3836,11 +5702,16 @@ bool InterfacePlayerRDK::CreatePipeline(const char *pipelineName, int PipelinePr
 		if(PipelinePriority >= 0)
 		{
 			interfacePlayerPriv->gstPrivateContext->task_pool =  (GstTaskPool*)g_object_new (GST_TYPE_PLAYER_TASKPOOL, NULL);
+			ConfigureTaskPool();
 		}
 		if(interfacePlayerPriv->gstPrivateContext->bus)
 		{
 			interfacePlayerPriv->gstPrivateContext->aSyncControl.enable();
-			guint busWatchId = gst_bus_add_watch(interfacePlayerPriv->gstPrivateContext->bus, (GstBusFunc) bus_message, this);
+			if (m_gstConfigParam->dedicatedMainContext)
+			{
+				interfacePlayerPriv->gstPrivateContext->mainLoopThread.Start();
+			}
+			guint busWatchId = interfacePlayerPriv->gstPrivateContext->mainLoopThread.AddBusWatch(interfacePlayerPriv->gstPrivateContext->bus, (GstBusFunc) bus_message, this);
 			(void)busWatchId;
 			interfacePlayerPriv->gstPrivateContext->syncControl.enable();
 			gst_bus_set_sync_handler(interfacePlayerPriv->gstPrivateContext->bus, (GstBusSyncHandler) bus_sync_handler, this, NULL);
@@ -3858,6 +5729,7 @@ bool InterfacePlayerRDK::CreatePipeline(const char *pipelineName, int PipelinePr
 			}
 			/* Use to enable the timing synchronization with gstreamer */
 			interfacePlayerPriv->gstPrivateContext->enableSEITimeCode = m_gstConfigParam->seiTimeCode;
+			interfacePlayerPriv->gstPrivateContext->tuneTimeline.Mark(eTUNE_MILESTONE_PIPELINE_CREATED);
 			ret = true;
 		}
 		else
@@ -3872,6 +5744,75 @@ bool InterfacePlayerRDK::CreatePipeline(const char *pipelineName, int PipelinePr
 	return ret;
 }
 
+/**
+ * @brief Pass the scheduling configured per PlayerTaskClass on to the pipeline's task pool
+ */
+void InterfacePlayerRDK::ConfigureTaskPool()
+{
+	GstPlayerTaskpool *pool = GST_PLAYER_TASKPOOL(interfacePlayerPriv->gstPrivateContext->task_pool);
+	if (!pool)
+	{
+		return;
+	}
+	gst_player_taskpool_set_max_idle_threads(this, m_gstConfigParam->taskPoolMaxIdleThreads > 0 ? (guint)m_gstConfigParam->taskPoolMaxIdleThreads : 0);
+	for (int i = 0; i < ePLAYER_TASK_CLASS_COUNT; i++)
+	{
+		const PlayerTaskSchedConfig &config = m_gstConfigParam->taskSched[i];
+		GstPlayerTaskpoolSched sched;
+		switch (config.policy)
+		{
+			case ePLAYER_TASK_SCHED_OTHER:
+				sched.policy = SCHED_OTHER;
+				break;
+			case ePLAYER_TASK_SCHED_FIFO:
+				sched.policy = SCHED_FIFO;
+				break;
+			case ePLAYER_TASK_SCHED_RR:
+				sched.policy = SCHED_RR;
+				break;
+			default:
+				sched.policy = GST_PLAYER_TASKPOOL_SCHED_INHERIT;
+				break;
+		}
+		sched.priority = config.priority;
+		sched.nice = config.nice;
+		sched.cpu_mask = config.cpuMask;
+		gst_player_taskpool_set_sched(pool, (guint)i, &sched);
+		if (sched.policy != GST_PLAYER_TASKPOOL_SCHED_INHERIT || sched.cpu_mask)
+		{
+			MW_LOG_MIL("Task class %d: policy %d priority %d nice %d cpus 0x%" PRIx64, i, sched.policy, sched.priority, sched.nice, (uint64_t)sched.cpu_mask);
+		}
+	}
+}
+
+/**
+ * @brief Map the element owning a streaming task to its PlayerTaskClass by the playbin it sits in
+ */
+static int GstPlayer_GetTaskClass(GstElement *owner, InterfacePlayerRDK *pInterfacePlayerRDK)
+{
+	InterfacePlayerPriv* privatePlayer = pInterfacePlayerRDK->GetPrivatePlayer();
+	for (GstElement *element = owner; element; element = GST_ELEMENT_PARENT(element))
+	{
+		for (int i = 0; i < GST_TRACK_COUNT; i++)
+		{
+			if (element == privatePlayer->gstPrivateContext->stream[i].sinkbin)
+			{
+				switch (i)
+				{
+					case eGST_MEDIATYPE_VIDEO:
+						return ePLAYER_TASK_CLASS_VIDEO;
+					case eGST_MEDIATYPE_AUDIO:
+					case eGST_MEDIATYPE_AUX_AUDIO:
+						return ePLAYER_TASK_CLASS_AUDIO;
+					default:
+						return ePLAYER_TASK_CLASS_DEFAULT;
+				}
+			}
+		}
+	}
+	return ePLAYER_TASK_CLASS_DEFAULT;
+}
+
 /**
  *  @brief Gets Video PTS
  */
@@ -3919,6 +5860,90 @@ bool GstPlayer_isAudioSinkOrAudioDecoder(const char* name, InterfacePlayerRDK *
 	return privatePlayer->socInterface->IsAudioSinkOrAudioDecoder(name, isRialto);
 }
 
+/**
+ * @brief Get the GstElementRole bits of an element, classifying it by name on first use
+ *
+ * The result is stored as qdata on the element, so later lookups for the same element (every bus
+ * message it posts, every callback it raises) skip the SocInterface name matching. Elements are
+ * classified as playbin sets them up (element_setup_cb) or, failing that, on their first message.
+ * Element names are fixed once an element is in a bin, so the tag stays valid for its lifetime.
+ * @param[in] object element to classify
+ * @param[in] pInterfacePlayerRDK pointer to InterfacePlayerRDK instance
+ * @retval GstElementRole bits, 0 for a NULL object
+ */
+guint GstPlayer_GetElementRoles(GstObject *object, InterfacePlayerRDK *pInterfacePlayerRDK)
+{
+	static const GQuark rolesQuark = g_quark_from_static_string("player-element-roles");
+	if (!object)
+	{
+		return 0;
+	}
+	InterfacePlayerPriv* privatePlayer = pInterfacePlayerRDK->GetPrivatePlayer();
+	guint key = ELEMENT_ROLE_CLASSIFIED;
+	if (privatePlayer->gstPrivateContext->usingRialtoSink)
+	{
+		key |= ELEMENT_ROLE_KEY_RIALTO;
+	}
+	if (privatePlayer->gstPrivateContext->using_westerossink)
+	{
+		key |= ELEMENT_ROLE_KEY_WESTEROS;
+	}
+	guint roles = GPOINTER_TO_UINT(g_object_get_qdata(G_OBJECT(object), rolesQuark));
+	if ((roles & ELEMENT_ROLE_KEY_MASK) == key)
+	{
+		return roles;
+	}
+
+	const char *name = GST_OBJECT_NAME(object);
+	roles = key;
+	if (name)
+	{
+		if (GstPlayer_isVideoSink(name, pInterfacePlayerRDK))
+		{
+			roles |= ELEMENT_ROLE_VIDEO_SINK;
+		}
+		if (GstPlayer_isVideoDecoder(name, pInterfacePlayerRDK))
+		{
+			roles |= ELEMENT_ROLE_VIDEO_DECODER;
+		}
+		if (GstPlayer_isVideoOrAudioDecoder(name, pInterfacePlayerRDK))
+		{
+			roles |= ELEMENT_ROLE_AV_DECODER;
+		}
+		if (GstPlayer_isAudioSinkOrAudioDecoder(name, pInterfacePlayerRDK))
+		{
+			roles |= ELEMENT_ROLE_AUDIO_SINK_OR_DECODER;
+		}
+		if (gst_StartsWith(name, "playbin"))
+		{
+			roles |= ELEMENT_ROLE_PLAYBIN;
+		}
+		if (gst_StartsWith(name, "source"))
+		{
+			roles |= ELEMENT_ROLE_PLAYBIN_SOURCE;
+		}
+		if (gst_StartsWith(name, "rialtomsevideosink"))
+		{
+			roles |= ELEMENT_ROLE_RIALTO_VIDEO_SINK;
+		}
+		if (gst_StartsWith(name, "rialtomseaudiosink"))
+		{
+			roles |= ELEMENT_ROLE_RIALTO_AUDIO_SINK;
+		}
+		if (gst_StartsWith(name, "rtkaudiosink"))
+		{
+			roles |= ELEMENT_ROLE_RTK_AUDIO_SINK;
+		}
+		if (gst_StartsWith(name, GstPluginNamePR) || gst_StartsWith(name, GstPluginNameWV) ||
+			gst_StartsWith(name, GstPluginNameCK) || gst_StartsWith(name, GstPluginNameVMX))
+		{
+			roles |= ELEMENT_ROLE_DECRYPTOR;
+		}
+	}
+	g_object_set_qdata(G_OBJECT(object), rolesQuark, GUINT_TO_POINTER(roles));
+	return roles;
+}
+
 
 /**
  * @brief Callback invoked when facing an underflow
@@ -3941,21 +5966,22 @@ static void GstPlayer_OnGstBufferUnderflowCb(GstElement* object, guint arg0, gpo
 		//TODO - Handle underflow
 		GstMediaType type = eGST_MEDIATYPE_DEFAULT;  //CID:89173 - Resolve Uninit
 		bool isVideo = false;
+		guint roles = GstPlayer_GetElementRoles(GST_OBJECT(object), pInterfacePlayerRDK);
 
 		if (privatePlayer->socInterface->IsVideoSinkHandleErrors())
 		{
-			isVideo = GstPlayer_isVideoSink(GST_ELEMENT_NAME(object), pInterfacePlayerRDK);
+			isVideo = (roles & ELEMENT_ROLE_VIDEO_SINK);
 		}
 		else
 		{
-			isVideo = GstPlayer_isVideoDecoder(GST_ELEMENT_NAME(object), pInterfacePlayerRDK);
+			isVideo = (roles & ELEMENT_ROLE_VIDEO_DECODER);
 		}
 
 		if (isVideo)
 		{
 			type = eGST_MEDIATYPE_VIDEO;
 		}
-		else if (GstPlayer_isAudioSinkOrAudioDecoder(GST_ELEMENT_NAME(object), pInterfacePlayerRDK))
+		else if (roles & ELEMENT_ROLE_AUDIO_SINK_OR_DECODER)
 		{
 			type = eGST_MEDIATYPE_AUDIO;
 		}
@@ -3974,8 +6000,8 @@ static void GstPlayer_OnGstBufferUnderflowCb(GstElement* object, guint arg0, gpo
 			{
 				privatePlayer->gstPrivateContext->lastKnownPTS = pInterfacePlayerRDK->GetVideoPTS();			/* Gets the currentPTS from the 'video-pts' property of the element */
 				privatePlayer->gstPrivateContext->ptsUpdatedTimeMS = NOW_STEADY_TS_MS;
-				privatePlayer->gstPrivateContext->ptsCheckForEosOnUnderflowIdleTaskId = g_timeout_add(GST_DELAY_BETWEEN_PTS_CHECK_FOR_EOS_ON_UNDERFLOW, VideoDecoderPtsCheckerForEOS, pInterfacePlayerRDK);
-				/*g_timeout_add - Sets the function VideoDecoderPtsCheckerForEOS to be called at regular intervals*/
+				privatePlayer->gstPrivateContext->ptsCheckForEosOnUnderflowIdleTaskId = privatePlayer->gstPrivateContext->mainLoopThread.AddTimeout(G_PRIORITY_DEFAULT, GST_DELAY_BETWEEN_PTS_CHECK_FOR_EOS_ON_UNDERFLOW, VideoDecoderPtsCheckerForEOS, pInterfacePlayerRDK);
+				/*AddTimeout - Sets the function VideoDecoderPtsCheckerForEOS to be called at regular intervals*/
 			}
 			else
 			{
@@ -4014,15 +6040,16 @@ static void GstPlayer_OnGstPtsErrorCb(GstElement *object, guint arg0, gpointer a
 	HANDLER_CONTROL_HELPER_CALLBACK_VOID();
 	bool isVideo = false;
 	bool isAudioSink = false;
+	guint roles = GstPlayer_GetElementRoles(GST_OBJECT(object), pInterfacePlayerRDK);
 	if (privatePlayer->socInterface->IsVideoSinkHandleErrors())
 	{
-		isVideo = GstPlayer_isVideoSink(GST_ELEMENT_NAME(object), pInterfacePlayerRDK);
+		isVideo = (roles & ELEMENT_ROLE_VIDEO_SINK);
 	}
 	else
 	{
-		isVideo = GstPlayer_isVideoDecoder(GST_ELEMENT_NAME(object), pInterfacePlayerRDK);
+		isVideo = (roles & ELEMENT_ROLE_VIDEO_DECODER);
 	}
-	if (GstPlayer_isAudioSinkOrAudioDecoder(GST_ELEMENT_NAME(object), pInterfacePlayerRDK))
+	if (roles & ELEMENT_ROLE_AUDIO_SINK_OR_DECODER)
 	{
 		isAudioSink = true;
 	}
@@ -4121,11 +6148,16 @@ static gboolean bus_message(GstBus * bus, GstMessage * msg, InterfacePlayerRDK *
 			gst_message_parse_state_changed(msg, &old_state, &new_state, &pending_state);
 			isPlaybinStateChangeEvent = (GST_MESSAGE_SRC(msg) == GST_OBJECT(privatePlayer->gstPrivateContext->pipeline));
 			const gchar *srcName = GST_OBJECT_NAME(msg->src);
+			guint srcRoles = GstPlayer_GetElementRoles(msg->src, pInterfacePlayerRDK);
 
 			busEvent.msg = srcName ? srcName : "Unknown source";
 			busEvent.dbg_info = "N/A";
 			busEvent.msgType = MESSAGE_STATE_CHANGE;
 
+			if(isPlaybinStateChangeEvent && new_state == GST_STATE_PAUSED)
+			{
+				privatePlayer->gstPrivateContext->tuneTimeline.Mark(eTUNE_MILESTONE_PAUSED);
+			}
 			if(isPlaybinStateChangeEvent || pInterfacePlayerRDK->m_gstConfigParam->gstLogging)
 			{
 				MW_LOG_MIL("%s %s -> %s (pending %s)",
@@ -4166,6 +6198,7 @@ static gboolean bus_message(GstBus * bus, GstMessage * msg, InterfacePlayerRDK *
 				}
 				if(isPlaybinStateChangeEvent && new_state == GST_STATE_PLAYING)
 				{
+					privatePlayer->gstPrivateContext->tuneTimeline.Mark(eTUNE_MILESTONE_PLAYING);
 					privatePlayer->gstPrivateContext->pauseOnStartPlayback = false;
 
 					busEvent.setPlaybackRate = privatePlayer->socInterface->SetPlatformPlaybackRate();
@@ -4205,6 +6238,7 @@ static gboolean bus_message(GstBus * bus, GstMessage * msg, InterfacePlayerRDK *
 						if(!privatePlayer->gstPrivateContext->firstFrameReceived)
 						{
 							privatePlayer->gstPrivateContext->firstFrameReceived = true;
+							privatePlayer->gstPrivateContext->tuneTimeline.Mark(eTUNE_MILESTONE_FIRST_FRAME);
 							busEvent.receivedFirstFrame = true;
 						}
 						pInterfacePlayerRDK->TriggerEvent(InterfaceCB::firstVideoFrameReceived);
@@ -4230,11 +6264,11 @@ static gboolean bus_message(GstBus * bus, GstMessage * msg, InterfacePlayerRDK *
 				}
 			}
 			//this code should be handled as part of IARM modification
-			if ((NULL != msg->src) && GstPlayer_isVideoOrAudioDecoder(GST_OBJECT_NAME(msg->src), pInterfacePlayerRDK))
+			if (srcRoles & ELEMENT_ROLE_AV_DECODER)
 			{
 				// This is the video decoder, send this to the output protection module
 				// so it can get the source width/height
-				if (GstPlayer_isVideoDecoder(GST_OBJECT_NAME(msg->src), pInterfacePlayerRDK))
+				if (srcRoles & ELEMENT_ROLE_VIDEO_DECODER)
 				{
 					if(PlayerExternalsInterface::IsPlayerExternalsInterfaceInstanceActive())
 					{
@@ -4247,7 +6281,7 @@ static gboolean bus_message(GstBus * bus, GstMessage * msg, InterfacePlayerRDK *
 			{
 				if((old_state == GST_STATE_NULL && new_state == GST_STATE_READY))
 				{
-					if(gst_StartsWith(GST_OBJECT_NAME(msg->src), "source"))
+					if(srcRoles & ELEMENT_ROLE_PLAYBIN_SOURCE)
 					{
 						GstPad* sourceEleSrcPad = privatePlayer->socInterface->GetSourcePad(GST_ELEMENT(msg->src));
 						if(sourceEleSrcPad)
@@ -4264,7 +6298,7 @@ static gboolean bus_message(GstBus * bus, GstMessage * msg, InterfacePlayerRDK *
 				}
 
 			}
-			if((NULL != msg->src) && ((privatePlayer->socInterface->IsVideoSinkHandleErrors() && GstPlayer_isVideoSink(GST_OBJECT_NAME(msg->src), pInterfacePlayerRDK)) || (!privatePlayer->socInterface->IsVideoSinkHandleErrors() && GstPlayer_isVideoOrAudioDecoder(GST_OBJECT_NAME(msg->src),pInterfacePlayerRDK))) && (!privatePlayer->gstPrivateContext->usingRialtoSink))
+			if((NULL != msg->src) && ((privatePlayer->socInterface->IsVideoSinkHandleErrors() && (srcRoles & ELEMENT_ROLE_VIDEO_SINK)) || (!privatePlayer->socInterface->IsVideoSinkHandleErrors() && (srcRoles & ELEMENT_ROLE_AV_DECODER))) && (!privatePlayer->gstPrivateContext->usingRialtoSink))
 			{
 				if (old_state == GST_STATE_NULL && new_state == GST_STATE_READY)
 				{
@@ -4272,16 +6306,14 @@ static gboolean bus_message(GstBus * bus, GstMessage * msg, InterfacePlayerRDK *
 						G_CALLBACK(GstPlayer_OnGstBufferUnderflowCb), pInterfacePlayerRDK);
 						privatePlayer->SignalConnect(msg->src, "pts-error-callback",
 													   G_CALLBACK(GstPlayer_OnGstPtsErrorCb), pInterfacePlayerRDK);
-					if (!privatePlayer->socInterface->IsVideoSinkHandleErrors() && GstPlayer_isVideoDecoder(GST_OBJECT_NAME(msg->src), pInterfacePlayerRDK))
+					if (!privatePlayer->socInterface->IsVideoSinkHandleErrors() && (srcRoles & ELEMENT_ROLE_VIDEO_DECODER))
 					{
 						privatePlayer->SignalConnect(msg->src, "decode-error-callback",
 														   G_CALLBACK(GstPlayer_OnGstDecodeErrorCb), pInterfacePlayerRDK);
 					}
 				}
 			}
-			if((NULL != msg->src) &&
-			   ((gst_StartsWith(GST_OBJECT_NAME(msg->src), "rialtomsevideosink") == true) ||
-				(gst_StartsWith(GST_OBJECT_NAME(msg->src), "rialtomseaudiosink") == true)))
+			if(srcRoles & (ELEMENT_ROLE_RIALTO_VIDEO_SINK | ELEMENT_ROLE_RIALTO_AUDIO_SINK))
 			{
 				if(old_state == GST_STATE_NULL && new_state == GST_STATE_READY)
 				{
@@ -4384,6 +6416,7 @@ bool InterfacePlayerRDK::SetPlayBackRate(double rate)
 {
 	bool ret = false;
 	std::vector<GstElement*> sources;
+	interfacePlayerPriv->gstPrivateContext->positionClock.Invalidate();
 	MW_LOG_TRACE("InterfacePlayerRDK: gst_event_new_instant_rate_change: %f ...V6", rate);
 	for (int iTrack = 0; iTrack < GST_TRACK_COUNT; iTrack++)
 	{
@@ -4650,18 +6683,21 @@ static GstBusSyncReply bus_sync_handler(GstBus * bus, GstMessage * msg, Interfac
 	{
 		case GST_MESSAGE_STATE_CHANGED:
 			GstState old_state, new_state;
+			guint srcRoles;
 			gst_message_parse_state_changed(msg, &old_state, &new_state, NULL);
+			srcRoles = GstPlayer_GetElementRoles(msg->src, pInterfacePlayerRDK);
 
 			if (GST_MESSAGE_SRC(msg) == GST_OBJECT(privatePlayer->gstPrivateContext->pipeline))
 			{
 				privatePlayer->gstPrivateContext->pipelineState = new_state;
+				privatePlayer->gstPrivateContext->positionClock.Invalidate();
 			}
 			/* Moved the below code block from bus_message() async handler to bus_sync_handler()
 			 * to avoid a timing case crash when accessing wrong video_sink element after it got deleted during pipeline reconfigure on codec change in mid of playback.
 			 */
 			if (new_state == GST_STATE_PAUSED && old_state == GST_STATE_READY)
 			{
-				if (GstPlayer_isVideoSink(GST_OBJECT_NAME(msg->src), pInterfacePlayerRDK))
+				if (srcRoles & ELEMENT_ROLE_VIDEO_SINK)
 				{ // video scaling patch
 					/*
 					 brcmvideosink doesn't sets the rectangle property correct by default
@@ -4703,7 +6739,7 @@ static GstBusSyncReply bus_sync_handler(GstBus * bus, GstMessage * msg, Interfac
 				}
 				else
 				{
-					if((gst_StartsWith(GST_OBJECT_NAME(msg->src), "rialtomseaudiosink")))
+					if(srcRoles & ELEMENT_ROLE_RIALTO_AUDIO_SINK)
 					{
 						gst_object_replace((GstObject **)&privatePlayer->gstPrivateContext->audio_sink, msg->src);
 						pInterfacePlayerRDK->SetVolumeOrMuteUnMute();
@@ -4721,9 +6757,9 @@ static GstBusSyncReply bus_sync_handler(GstBus * bus, GstMessage * msg, Interfac
 			}
 			if (old_state == GST_STATE_NULL && new_state == GST_STATE_READY)
 			{
-				if ((NULL != msg->src) && GstPlayer_isVideoOrAudioDecoder(GST_OBJECT_NAME(msg->src), pInterfacePlayerRDK))
+				if (srcRoles & ELEMENT_ROLE_AV_DECODER)
 				{
-					if (GstPlayer_isVideoDecoder(GST_OBJECT_NAME(msg->src), pInterfacePlayerRDK))
+					if (srcRoles & ELEMENT_ROLE_VIDEO_DECODER)
 					{
 						gst_object_replace((GstObject **)&privatePlayer->gstPrivateContext->video_dec, msg->src);
 						type_check_instance("bus_sync_handle: video_dec ", privatePlayer->gstPrivateContext->video_dec);
@@ -4749,7 +6785,7 @@ static GstBusSyncReply bus_sync_handler(GstBus * bus, GstMessage * msg, Interfac
 
 					}
 				}
-				if ((NULL != msg->src) && GstPlayer_isVideoSink(GST_OBJECT_NAME(msg->src), pInterfacePlayerRDK) && (!privatePlayer->gstPrivateContext->usingRialtoSink))
+				if ((srcRoles & ELEMENT_ROLE_VIDEO_SINK) && (!privatePlayer->gstPrivateContext->usingRialtoSink))
 				{
 					if(privatePlayer->gstPrivateContext->enableSEITimeCode)
 					{
@@ -4761,17 +6797,13 @@ static GstBusSyncReply bus_sync_handler(GstBus * bus, GstMessage * msg, Interfac
 				}
 				if(!privatePlayer->socInterface->HasFirstAudioFrameCallback())
 				{
-					if ((NULL != msg->src) && gst_StartsWith(GST_OBJECT_NAME(msg->src), "rtkaudiosink"))
+					if (srcRoles & ELEMENT_ROLE_RTK_AUDIO_SINK)
 					{
 						privatePlayer->SignalConnect(msg->src, "first-audio-frame",
 														   G_CALLBACK(GstPlayer_OnAudioFirstFrameAudDecoder), pInterfacePlayerRDK);
 					}
 				}
-				if ((NULL != msg->src) &&
-					(gst_StartsWith(GST_OBJECT_NAME(msg->src), GstPluginNamePR) == true ||
-					 gst_StartsWith(GST_OBJECT_NAME(msg->src), GstPluginNameWV) == true ||
-					 gst_StartsWith(GST_OBJECT_NAME(msg->src), GstPluginNameCK) == true ||
-					 gst_StartsWith(GST_OBJECT_NAME(msg->src), GstPluginNameVMX) == true))
+				if (srcRoles & ELEMENT_ROLE_DECRYPTOR)
 				{
  					MW_LOG_MIL("InterfacePlayerRDK setting encrypted player (%p) instance for %s decryptor", pInterfacePlayerRDK->mEncrypt, GST_OBJECT_NAME(msg->src));
  					GValue val = { 0, };
@@ -4807,7 +6839,7 @@ static GstBusSyncReply bus_sync_handler(GstBus * bus, GstMessage * msg, Interfac
 			MW_LOG_INFO("Received GST_MESSAGE_ASYNC_DONE message");
 			if (privatePlayer->gstPrivateContext->buffering_in_progress)
 			{
-				privatePlayer->gstPrivateContext->bufferingTimeoutTimerId = g_timeout_add_full(BUFFERING_TIMEOUT_PRIORITY, DEFAULT_BUFFERING_TO_MS, buffering_timeout, pInterfacePlayerRDK, NULL);
+				privatePlayer->gstPrivateContext->bufferingTimeoutTimerId = privatePlayer->gstPrivateContext->mainLoopThread.AddTimeout(BUFFERING_TIMEOUT_PRIORITY, DEFAULT_BUFFERING_TO_MS, buffering_timeout, pInterfacePlayerRDK);
 			}
 
 			break;
@@ -4831,6 +6863,7 @@ static GstBusSyncReply bus_sync_handler(GstBus * bus, GstMessage * msg, Interfac
 					case GST_STREAM_STATUS_TYPE_CREATE:
 						if (task && privatePlayer->gstPrivateContext->task_pool)
 						{
+							gst_player_taskpool_set_task_class(task, (guint)GstPlayer_GetTaskClass(owner, pInterfacePlayerRDK));
 							gst_task_set_pool(task, privatePlayer->gstPrivateContext->task_pool);
 						}
 						break;
@@ -4970,11 +7003,49 @@ int InterfacePlayerRDK::InterfacePlayer_SetupStream(int streamId, std::string ma
 	int retvalue = 0;
 	GstMediaType mediaType = static_cast<GstMediaType>(streamId);
 	this->TriggerEvent(InterfaceCB::startNewSubtitleStream, mediaType);
+	interfacePlayerPriv->gstPrivateContext->tuneTimeline.MarkTrack(mediaType, eTUNE_TRACK_SETUP_START);
 	retvalue = this->SetupStream(mediaType, (void*)this, manifestUrl);
+	interfacePlayerPriv->gstPrivateContext->tuneTimeline.MarkTrack(mediaType, eTUNE_TRACK_SETUP_DONE);
 
 	return retvalue;
 }
 
+/**
+ * @brief Set up several tracks concurrently with a join barrier
+ *
+ * Each SetupStream only writes its own gst_media_stream and its own sink field of GstPlayerPriv
+ * (video_sink, audio_sink or subtitle_sink). The shared pieces it touches are already thread safe:
+ * gst_bin_add locks the pipeline, SignalConnect holds mSignalVectorAccessMutex and the handler
+ * controls carry their own lock. startNewSubtitleStream is raised up front on the calling thread
+ * so application callbacks keep their serial order.
+ */
+void InterfacePlayerRDK::SetupStreamsConcurrently(const int *tracks, int count, const std::string &manifestUrl, int *results)
+{
+	for (int n = 0; n < count; n++)
+	{
+		TriggerEvent(InterfaceCB::startNewSubtitleStream, tracks[n]);
+	}
+	std::vector<std::thread> workers;
+	workers.reserve(count - 1);
+	for (int n = 1; n < count; n++)
+	{
+		workers.emplace_back([this, tracks, n, &manifestUrl, results]()
+		{
+			interfacePlayerPriv->gstPrivateContext->tuneTimeline.MarkTrack(tracks[n], eTUNE_TRACK_SETUP_START);
+			results[n] = SetupStream(tracks[n], (void*)this, manifestUrl);
+			interfacePlayerPriv->gstPrivateContext->tuneTimeline.MarkTrack(tracks[n], eTUNE_TRACK_SETUP_DONE);
+		});
+	}
+	interfacePlayerPriv->gstPrivateContext->tuneTimeline.MarkTrack(tracks[0], eTUNE_TRACK_SETUP_START);
+	results[0] = SetupStream(tracks[0], (void*)this, manifestUrl);
+	interfacePlayerPriv->gstPrivateContext->tuneTimeline.MarkTrack(tracks[0], eTUNE_TRACK_SETUP_DONE);
+	for (auto &worker : workers)
+	{
+		worker.join();
+	}
+	MW_LOG_MIL("InterfacePlayerRDK: %d tracks set up concurrently", count);
+}
+
 /*
  * @brief Check whether Gstreamer platform has support of the given codec or not.
  *        codec to component mapping done in gstreamer side.
@@ -4984,11 +7055,9 @@ int InterfacePlayerRDK::InterfacePlayer_SetupStream(int streamId, std::string ma
 bool InterfacePlayerRDK::IsCodecSupported(const std::string &codecName)
 {
 	bool retValue = false;
-	GstRegistry* registry = gst_registry_get();
 	for (std::string &componentName: gstMapDecoderLookUptable[codecName])
 	{
-		GstPluginFeature* pluginFeature = gst_registry_lookup_feature(registry, componentName.c_str());	/* searches for codec in the registry */
-		if (pluginFeature != NULL)
+		if (SocInterface::IsFeatureAvailable(componentName.c_str()))	/* searches for codec in the cached registry answers */
 		{
 			retValue = true;
 			break;
@@ -5082,6 +7151,22 @@ bool InterfacePlayerRDK::SignalSubtitleClock(gint64 vPTS, bool state)
 	//MW_LOG_TRACE("Exit SignalSubtitleClock");
 	return signalSent;
 }
+/**
+ *  @brief Keep video and audio playbins pre-built for the next tunes
+ */
+void InterfacePlayerRDK::PrewarmPlaybins(int perTrack)
+{
+	WarmPlaybinPool::GetInstance().Configure(perTrack);
+}
+
+/**
+ *  @brief Release all pre-built playbins
+ */
+void InterfacePlayerRDK::ReleasePrewarmedPlaybins()
+{
+	WarmPlaybinPool::GetInstance().Clear();
+}
+
 /**
  *  @brief Increase the rank of Player decryptor plugins
  */
@@ -61,6 +61,133 @@ struct MonitorAVState
  */
 typedef int (*BackgroundTask)(void *arg);
 
+/**
+ * @brief Function pointer invoked when caller owned fragment memory is no longer referenced
+ * @param[in] ptr - start of the fragment memory handed over to SendHelperZeroCopy
+ * @param[in] userData - caller context handed over alongside the fragment
+ */
+typedef void (*PlayerBufferReleaseCallback)(void *ptr, void *userData);
+
+/**
+ * @brief One fragment or sample handed over to SendHelperBatch
+ */
+struct PlayerFragmentDesc
+{
+	const void *ptr;                         /**< fragment data */
+	size_t len;                              /**< fragment length in bytes */
+	double fpts;                             /**< presentation time in seconds */
+	double fdts;                             /**< decode time in seconds */
+	double fDuration;                        /**< duration in seconds */
+	uint64_t ptsTicks;                       /**< presentation time in timescale units, used instead of fpts when timescale is set */
+	uint64_t dtsTicks;                       /**< decode time in timescale units */
+	uint64_t durationTicks;                  /**< duration in timescale units */
+	uint32_t timescale;                      /**< ticks per second; 0 selects the seconds fields */
+	PlayerBufferReleaseCallback releaseCb;   /**< optional release callback for caller owned memory, see SendHelperZeroCopy */
+	void *releaseData;                       /**< user data passed to releaseCb */
+
+	PlayerFragmentDesc(const void *data = nullptr, size_t length = 0, double pts = 0, double dts = 0, double duration = 0, PlayerBufferReleaseCallback cb = nullptr, void *cbData = nullptr) :
+		ptr(data), len(length), fpts(pts), fdts(dts), fDuration(duration), ptsTicks(0), dtsTicks(0), durationTicks(0), timescale(0), releaseCb(cb), releaseData(cbData)
+	{
+	}
+
+	/**
+	 * @brief Set exact timestamps in media timescale units; converted to nanoseconds once with integer scaling
+	 */
+	void SetTicks(uint64_t pts, uint64_t dts, uint64_t duration, uint32_t ticksPerSecond)
+	{
+		ptsTicks = pts;
+		dtsTicks = dts;
+		durationTicks = duration;
+		timescale = ticksPerSecond;
+	}
+};
+
+/**
+ * @brief Snapshot of the injection counters of one track, see InterfacePlayerRDK::GetInjectionStats
+ */
+struct PlayerInjectionStats
+{
+	static const int kLatencyBuckets = 7;   /**< push latency buckets: <10us, <100us, <1ms, <10ms, <100ms, <1s, >=1s */
+
+	uint64_t bytesPushed;                    /**< bytes handed over to the appsrc */
+	uint64_t buffersPushed;                  /**< buffers handed over to the appsrc; a buffer list counts all of its buffers */
+	uint64_t pushCalls;                      /**< gst_app_src_push_buffer/_list calls */
+	uint64_t pushFailures;                   /**< push calls not returning GST_FLOW_OK */
+	uint64_t pushLatencyHistogram[kLatencyBuckets]; /**< push call latency, decade buckets in microseconds */
+	uint64_t maxPushLatencyUs;               /**< slowest push call */
+	uint64_t queuedBytes;                    /**< appsrc current-level-bytes sampled after the last push */
+	uint64_t maxQueuedBytes;                 /**< highest current-level-bytes sampled */
+	uint64_t needDataCount;                  /**< appsrc need-data signals */
+	uint64_t enoughDataCount;                /**< appsrc enough-data signals */
+	uint64_t blockedTimeUs;                  /**< time injection spent waiting for the source to be set up */
+	uint64_t activeTimeUs;                   /**< time between the first and the last push */
+	double bytesPerSecond;                   /**< bytesPushed over activeTimeUs, 0 until two pushes were made */
+};
+
+/**
+ * @brief Snapshot of the A/V sync monitor, see InterfacePlayerRDK::GetAVSyncStats
+ *
+ * Drift is the video position minus the audio position, positive while video is ahead. Percentiles
+ * come from a log-linear histogram and are accurate to 1/8 of their magnitude.
+ */
+struct PlayerAVSyncStats
+{
+	uint64_t polls;                 /**< MonitorAV calls that queried the pipeline while PLAYING */
+	uint64_t skippedPolls;          /**< MonitorAV calls skipped while backed off */
+	uint64_t driftSamples;          /**< polls that found both tracks playing */
+	uint64_t outOfSyncSamples;      /**< drift samples outside monitorAvsyncThresholdNegativeMs..monitorAvsyncThresholdPositiveMs */
+	uint64_t stallEvents;           /**< both tracks stopped advancing */
+	uint64_t videoFreezeEvents;     /**< video stopped advancing */
+	uint64_t audioDropEvents;       /**< audio stopped advancing */
+	uint64_t jumpEvents;            /**< video advanced faster than the wall clock by more than monitorAvJumpThresholdMs */
+	uint64_t stalledTimeMs;         /**< time spent in stall, video freeze or audio drop */
+	int minDriftMs;                 /**< 0 until the first drift sample */
+	int maxDriftMs;
+	int p50DriftMs;
+	int p90DriftMs;
+	int p99DriftMs;
+	int p999DriftMs;
+	int pollIntervalTicks;          /**< progress ticks between polls; grows while A/V is steadily in sync when monitorAvBackoff is set */
+};
+
+/**
+ * @brief Pipeline wide tune milestones, see InterfacePlayerRDK::GetTuneTimeline
+ */
+enum PlayerTuneMilestone
+{
+	eTUNE_MILESTONE_CONFIGURE,         /**< ConfigurePipeline entered; origin of the timeline */
+	eTUNE_MILESTONE_PIPELINE_CREATED,  /**< GstPipeline and bus created */
+	eTUNE_MILESTONE_PAUSED,            /**< Pipeline reached PAUSED */
+	eTUNE_MILESTONE_PLAYING,           /**< Pipeline reached PLAYING */
+	eTUNE_MILESTONE_FIRST_FRAME,       /**< First frame notified to the application */
+	eTUNE_MILESTONE_COUNT
+};
+
+/**
+ * @brief Per-track tune milestones, see InterfacePlayerRDK::GetTuneTimeline
+ */
+enum PlayerTuneTrackMilestone
+{
+	eTUNE_TRACK_SETUP_START,           /**< SetupStream entered */
+	eTUNE_TRACK_SETUP_DONE,            /**< SetupStream returned */
+	eTUNE_TRACK_CAPS_SET,              /**< appsrc configured with caps, or typefind when caps are unknown */
+	eTUNE_TRACK_FIRST_BUFFER_PUSHED,   /**< First buffer accepted by the appsrc */
+	eTUNE_TRACK_FIRST_FRAME_DECODED,   /**< Decoder reported its first frame */
+	eTUNE_TRACK_MILESTONE_COUNT
+};
+
+/**
+ * @brief Snapshot of the tune timeline; offsets are microseconds from eTUNE_MILESTONE_CONFIGURE, -1 if not reached
+ */
+struct PlayerTuneTimeline
+{
+	static const int kTrackCount = 4;       /**< video, audio, subtitle, aux audio */
+
+	gint64 startUs;                         /**< monotonic time of the origin, 0 if no tune was recorded */
+	gint64 milestoneUs[eTUNE_MILESTONE_COUNT];
+	gint64 trackMilestoneUs[kTrackCount][eTUNE_TRACK_MILESTONE_COUNT];
+};
+
 struct GstTaskControlData
 {
         guint taskID;
@@ -92,6 +219,41 @@ struct BusEventData
 	bool receivedFirstFrame;
 };
 
+/**
+ * @enum PlayerTaskClass
+ * @brief Groups of GStreamer streaming threads that can be scheduled differently, see Configs::taskSched
+ */
+enum PlayerTaskClass
+{
+	ePLAYER_TASK_CLASS_DEFAULT,   /**< Threads not inside a video or audio playbin */
+	ePLAYER_TASK_CLASS_VIDEO,     /**< Threads of the video playbin: appsrc, demux, queues feeding the decoder */
+	ePLAYER_TASK_CLASS_AUDIO,     /**< Threads of the audio and aux audio playbins */
+	ePLAYER_TASK_CLASS_COUNT
+};
+
+/**
+ * @enum PlayerTaskSchedPolicy
+ * @brief Scheduling policy of a PlayerTaskClass
+ */
+enum PlayerTaskSchedPolicy
+{
+	ePLAYER_TASK_SCHED_INHERIT,   /**< Policy, priority, nice value and affinity of the thread starting the task, as before pooling; parked threads are only reused when they already match */
+	ePLAYER_TASK_SCHED_OTHER,     /**< SCHED_OTHER with PlayerTaskSchedConfig::nice */
+	ePLAYER_TASK_SCHED_FIFO,      /**< SCHED_FIFO with PlayerTaskSchedConfig::priority; needs CAP_SYS_NICE */
+	ePLAYER_TASK_SCHED_RR         /**< SCHED_RR with PlayerTaskSchedConfig::priority; needs CAP_SYS_NICE */
+};
+
+/**
+ * @brief Scheduling of the streaming threads of one PlayerTaskClass
+ */
+struct PlayerTaskSchedConfig
+{
+	int policy;                   /**< PlayerTaskSchedPolicy */
+	int priority;                 /**< Real time priority for ePLAYER_TASK_SCHED_FIFO and ePLAYER_TASK_SCHED_RR */
+	int nice;                     /**< Nice value for ePLAYER_TASK_SCHED_OTHER; FIFO and RR keep the nice value of the starting thread */
+	uint64_t cpuMask;             /**< CPUs 0..63 the threads may run on, e.g. the big cores; 0 inherits */
+};
+
 struct Configs
 {
 	std::string networkProxyValue;
@@ -127,7 +289,19 @@ struct Configs
 	int monitorAvsyncThresholdPositiveMs;
 	int monitorAvsyncThresholdNegativeMs;
 	int monitorAvJumpThresholdMs;
+	bool monitorAvBackoff;        /**< Let MonitorAV poll every second, then every fourth progress tick while A/V stays in sync; off polls on every tick */
 	bool useMp4Demux;
+	bool useBufferPool;           /**< Recycle the buffers fragments are copied into through per-track GstBufferPools; not used with useMp4Demux */
+	int bufferPoolMaxBuffers;     /**< Upper bound of buffers per pool size class; 0 derives it from videoBufBytes/audioBufBytes only */
+	bool shareAuxAudioBuffers;    /**< Feed the aux audio appsrc with references to the main audio buffers instead of copies */
+	int warmPlaybinCount;         /**< Video and audio playbins kept pre-built in READY for fast channel change; 0 disables */
+	bool parallelStreamSetup;     /**< Set up the playbins of all tracks concurrently in ConfigurePipeline */
+	bool asyncPipelineTeardown;   /**< Hand the outgoing pipeline to a background reaper thread in Stop instead of setting it to NULL inline */
+	int asyncTeardownMaxPending;  /**< Outgoing pipelines still allowed to be tearing down when a new one starts; 0 waits for all, for decoders that cannot be allocated twice; the tune fails with MESSAGE_ERROR if the wait times out */
+	int positionSampleIntervalMs; /**< Query the pipeline position at most this often and extrapolate in between; 0 queries on every GetPositionMilliseconds */
+	bool dedicatedMainContext;    /**< Dispatch this player's bus messages and timers on its own GMainContext and thread instead of the default main context; read at the first CreatePipeline */
+	int taskPoolMaxIdleThreads;   /**< Streaming threads kept parked for reuse by the next pipeline; parked threads are shared by all players and the largest value of any live player applies. 0 asks for none. Needs a PipelinePriority >= 0 */
+	PlayerTaskSchedConfig taskSched[ePLAYER_TASK_CLASS_COUNT]; /**< Scheduling per PlayerTaskClass, applied from the next CreatePipeline */
 };
 
 
@@ -391,6 +565,8 @@ class InterfacePlayerRDK
         	void SetSubtitleMute(bool mute);
         	/**
         	 * @fn GetPositionMilliseconds
+        	 * @brief With positionSampleIntervalMs set, the pipeline is queried at most once per interval and the
+        	 * position is extrapolated in between without calling into GStreamer.
         	 * @retval playback position in MS
         	 */
         	long long GetPositionMilliseconds(void);
@@ -459,6 +635,101 @@ class InterfacePlayerRDK
         	 * @return True if the event was sent successfully, false otherwise.
         	 */
         	bool SendHelper(int type, const void *ptr, size_t len, double fpts, double fdts, double fDuration, double fragmentPTSoffset, bool copy, bool initFragment, bool &discontinuity, bool &notifyFirstBufferProcessed, bool &sendNewSegmentEvent, bool &resetTrickUTC, bool &firstBufferPushed);
+        	/**
+        	 * @brief Injects a fragment whose timestamps are given as integer ticks of a media timescale.
+        	 *
+        	 * Same as SendHelper, but pts/dts/duration are scaled to nanoseconds with
+        	 * gst_util_uint64_scale, so long running streams keep bit exact timestamps.
+        	 * @param[in] ptsTicks presentation time in timescale units.
+        	 * @param[in] dtsTicks decode time in timescale units.
+        	 * @param[in] durationTicks duration in timescale units.
+        	 * @param[in] timescale ticks per second, e.g. from mdhd; must be non-zero.
+        	 * @return True if the buffer was pushed, false otherwise.
+        	 */
+        	bool SendHelperTicks(int type, const void *ptr, size_t len, uint64_t ptsTicks, uint64_t dtsTicks, uint64_t durationTicks, uint32_t timescale, double fragmentPTSoffset, bool copy, bool initFragment, bool &discontinuity, bool &notifyFirstBufferProcessed, bool &sendNewSegmentEvent, bool &resetTrickUTC, bool &firstBufferPushed);
+        	/**
+        	 * @brief Inject a partial byte range of a low latency (chunked CMAF) segment.
+        	 *
+        	 * Ranges must be handed over in stream order and may split boxes and samples anywhere.
+        	 * With useMp4Demux each sample is pushed as soon as its bytes are complete; otherwise the
+        	 * range is pushed as is for qtdemux to consume.
+        	 * @param[in] type The type of media stream.
+        	 * @param[in] ptr Pointer to the chunk data.
+        	 * @param[in] len Length of the chunk data.
+        	 * @param[in] fpts PTS of the segment the chunk belongs to.
+        	 * @param[in] fdts DTS of the segment the chunk belongs to.
+        	 * @param[in] fDuration Duration of the chunk.
+        	 * @param[in] fragmentPTSoffset Offset PTS value.
+        	 * @param[in] copy True to copy the chunk data.
+        	 * @param[in] segmentStart True for the first range of a segment; discards any partial box or
+        	 *            sample left by a previous segment that was not delivered completely.
+        	 * @param[out] discontinuity Indicates whether there is a discontinuity.
+        	 * @param[out] notifyFirstBufferProcessed Indicates whether the first buffer was processed.
+        	 * @param[out] sendNewSegmentEvent Indicates whether to send a new segment event.
+        	 * @param[out] resetTrickUTC Indicates whether to reset the trick UTC.
+        	 * @param[out] firstBufferPushed Indicates whether the first buffer was pushed.
+        	 * @return True if the chunk was injected, false otherwise.
+        	 */
+        	bool SendHelperChunk(int type, const void *ptr, size_t len, double fpts, double fdts, double fDuration, double fragmentPTSoffset, bool copy, bool segmentStart, bool &discontinuity, bool &notifyFirstBufferProcessed, bool &sendNewSegmentEvent, bool &resetTrickUTC, bool &firstBufferPushed);
+        	/**
+        	 * @brief Inject a partial byte range of a low latency segment with timestamps in media timescale ticks.
+        	 *
+        	 * Same as SendHelperChunk, with pts/dts/duration scaled as in SendHelperTicks.
+        	 * @param[in] timescale ticks per second; must be non-zero.
+        	 * @return True if the chunk was injected, false otherwise.
+        	 */
+        	bool SendHelperChunkTicks(int type, const void *ptr, size_t len, uint64_t ptsTicks, uint64_t dtsTicks, uint64_t durationTicks, uint32_t timescale, double fragmentPTSoffset, bool copy, bool segmentStart, bool &discontinuity, bool &notifyFirstBufferProcessed, bool &sendNewSegmentEvent, bool &resetTrickUTC, bool &firstBufferPushed);
+        	/**
+        	 * @brief Inject caller owned fragment memory without copying it.
+        	 *
+        	 * The fragment is wrapped in place and handed to appsrc; releaseCb is invoked exactly once,
+        	 * either straight away when the fragment is not injected or when the pipeline drops its
+        	 * last reference (after render, flush or teardown). The memory must stay valid until then.
+        	 * @param[in] type The type of media stream.
+        	 * @param[in] ptr Pointer to the fragment data.
+        	 * @param[in] len Length of the fragment data.
+        	 * @param[in] releaseCb Callback releasing the fragment memory.
+        	 * @param[in] releaseData User data passed to releaseCb.
+        	 * @param[in] fpts First PTS value.
+        	 * @param[in] fdts First DTS value.
+        	 * @param[in] fDuration Duration of the fragment.
+        	 * @param[in] fragmentPTSoffset Offset PTS value.
+        	 * @param[in] initFragment True if this is an initialization fragment.
+        	 * @param[out] discontinuity Indicates whether there is a discontinuity.
+        	 * @param[out] notifyFirstBufferProcessed Indicates whether the first buffer was processed.
+        	 * @param[out] sendNewSegmentEvent Indicates whether to send a new segment event.
+        	 * @param[out] resetTrickUTC Indicates whether to reset the trick UTC.
+        	 * @param[out] firstBufferPushed Indicates whether the first buffer was pushed.
+        	 * @return True if the fragment was injected, false otherwise.
+        	 */
+        	bool SendHelperZeroCopy(int type, const void *ptr, size_t len, PlayerBufferReleaseCallback releaseCb, void *releaseData, double fpts, double fdts, double fDuration, double fragmentPTSoffset, bool initFragment, bool &discontinuity, bool &notifyFirstBufferProcessed, bool &sendNewSegmentEvent, bool &resetTrickUTC, bool &firstBufferPushed);
+        	/**
+        	 * @brief Inject caller owned fragment memory without copying it, with timestamps in media timescale ticks.
+        	 *
+        	 * Same release contract as SendHelperZeroCopy, with pts/dts/duration scaled as in SendHelperTicks.
+        	 * releaseCb is invoked straight away if timescale is 0.
+        	 * @param[in] timescale ticks per second; must be non-zero.
+        	 * @return True if the fragment was injected, false otherwise.
+        	 */
+        	bool SendHelperZeroCopyTicks(int type, const void *ptr, size_t len, PlayerBufferReleaseCallback releaseCb, void *releaseData, uint64_t ptsTicks, uint64_t dtsTicks, uint64_t durationTicks, uint32_t timescale, double fragmentPTSoffset, bool initFragment, bool &discontinuity, bool &notifyFirstBufferProcessed, bool &sendNewSegmentEvent, bool &resetTrickUTC, bool &firstBufferPushed);
+        	/**
+        	 * @brief Inject several media fragments or samples of one track with a single appsrc push.
+        	 *
+        	 * All buffers are collected into a GstBufferList with a single source readiness check. Init
+        	 * fragments must still go through SendHelper. Without copy, entries with a releaseCb are
+        	 * borrowed as in SendHelperZeroCopy and the others transfer ownership of g_malloc'd memory.
+        	 * @param[in] type The type of media stream.
+        	 * @param[in] fragments Fragments to inject, in decode order.
+        	 * @param[in] fragmentPTSoffset Offset PTS value.
+        	 * @param[in] copy True to copy the fragment data.
+        	 * @param[out] discontinuity Indicates whether there is a discontinuity.
+        	 * @param[out] notifyFirstBufferProcessed Indicates whether the first buffer was processed.
+        	 * @param[out] sendNewSegmentEvent Indicates whether to send a new segment event.
+        	 * @param[out] resetTrickUTC Indicates whether to reset the trick UTC.
+        	 * @param[out] firstBufferPushed Indicates whether the first buffer was pushed.
+        	 * @return True if any buffer was injected, false otherwise.
+        	 */
+        	bool SendHelperBatch(int type, const std::vector<PlayerFragmentDesc> &fragments, double fragmentPTSoffset, bool copy, bool &discontinuity, bool &notifyFirstBufferProcessed, bool &sendNewSegmentEvent, bool &resetTrickUTC, bool &firstBufferPushed);
         	/**
         	 * @brief Pauses the injector.
         	 */
@@ -576,6 +847,45 @@ class InterfacePlayerRDK
         	 * @return True if the buffer control data was retrieved successfully, false otherwise.
         	 */
         	bool GetBufferControlData(int mediaType);
+        	/**
+        	 * @brief Gets the injection counters of a track.
+        	 * @param[in] mediaType The type of media stream.
+        	 * @param[out] stats Snapshot of the counters; counters are read individually and may be off by the pushes in flight.
+        	 * @return True if mediaType names a track, false otherwise.
+        	 */
+        	bool GetInjectionStats(int mediaType, PlayerInjectionStats &stats);
+        	/**
+        	 * @brief Clears the injection counters of a track.
+        	 * @param[in] mediaType The type of media stream.
+        	 */
+        	void ResetInjectionStats(int mediaType);
+        	/**
+        	 * @brief Gets the drift distribution and stall counters collected by MonitorAV.
+        	 * @param[out] stats Snapshot of the monitor; empty unless monitorAV is enabled.
+        	 * @return True if monitorAV is enabled, false otherwise.
+        	 */
+        	bool GetAVSyncStats(PlayerAVSyncStats &stats);
+        	/**
+        	 * @brief Clears the A/V sync monitor and restarts polling on every progress tick.
+        	 */
+        	void ResetAVSyncStats();
+        	/**
+        	 * @brief Gets the milestones of the current tune.
+        	 *
+        	 * A timeline starts when ConfigurePipeline is first called after construction, Stop or ResetTuneTimeline.
+        	 * Each milestone keeps its first occurrence, so later reconfigurations don't overwrite it.
+        	 * @param[out] timeline Snapshot of the milestones.
+        	 */
+        	void GetTuneTimeline(PlayerTuneTimeline &timeline);
+        	/**
+        	 * @brief Gets the milestones of the current tune as a JSON object; milestones not reached are omitted.
+        	 * @return JSON text.
+        	 */
+        	std::string GetTuneTimelineJson();
+        	/**
+        	 * @brief Discards the current timeline; the next ConfigurePipeline starts a new one.
+        	 */
+        	void ResetTuneTimeline();
         	/**
         	 * @brief Checks if the stream is ready for a given media type.
         	 * @param[in] mediaType The type of media stream.
@@ -712,6 +1022,16 @@ class InterfacePlayerRDK
         	 * @param[in] gstMediaFormat The media format for the pipeline.
         	 */
         	bool Flush(double position, int rate, bool shouldTearDown, bool isAppSeek);
+        	/**
+        	 * @brief Skips forward to a position already queued on every track, without flushing.
+        	 *
+        	 * Opt-in alternative to Flush for callers that keep injecting after the queued range. Only a
+        	 * forward target at normal rate that leaves queued data behind it is served; position is on the
+        	 * same timeline as the fragment PTS passed to SendHelper, which is not the case with PTS restamping.
+        	 * @param[in] position The position to skip to, in seconds.
+        	 * @return True if the skip was started, false if the caller has to Flush instead.
+        	 */
+        	bool SeekWithinQueuedData(double position);
         	/**
         	 * @fn TimerAdd
         	 * @param[in] funcPtr function to execute on timer expiry
@@ -754,6 +1074,18 @@ class InterfacePlayerRDK
         	 * This function initializes the necessary plugins for Player GStreamer.
         	 */
         	static void InitializePlayerGstreamerPlugins();
+        	/**
+        	 * @brief Keeps video and audio playbins pre-built in READY state for the next tunes.
+        	 *
+        	 * SetupStream claims a pre-built playbin instead of creating one when warmPlaybinCount is set.
+        	 * Calling this ahead of the first tune also warms the pool for it.
+        	 * @param[in] perTrack Number of playbins kept per track; 0 releases the pool.
+        	 */
+        	static void PrewarmPlaybins(int perTrack);
+        	/**
+        	 * @brief Releases all pre-built playbins and stops refilling the pool.
+        	 */
+        	static void ReleasePrewarmedPlaybins();
         	/**
         	 * @brief Dumps diagnostic information.
         	 */
@@ -771,6 +1103,56 @@ class InterfacePlayerRDK
 
 	private:
 		InterfacePlayerPriv *interfacePlayerPriv;
+
+		/**
+		 * @brief Removes the EOS and buffering timeout callbacks still pending from before a seek.
+		 */
+		void RemovePendingSeekCallbacks();
+
+		/**
+		 * @brief Removes the timers this player dispatches on its main loop.
+		 */
+		void RemoveMainLoopTimers();
+
+		/**
+		 * @brief Queries the video playbin for the playback position.
+		 * @return True if the query succeeded; positionMs is 0 otherwise.
+		 */
+		bool QueryPositionMilliseconds(long long &positionMs);
+
+		/**
+		 * @brief Hands the pipeline, bus and task pool to the background reaper; callbacks must already be detached.
+		 */
+		void ReapPipeline();
+
+		/**
+		 * @brief Applies taskPoolMaxIdleThreads and taskSched to the task pool of a new pipeline.
+		 */
+		void ConfigureTaskPool();
+
+		/**
+		 * @brief Sends the events due ahead of the first buffer after a tune, seek or period change.
+		 * @return True if a new segment event was sent.
+		 */
+		bool SendFirstBufferEvents(int type, GstClockTime pts, bool initFragment, bool sendNewSegmentEvent);
+
+		/**
+		 * @brief Common injection path for SendHelper and SendHelperZeroCopy.
+		 * When releaseCb is set the fragment is wrapped without copying and copy is ignored.
+		 * chunked selects the resumable Mp4Demux parser for partial segment byte ranges and
+		 * segmentStart restarts it at the first range of a new segment.
+		 * pts, dts and duration are already converted to nanoseconds by the caller.
+		 */
+		bool SendHelperInternal(int type, const void *ptr, size_t len, GstClockTime pts, GstClockTime dts, GstClockTime duration, double fragmentPTSoffset, bool copy, PlayerBufferReleaseCallback releaseCb, void *releaseData, bool initFragment, bool chunked, bool segmentStart, bool &discontinuity, bool &notifyFirstBufferProcessed, bool &sendNewSegmentEvent, bool &resetTrickUTC, bool &firstBufferPushed);
+
+		/**
+		 * @brief Runs SetupStream for several tracks on worker threads and waits for all of them.
+		 * @param[in] tracks Media types to set up, in ConfigurePipeline order.
+		 * @param[in] count Number of entries in tracks.
+		 * @param[in] manifestUrl Passed to each SetupStream.
+		 * @param[out] results SetupStream result per entry of tracks.
+		 */
+		void SetupStreamsConcurrently(const int *tracks, int count, const std::string &manifestUrl, int *results);
 };
 struct data
 {
@@ -0,0 +1,113 @@
+/*
+ * If not stated otherwise in this file or this component's license file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2025 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file PlayerPositionClock.cpp
+ * @brief Interpolating playback position clock with lock free reads
+ */
+
+#include "PlayerPositionClock.h"
+#include <chrono>
+
+PlayerPositionClock::PlayerPositionClock() : mSequence(0), mValid(false), mPositionMs(0), mTimestampUs(0), mSlope(0.0),
+	mWriteMutex(), mRefreshing(false), mEpoch(0), mRefreshEpoch(0)
+{
+}
+
+int64_t PlayerPositionClock::NowUs()
+{
+	return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+bool PlayerPositionClock::Read(int64_t nowUs, long long &positionMs, int64_t &ageUs) const
+{
+	bool valid;
+	long long position;
+	int64_t timestamp;
+	double slope;
+	uint32_t begin;
+	do
+	{
+		begin = mSequence.load(std::memory_order_acquire);
+		valid = mValid.load(std::memory_order_relaxed);
+		position = mPositionMs.load(std::memory_order_relaxed);
+		timestamp = mTimestampUs.load(std::memory_order_relaxed);
+		slope = mSlope.load(std::memory_order_relaxed);
+		std::atomic_thread_fence(std::memory_order_acquire);
+	} while ((begin & 1) || begin != mSequence.load(std::memory_order_relaxed));
+
+	if (!valid)
+	{
+		return false;
+	}
+	int64_t age = nowUs - timestamp;
+	if (age < 0)
+	{ // sample taken after the caller read the clock
+		age = 0;
+	}
+	positionMs = position + (long long)(slope * (double)age / 1000.0);
+	ageUs = age;
+	return true;
+}
+
+bool PlayerPositionClock::TryBeginRefresh()
+{
+	std::lock_guard<std::mutex> guard(mWriteMutex);
+	if (mRefreshing)
+	{
+		return false;
+	}
+	mRefreshing = true;
+	mRefreshEpoch = mEpoch;
+	return true;
+}
+
+void PlayerPositionClock::Publish(long long positionMs, int64_t timestampUs, double slope)
+{
+	std::lock_guard<std::mutex> guard(mWriteMutex);
+	if (mRefreshEpoch != mEpoch)
+	{ // sampled before a seek, rate or state change
+		return;
+	}
+	uint32_t sequence = mSequence.load(std::memory_order_relaxed);
+	mSequence.store(sequence + 1, std::memory_order_relaxed);
+	std::atomic_thread_fence(std::memory_order_release);
+	mPositionMs.store(positionMs, std::memory_order_relaxed);
+	mTimestampUs.store(timestampUs, std::memory_order_relaxed);
+	mSlope.store(slope, std::memory_order_relaxed);
+	mValid.store(true, std::memory_order_relaxed);
+	mSequence.store(sequence + 2, std::memory_order_release);
+}
+
+void PlayerPositionClock::EndRefresh()
+{
+	std::lock_guard<std::mutex> guard(mWriteMutex);
+	mRefreshing = false;
+}
+
+void PlayerPositionClock::Invalidate()
+{
+	std::lock_guard<std::mutex> guard(mWriteMutex);
+	mEpoch++;
+	uint32_t sequence = mSequence.load(std::memory_order_relaxed);
+	mSequence.store(sequence + 1, std::memory_order_relaxed);
+	std::atomic_thread_fence(std::memory_order_release);
+	mValid.store(false, std::memory_order_relaxed);
+	mSequence.store(sequence + 2, std::memory_order_release);
+}
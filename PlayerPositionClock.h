@@ -0,0 +1,99 @@
+/*
+ * If not stated otherwise in this file or this component's license file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2025 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file PlayerPositionClock.h
+ * @brief Interpolating playback position clock with lock free reads
+ */
+
+#ifndef PLAYER_POSITION_CLOCK_H
+#define PLAYER_POSITION_CLOCK_H
+
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+
+/**
+ * @class PlayerPositionClock
+ * @brief Publishes the last sampled playback position and extrapolates it between samples
+ *
+ * A sample is (position, monotonic timestamp, slope), where slope is the position milliseconds
+ * advanced per wall clock millisecond: 1 while playing at normal rate, 0 while paused. Samples are
+ * published through a seqlock, so Read() never blocks and never sees a torn sample. Writers
+ * (Publish, Invalidate and the refresh handshake) are serialized by a mutex.
+ *
+ * The extrapolation error of a read is bounded by |actual speed - slope| times the sample age;
+ * callers bound the age by refreshing once it exceeds their sampling interval.
+ */
+class PlayerPositionClock
+{
+public:
+	PlayerPositionClock();
+	PlayerPositionClock(const PlayerPositionClock &) = delete;
+	PlayerPositionClock &operator=(const PlayerPositionClock &) = delete;
+
+	/**
+	 * @brief Current monotonic time in microseconds, the time base of samples and reads
+	 */
+	static int64_t NowUs();
+
+	/**
+	 * @brief Read the position extrapolated to nowUs
+	 * @param[in] nowUs monotonic time of the read
+	 * @param[out] positionMs extrapolated position, untouched if there is no sample
+	 * @param[out] ageUs time since the sample was taken, untouched if there is no sample
+	 * @return true if a sample is available, false before the first sample or after Invalidate()
+	 */
+	bool Read(int64_t nowUs, long long &positionMs, int64_t &ageUs) const;
+
+	/**
+	 * @brief Claim the right to sample the pipeline
+	 * @return false if another thread is already sampling; the caller then uses the published sample
+	 */
+	bool TryBeginRefresh();
+
+	/**
+	 * @brief Publish a sample taken since TryBeginRefresh(); dropped if Invalidate() ran in between
+	 */
+	void Publish(long long positionMs, int64_t timestampUs, double slope);
+
+	/**
+	 * @brief Release the claim taken by TryBeginRefresh()
+	 */
+	void EndRefresh();
+
+	/**
+	 * @brief Discard the sample, e.g. on seek, rate or state change; in-flight refreshes are not published
+	 */
+	void Invalidate();
+
+private:
+	std::atomic<uint32_t> mSequence;     /**< odd while a sample is being written */
+	std::atomic<bool> mValid;
+	std::atomic<long long> mPositionMs;
+	std::atomic<int64_t> mTimestampUs;
+	std::atomic<double> mSlope;
+
+	std::mutex mWriteMutex;
+	bool mRefreshing;
+	uint32_t mEpoch;                     /**< bumped by Invalidate() */
+	uint32_t mRefreshEpoch;              /**< epoch seen by the current refresh */
+};
+
+#endif /* PLAYER_POSITION_CLOCK_H */
@@ -26,16 +26,60 @@
 #include <gst/gst.h>
 #include "gstplayertaskpool.h"
 #include <pthread.h>
+#include <sched.h>
+#include <errno.h>
+#include <unistd.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
 
+/** Time a parked worker waits for a new task before exiting */
+#define PLAYER_TASKPOOL_IDLE_TIMEOUT_US (30 * G_TIME_SPAN_SECOND)
 
 /**
- * @brief PlayerGstTaskId to store the threadId
+ * @brief Scheduling resolved at push time, applied by the worker before running the task
  */
 typedef struct
 {
-  pthread_t thread;
+  gint policy;
+  gint priority;
+  gint nice;
+  gboolean set_affinity;
+  cpu_set_t cpus;
+} PlayerGstTaskSched;
+
+/**
+ * @brief PlayerGstTaskId to track one pushed task until it is joined
+ */
+typedef struct
+{
+  GstTaskPoolFunction func;
+  gpointer data;
+  PlayerGstTaskSched sched;
+  GMutex lock;
+  GCond cond;
+  gboolean done;
 } PlayerGstTaskId;
 
+/**
+ * @brief A worker thread; runs tasks until no new one arrives within the idle timeout
+ */
+typedef struct
+{
+  pthread_t thread;
+  GCond wake;
+  PlayerGstTaskId *job;         /**< protected by worker_lock */
+  gboolean retire;              /**< set when the idle limit shrinks, protected by worker_lock */
+  PlayerGstTaskSched sched;     /**< scheduling the thread runs with, written only by the worker */
+  gboolean sched_ok;            /**< sched was applied in full; only such workers are parked */
+} PlayerGstWorker;
+
+/* Workers are shared by all pools so threads survive the pipeline that created them */
+static GMutex worker_lock;
+static GQueue idle_workers = G_QUEUE_INIT;
+static guint max_idle_workers = 0;
+/* Parked thread limit requested per owner; max_idle_workers is the largest of them */
+static GHashTable *idle_requests = NULL;
+
 /** class initialization */
 #define gst_player_taskpool_parent_class parent_class
 G_DEFINE_TYPE(GstPlayerTaskpool, gst_player_taskpool, GST_TYPE_TASK_POOL);
@@ -43,18 +87,164 @@ G_DEFINE_TYPE(GstPlayerTaskpool, gst_player_taskpool, GST_TYPE_TASK_POOL);
 GST_DEBUG_CATEGORY(gst_player_taskpool_debug_category);
 #define GST_CAT_DEFAULT gst_player_taskpool_debug_category
 
+static GQuark gst_player_taskpool_class_quark (void)
+{
+  static GQuark quark = g_quark_from_static_string ("player-taskpool-class");
+  return quark;
+}
+
+/**
+ * @brief Apply scheduling to the calling worker; failures (e.g. no CAP_SYS_NICE for SCHED_FIFO)
+ *        leave the thread running with its current settings
+ * @return TRUE if every setting was applied
+ */
+static gboolean player_taskpool_apply_sched (const PlayerGstTaskSched * sched)
+{
+  struct sched_param param = { 0 };
+  gboolean ok = TRUE;
+  gint res;
+
+  if (sched->set_affinity) {
+    res = pthread_setaffinity_np (pthread_self (), sizeof (cpu_set_t), &sched->cpus);
+    if (res != 0) {
+      GST_WARNING ("pthread_setaffinity_np failed: %s", g_strerror (res));
+      ok = FALSE;
+    }
+  }
+  param.sched_priority = sched->priority;
+  res = pthread_setschedparam (pthread_self (), sched->policy, &param);
+  if (res != 0) {
+    GST_WARNING ("pthread_setschedparam(%d, %d) failed: %s", sched->policy, sched->priority,
+        g_strerror (res));
+    ok = FALSE;
+  }
+  /* nice is per thread on Linux and kept across policy changes, so set it for FIFO and RR too */
+  if (setpriority (PRIO_PROCESS, (id_t) syscall (SYS_gettid), sched->nice) != 0) {
+    GST_WARNING ("setpriority(%d) failed: %s", sched->nice, g_strerror (errno));
+    ok = FALSE;
+  }
+  return ok;
+}
+
+/**
+ * @brief Whether a thread running with a can run a task resolved to b without changing anything
+ */
+static gboolean player_taskpool_sched_equal (const PlayerGstTaskSched * a, const PlayerGstTaskSched * b)
+{
+  return a->policy == b->policy && a->priority == b->priority && a->nice == b->nice &&
+      a->set_affinity == b->set_affinity && (!a->set_affinity || CPU_EQUAL (&a->cpus, &b->cpus));
+}
+
+/**
+ * @brief Resolve the configured scheduling of a task class; unset fields come from the calling
+ *        thread, matching what a thread created by it would have inherited
+ */
+static void player_taskpool_resolve_sched (GstPlayerTaskpool * pool, guint task_class,
+    PlayerGstTaskSched * sched)
+{
+  GstPlayerTaskpoolSched copy;
+  const GstPlayerTaskpoolSched *config = &copy;
+  struct sched_param param = { 0 };
+
+  GST_OBJECT_LOCK (pool);
+  copy = pool->sched[task_class];
+  GST_OBJECT_UNLOCK (pool);
+
+  errno = 0;
+  sched->nice = getpriority (PRIO_PROCESS, (id_t) syscall (SYS_gettid));
+  if (errno != 0) {
+    sched->nice = 0;
+  }
+  if (config->policy == GST_PLAYER_TASKPOOL_SCHED_INHERIT) {
+    pthread_getschedparam (pthread_self (), &sched->policy, &param);
+    sched->priority = param.sched_priority;
+  } else {
+    sched->policy = config->policy;
+    sched->priority = (config->policy == SCHED_OTHER) ? 0 : config->priority;
+    if (config->policy == SCHED_OTHER) {
+      sched->nice = config->nice;
+    }
+  }
+
+  CPU_ZERO (&sched->cpus);
+  if (config->cpu_mask) {
+    for (guint cpu = 0; cpu < 64 && cpu < CPU_SETSIZE; cpu++) {
+      if (config->cpu_mask & ((guint64) 1 << cpu)) {
+        CPU_SET (cpu, &sched->cpus);
+      }
+    }
+    sched->set_affinity = TRUE;
+  } else {
+    sched->set_affinity =
+        (pthread_getaffinity_np (pthread_self (), sizeof (cpu_set_t), &sched->cpus) == 0);
+  }
+}
+
+/**
+ * @brief Worker thread body; parks between tasks while fewer than max_idle_workers are parked.
+ *        A worker whose scheduling could not be applied in full is not parked, as it does not
+ *        run with the settings it would be matched on.
+ */
+static void *player_taskpool_worker (void *arg)
+{
+  PlayerGstWorker *worker = (PlayerGstWorker *) arg;
+  gboolean parked;
+
+  g_mutex_lock (&worker_lock);
+  while (worker->job) {
+    PlayerGstTaskId *tid = worker->job;
+    g_mutex_unlock (&worker_lock);
+
+    if (!worker->sched_ok || !player_taskpool_sched_equal (&worker->sched, &tid->sched)) {
+      worker->sched = tid->sched;
+      worker->sched_ok = player_taskpool_apply_sched (&tid->sched);
+    }
+    tid->func (tid->data);
+
+    g_mutex_lock (&worker_lock);
+    worker->job = NULL;
+    parked = worker->sched_ok && g_queue_get_length (&idle_workers) < max_idle_workers;
+    if (parked) {
+      g_queue_push_tail (&idle_workers, worker);
+    }
+    g_mutex_unlock (&worker_lock);
+
+    /* parked before done is signalled so a push right after the join finds this worker;
+     * tid may be freed by join as soon as done is seen */
+    g_mutex_lock (&tid->lock);
+    tid->done = TRUE;
+    g_cond_signal (&tid->cond);
+    g_mutex_unlock (&tid->lock);
+
+    g_mutex_lock (&worker_lock);
+    if (!parked) {
+      break;
+    }
+    gint64 deadline = g_get_monotonic_time () + PLAYER_TASKPOOL_IDLE_TIMEOUT_US;
+    while (!worker->job && !worker->retire) {
+      if (!g_cond_wait_until (&worker->wake, &worker_lock, deadline) && !worker->job) {
+        g_queue_remove (&idle_workers, worker);
+        break;
+      }
+    }
+  }
+  g_mutex_unlock (&worker_lock);
+
+  g_cond_clear (&worker->wake);
+  g_free (worker);
+  return NULL;
+}
+
 /**
  * @brief Override for gst_task_pool_push
- *        Start the execution of a new thread from pool.
- *        In this case create and assign a thread for gst task
+ *        Run the task on a parked worker thread already running with the task's resolved
+ *        scheduling, or on a new one if none matches.
  *
- *        Not setting any specific policies or priorities for now
- *        as the pthread implementation takes thread attributes automatically
- *        from the calling thread.
- *
- *        For now we just need same priority for PLAYER gst threads, and if enabled
- *        RT priority is set on PLAYER thread which setup the pipeline thus the gst
- *        threads also get same priority
+ *        The thread gets the scheduling configured for the task's class with
+ *        gst_player_taskpool_set_sched(). By default that is the policy, priority,
+ *        nice value and affinity of the calling thread, as for a thread it created itself,
+ *        so RT priority set on the PLAYER thread which sets up the pipeline still carries
+ *        over to the gst threads.
  *
  * @param pool GstTaskPool
  * @param func the function to call
@@ -66,14 +256,58 @@ static gpointer gst_player_taskpool_push (GstTaskPool * pool, GstTaskPoolFunctio
     GError ** error)
 {
   PlayerGstTaskId *tid;
+  PlayerGstWorker *worker;
+  pthread_attr_t attr;
+  guint task_class = 0;
   gint res;
 
+  /* GstTask pushes itself as data */
+  if (data && GST_IS_TASK (data)) {
+    task_class = GPOINTER_TO_UINT (g_object_get_qdata (G_OBJECT (data),
+            gst_player_taskpool_class_quark ()));
+    task_class = task_class ? task_class - 1 : 0;
+  }
+
   tid = g_new0 (PlayerGstTaskId, 1);
-  res = pthread_create (&tid->thread, NULL, (void *(*)(void *)) func, data);
+  tid->func = func;
+  tid->data = data;
+  g_mutex_init (&tid->lock);
+  g_cond_init (&tid->cond);
+  player_taskpool_resolve_sched (GST_PLAYER_TASKPOOL (pool), task_class, &tid->sched);
+
+  g_mutex_lock (&worker_lock);
+  worker = NULL;
+  for (GList *link = idle_workers.head; link; link = link->next) {
+    PlayerGstWorker *idle = (PlayerGstWorker *) link->data;
+    if (player_taskpool_sched_equal (&idle->sched, &tid->sched)) {
+      g_queue_delete_link (&idle_workers, link);
+      worker = idle;
+      break;
+    }
+  }
+  if (worker) {
+    worker->job = tid;
+    g_cond_signal (&worker->wake);
+    g_mutex_unlock (&worker_lock);
+    return tid;
+  }
+  g_mutex_unlock (&worker_lock);
+
+  worker = g_new0 (PlayerGstWorker, 1);
+  g_cond_init (&worker->wake);
+  worker->job = tid;
+  pthread_attr_init (&attr);
+  pthread_attr_setdetachstate (&attr, PTHREAD_CREATE_DETACHED);
+  res = pthread_create (&worker->thread, &attr, player_taskpool_worker, worker);
+  pthread_attr_destroy (&attr);
 
   if (res != 0) {
     g_set_error (error, G_THREAD_ERROR, G_THREAD_ERROR_AGAIN,
         "Error creating thread: %s", g_strerror (res));
+    g_cond_clear (&worker->wake);
+    g_free (worker);
+    g_mutex_clear (&tid->lock);
+    g_cond_clear (&tid->cond);
     g_free (tid);
     tid = NULL;
   }
@@ -82,19 +316,92 @@ static gpointer gst_player_taskpool_push (GstTaskPool * pool, GstTaskPoolFunctio
 
 /**
  * @brief Override for gst_task_pool_join
- *        Used to join the created thread
+ *        Wait for the task to return; its worker thread stays available for reuse
  * @param pool GstTaskPool
- * @param id TaskId containing the thread info to join
+ * @param id TaskId containing the task info to join
  */
 static void gst_player_taskpool_join (GstTaskPool * pool, gpointer id)
 {
   PlayerGstTaskId *tid = (PlayerGstTaskId *) id;
 
-  pthread_join (tid->thread, NULL);
+  g_mutex_lock (&tid->lock);
+  while (!tid->done) {
+    g_cond_wait (&tid->cond, &tid->lock);
+  }
+  g_mutex_unlock (&tid->lock);
 
+  g_mutex_clear (&tid->lock);
+  g_cond_clear (&tid->cond);
   g_free (tid);
 }
 
+/**
+ * @brief Set the scheduling of the threads running tasks of task_class on this pool
+ * @param pool GstPlayerTaskpool
+ * @param task_class class index below GST_PLAYER_TASKPOOL_MAX_CLASSES
+ * @param sched scheduling to apply
+ */
+void gst_player_taskpool_set_sched (GstPlayerTaskpool * pool, guint task_class,
+    const GstPlayerTaskpoolSched * sched)
+{
+  g_return_if_fail (GST_IS_PLAYER_TASKPOOL (pool));
+  g_return_if_fail (task_class < GST_PLAYER_TASKPOOL_MAX_CLASSES);
+  g_return_if_fail (sched != NULL);
+
+  GST_OBJECT_LOCK (pool);
+  pool->sched[task_class] = *sched;
+  GST_OBJECT_UNLOCK (pool);
+}
+
+/**
+ * @brief Tag a task with its class before it is started
+ * @param task GstTask
+ * @param task_class class index below GST_PLAYER_TASKPOOL_MAX_CLASSES
+ */
+void gst_player_taskpool_set_task_class (GstTask * task, guint task_class)
+{
+  g_return_if_fail (GST_IS_TASK (task));
+  g_return_if_fail (task_class < GST_PLAYER_TASKPOOL_MAX_CLASSES);
+
+  g_object_set_qdata (G_OBJECT (task), gst_player_taskpool_class_quark (),
+      GUINT_TO_POINTER (task_class + 1));
+}
+
+/**
+ * @brief Request a number of finished worker threads kept parked for reuse, shared by all pools
+ * @param owner identifies the requester; each owner has one request, replaced by the next call
+ * @param max_idle 0 withdraws the owner's request
+ */
+void gst_player_taskpool_set_max_idle_threads (gconstpointer owner, guint max_idle)
+{
+  GHashTableIter iter;
+  gpointer value;
+
+  g_return_if_fail (owner != NULL);
+
+  g_mutex_lock (&worker_lock);
+  if (!idle_requests) {
+    idle_requests = g_hash_table_new (g_direct_hash, g_direct_equal);
+  }
+  if (max_idle) {
+    g_hash_table_insert (idle_requests, (gpointer) owner, GUINT_TO_POINTER (max_idle));
+  } else {
+    g_hash_table_remove (idle_requests, owner);
+  }
+  max_idle_workers = 0;
+  g_hash_table_iter_init (&iter, idle_requests);
+  while (g_hash_table_iter_next (&iter, NULL, &value)) {
+    max_idle_workers = MAX (max_idle_workers, GPOINTER_TO_UINT (value));
+  }
+  /* surplus parked workers exit now instead of at their idle timeout */
+  while (g_queue_get_length (&idle_workers) > max_idle_workers) {
+    PlayerGstWorker *worker = (PlayerGstWorker *) g_queue_pop_tail (&idle_workers);
+    worker->retire = TRUE;
+    g_cond_signal (&worker->wake);
+  }
+  g_mutex_unlock (&worker_lock);
+}
+
 
 /**
  * @brief class_init function for gst_player_taskpool
@@ -117,4 +424,10 @@ static void gst_player_taskpool_class_init (GstPlayerTaskpoolClass * klass)
  */
 static void gst_player_taskpool_init (GstPlayerTaskpool * pool)
 {
+  for (guint i = 0; i < GST_PLAYER_TASKPOOL_MAX_CLASSES; i++) {
+    pool->sched[i].policy = GST_PLAYER_TASKPOOL_SCHED_INHERIT;
+    pool->sched[i].priority = 0;
+    pool->sched[i].nice = 0;
+    pool->sched[i].cpu_mask = 0;
+  }
 }
@@ -41,11 +41,27 @@ G_BEGIN_DECLS
 #define GST_PLAYER_TASKPOOL_GET_CLASS(pool)  (G_TYPE_INSTANCE_GET_CLASS ((pool), GST_TYPE_PLAYER_TASKPOOL, GstPlayerTaskpoolClass))
 #define GST_PLAYER_TASKPOOL_CAST(pool)       ((GstPlayerTaskpool*)(pool))
 
+/** Number of task classes a pool keeps scheduling settings for */
+#define GST_PLAYER_TASKPOOL_MAX_CLASSES 4
+/** Policy value taking policy, priority and nice value from the thread that starts the task */
+#define GST_PLAYER_TASKPOOL_SCHED_INHERIT (-1)
+
 typedef struct _GstPlayerTaskpool GstPlayerTaskpool;
 typedef struct _GstPlayerTaskpoolClass GstPlayerTaskpoolClass;
 
+/**
+ * @brief Scheduling applied to the streaming threads of one task class
+ */
+typedef struct {
+  gint policy;          /**< SCHED_OTHER, SCHED_FIFO, SCHED_RR or GST_PLAYER_TASKPOOL_SCHED_INHERIT */
+  gint priority;        /**< sched_priority for SCHED_FIFO and SCHED_RR */
+  gint nice;            /**< nice value for SCHED_OTHER; other policies keep the nice value of the starting thread */
+  guint64 cpu_mask;     /**< CPUs 0..63 the threads may run on; 0 inherits the affinity of the starting thread */
+} GstPlayerTaskpoolSched;
+
 struct _GstPlayerTaskpool {
   GstTaskPool    object;
+  GstPlayerTaskpoolSched sched[GST_PLAYER_TASKPOOL_MAX_CLASSES];
 };
 
 struct _GstPlayerTaskpoolClass {
@@ -54,6 +70,27 @@ struct _GstPlayerTaskpoolClass {
 
 GType           gst_player_taskpool_get_type    (void);
 
+/**
+ * @brief Set the scheduling of the threads running tasks of task_class on this pool
+ */
+void            gst_player_taskpool_set_sched   (GstPlayerTaskpool * pool, guint task_class,
+                                                 const GstPlayerTaskpoolSched * sched);
+
+/**
+ * @brief Tag a task with its class before it is started; untagged tasks use class 0
+ */
+void            gst_player_taskpool_set_task_class (GstTask * task, guint task_class);
+
+/**
+ * @brief Request finished worker threads to be kept parked for reuse. Parked threads are shared
+ *        by all pools and the largest request of any owner applies, so one owner asking for 0
+ *        does not end threads another still wants. A parked thread is only reused for a task
+ *        resolving to the scheduling it already runs with.
+ * @param owner one request per owner, replaced by its next call
+ * @param max_idle 0 withdraws the owner's request
+ */
+void            gst_player_taskpool_set_max_idle_threads (gconstpointer owner, guint max_idle);
+
 
 G_END_DECLS
 
@@ -22,10 +22,17 @@
 #include <cstdint>
 #include <stddef.h>
 #include <vector>
+#include <deque>
+#include <list>
+#include <memory>
+#include <string>
+#include <utility>
 #include <assert.h>
 #include <inttypes.h>
 #include <cstdio>
 #include <cstring> // for memcpy
+#include <strings.h> // for strncasecmp
+#include <cctype>
 #include <gst/app/gstappsrc.h>
 
 #define PRINTF(...)
@@ -38,13 +45,70 @@
 		(static_cast<uint32_t>(Text[3])) )
 //#Conversion of text in to decimal value
 
+#if defined(__BYTE_ORDER__) && (__BYTE_ORDER__ == __ORDER_BIG_ENDIAN__)
+#define MP4_BE16(x) (x)
+#define MP4_BE32(x) (x)
+#define MP4_BE64(x) (x)
+#else
+#define MP4_BE16(x) __builtin_bswap16(x)
+#define MP4_BE32(x) __builtin_bswap32(x)
+#define MP4_BE64(x) __builtin_bswap64(x)
+#endif
+
+/**
+ * @brief unaligned big endian loads; callers are responsible for bounds checking
+ */
+static inline uint16_t Mp4LoadU16( const uint8_t *p )
+{
+	uint16_t v;
+	memcpy( &v, p, sizeof(v) );
+	return MP4_BE16(v);
+}
+static inline uint32_t Mp4LoadU32( const uint8_t *p )
+{
+	uint32_t v;
+	memcpy( &v, p, sizeof(v) );
+	return MP4_BE32(v);
+}
+static inline uint64_t Mp4LoadU64( const uint8_t *p )
+{
+	uint64_t v;
+	memcpy( &v, p, sizeof(v) );
+	return MP4_BE64(v);
+}
+
+/**
+ * @brief Common Encryption (ISO/IEC 23001-7) parameters of one sample, from senc or saiz/saio
+ */
+struct Mp4SampleEncryption
+{
+	uint8_t iv[16];
+	uint8_t iv_size; // 0 when the track uses a constant IV (cbcs)
+	std::vector<std::pair<uint16_t,uint32_t>> subsamples; // clear and protected byte counts
+};
+
 struct Mp4Sample
 {
 	const uint8_t *ptr;
 	size_t len;
-	double pts;
-	double dts;
-	double duration;
+	int64_t pts; // timestamps in media timescale units, converted once when the buffer is created
+	uint64_t dts;
+	uint32_t duration;
+	bool carried; // bytes straddled chunks and were reassembled in demux owned storage
+	std::shared_ptr<const Mp4SampleEncryption> encryption; // NULL for clear samples
+};
+
+/**
+ * @brief sample announced by a moof whose mdat bytes are still arriving (chunked parsing)
+ */
+struct Mp4PendingSample
+{
+	uint64_t offset; // absolute stream offset of the sample data
+	size_t len;
+	int64_t pts; // media timescale units
+	uint64_t dts;
+	uint32_t duration;
+	std::shared_ptr<const Mp4SampleEncryption> encryption;
 };
 
 class InitializationHeaderInfo
@@ -103,6 +167,10 @@ private:
 	std::vector<Mp4Sample> samples;
 	const uint8_t *moof_ptr; // base address for sample data
 	const uint8_t *ptr; // parsing state
+	const uint8_t *limit; // end of the data being parsed; readers never go past it
+	bool truncated; // a read was clipped at limit
+	const uint8_t *fragment_ptr; // start of the parsed fragment
+	size_t fragment_len;
 
 	uint8_t version;
 	uint32_t flags;
@@ -114,6 +182,46 @@ private:
 	uint32_t default_sample_duration;
 	uint32_t default_sample_size;
 	uint32_t default_sample_flags;
+	uint32_t trex_default_sample_duration; // defaults from moov, tfhd overrides apply to a single traf
+	uint32_t trex_default_sample_size;
+	uint32_t trex_default_sample_flags;
+	GstCaps *caps; // caps built from the most recent init header
+
+	// chunked (low latency) parsing state, see ParseChunk
+	enum ChunkState
+	{
+		eCHUNK_BOX_HEADER, // collecting a top level box header
+		eCHUNK_BOX_BODY,   // collecting a complete top level box other than mdat
+		eCHUNK_MDAT        // streaming mdat payload
+	} chunkState;
+	std::vector<uint8_t> boxBuf; // partial top level box
+	uint64_t boxStart; // absolute stream offset of the box being collected
+	uint64_t boxSize; // size of the box being collected, 0 until its header is complete
+	uint64_t streamOffset; // absolute stream offset of the next unconsumed byte
+	uint64_t mdatEnd; // absolute end of the current mdat
+	std::deque<Mp4PendingSample> pendingSamples; // announced by moof, waiting for mdat bytes
+	std::vector<uint8_t> sampleCarry; // head of a sample straddling chunks
+	std::list<std::vector<uint8_t>> carried; // reassembled samples, valid until the next parse
+	bool initHeaderParsed; // moov seen during the last ParseChunk
+
+	// Common Encryption; track defaults from the init header (sinf, pssh), per sample data from each traf
+	bool isProtected; // encv/enca sample entry with tenc default_isProtected set
+	uint32_t original_format; // frma
+	uint32_t scheme_type; // schm, 'cenc' or 'cbcs'
+	uint8_t default_kid[16];
+	uint8_t default_iv_size;
+	uint8_t default_crypt_byte_block;
+	uint8_t default_skip_byte_block;
+	uint8_t constant_iv_size;
+	uint8_t constant_iv[16];
+	std::vector<std::string> protection_systems; // system ids of the init header pssh boxes, in order
+	std::string preferred_protection_system; // system id of the DRM the player uses, see setPreferredProtectionSystem
+	std::vector<std::shared_ptr<const Mp4SampleEncryption>> traf_encryption; // senc entries of the current traf
+	uint8_t saiz_default_size; // saiz/saio locate the aux info when a traf carries no senc
+	std::vector<uint8_t> saiz_sizes;
+	uint32_t saiz_count;
+	uint64_t saio_offset;
+	bool saio_present;
 	uint64_t creation_time;
 	uint64_t modification_time;
 	uint32_t duration;
@@ -126,41 +234,68 @@ private:
 	uint32_t height;
 	uint16_t language;
 	
-	uint64_t ReadBytes( int n )
+	/**
+	 * @brief check that n bytes can be read; on failure parsing is clipped to limit
+	 */
+	bool Available( size_t n )
 	{
-		uint64_t rc = 0;
-		for( int i=0; i<n; i++ )
+		if( (size_t)(limit - ptr) >= n )
 		{
-			rc <<= 8;
-			rc |= *ptr++;
+			return true;
 		}
-		return rc;
+		truncated = true;
+		ptr = limit;
+		return false;
+	}
+	uint8_t ReadU8()
+	{
+		return Available(1)?*ptr++:0;
 	}
 	uint16_t ReadU16()
 	{
-		return (uint16_t)ReadBytes(2);
+		if( !Available(2) ) return 0;
+		uint16_t rc = Mp4LoadU16(ptr);
+		ptr += 2;
+		return rc;
 	}
 	uint32_t ReadU32()
 	{
-		return (uint32_t)ReadBytes(4);
+		if( !Available(4) ) return 0;
+		uint32_t rc = Mp4LoadU32(ptr);
+		ptr += 4;
+		return rc;
 	}
 	int32_t ReadI32()
 	{
-		return (int32_t)ReadBytes(4);
+		return (int32_t)ReadU32();
 	}
 	uint64_t ReadU64()
 	{
-		return ReadBytes(8);
+		if( !Available(8) ) return 0;
+		uint64_t rc = Mp4LoadU64(ptr);
+		ptr += 8;
+		return rc;
+	}
+	/**
+	 * @brief read a field that is 64 bit in version 1 boxes and 32 bit otherwise
+	 */
+	uint64_t ReadVersionedU64( void )
+	{
+		return (version==1)?ReadU64():ReadU32();
 	}
 	void ReadHeader( void )
 	{
-		version = *ptr++;
-		flags = (uint32_t)ReadBytes(3);
+		uint32_t versionAndFlags = ReadU32();
+		version = (uint8_t)(versionAndFlags>>24);
+		flags = versionAndFlags&0xffffff;
 	}
 	void SkipBytes( size_t len )
 	{
 		PRINTF( "skipping %zu bytes\n", len );
-		ptr += len;
+		if( Available(len) )
+		{
+			ptr += len;
+		}
 	}
 
 	void parseMovieFragmentHeaderBox( void )
@@ -174,6 +309,9 @@ private:
 	void parseTrackFragmentHeaderBox( void )
 	{
 		ReadHeader();
+		default_sample_duration = trex_default_sample_duration;
+		default_sample_size = trex_default_sample_size;
+		default_sample_flags = trex_default_sample_flags;
 		track_id = ReadU32();
 		PRINTF( "track_id=%" PRIu32 "\n", track_id );
 		if (flags & 0x00001)
@@ -206,13 +344,88 @@ private:
 	void parseTrackFragmentBaseMediaDecodeTimeBox( void  )
 	{
 		ReadHeader();
-		int sz = (version==1)?8:4;
-		baseMediaDecodeTime  = ReadBytes(sz);
+		baseMediaDecodeTime  = ReadVersionedU64();
 		PRINTF( "baseMediaDecodeTime: %" PRIu64 "\n", baseMediaDecodeTime );
 	}
 	
+	/**
+	 * @brief decode the per-sample entries of a trun
+	 * Specialised on the optional per-sample fields so the loop carries no flag tests; the
+	 * entry table is bounds checked once up front.
+	 */
+	template<bool HAS_DURATION, bool HAS_SIZE, bool HAS_FLAGS, bool HAS_CTO>
+	void parseTrackFragmentRunSamples( uint32_t sample_count, const uint8_t *data_ptr )
+	{
+		const size_t entry_size = 4*(HAS_DURATION+HAS_SIZE+HAS_FLAGS+HAS_CTO);
+		if( entry_size && sample_count > (size_t)(limit - ptr)/entry_size )
+		{
+			truncated = true;
+			sample_count = (uint32_t)((size_t)(limit - ptr)/entry_size);
+		}
+		samples.reserve( samples.size() + sample_count );
+		const uint8_t *entry = ptr;
+		uint64_t dts = baseMediaDecodeTime;
+		for( uint32_t i=0; i<sample_count; i++ )
+		{
+			uint32_t sample_duration = default_sample_duration;
+			uint32_t sample_size = default_sample_size;
+			int32_t sample_composition_time_offset = 0;
+			if( HAS_DURATION )
+			{
+				sample_duration = Mp4LoadU32(entry);
+				entry += 4;
+			}
+			if( HAS_SIZE )
+			{
+				sample_size = Mp4LoadU32(entry);
+				entry += 4;
+			}
+			if( HAS_FLAGS )
+			{ // sample_flags, rarely present and not used
+				entry += 4;
+			}
+			if( HAS_CTO )
+			{ // for samples where pts and dts differ (overriding 'trex')
+				sample_composition_time_offset = (int32_t)Mp4LoadU32(entry);
+				entry += 4;
+			}
+			Mp4Sample sample;
+			sample.ptr = data_ptr;
+			sample.len = sample_size;
+			sample.duration = sample_duration;
+			sample.dts = dts;
+			sample.pts = (int64_t)dts+sample_composition_time_offset;
+			sample.carried = false;
+			PRINTF( "[FRAME] %" PRIu32 " len=%zu dts=%" PRIu64 " pts=%" PRId64 "\n", i, sample.len, sample.dts, sample.pts );
+			data_ptr += sample_size;
+			dts += sample_duration;
+			samples.push_back( sample );
+		}
+		ptr = entry;
+	}
+
 	void parseTrackFragmentRunBox( void )
 	{
+		typedef void (Mp4Demux::*TrunDecoder)( uint32_t, const uint8_t * );
+		static const TrunDecoder decoders[16] =
+		{ // indexed by trun flags 0x100 duration, 0x200 size, 0x400 flags, 0x800 composition time offset
+			&Mp4Demux::parseTrackFragmentRunSamples<false,false,false,false>,
+			&Mp4Demux::parseTrackFragmentRunSamples<true, false,false,false>,
+			&Mp4Demux::parseTrackFragmentRunSamples<false,true, false,false>,
+			&Mp4Demux::parseTrackFragmentRunSamples<true, true, false,false>,
+			&Mp4Demux::parseTrackFragmentRunSamples<false,false,true, false>,
+			&Mp4Demux::parseTrackFragmentRunSamples<true, false,true, false>,
+			&Mp4Demux::parseTrackFragmentRunSamples<false,true, true, false>,
+			&Mp4Demux::parseTrackFragmentRunSamples<true, true, true, false>,
+			&Mp4Demux::parseTrackFragmentRunSamples<false,false,false,true >,
+			&Mp4Demux::parseTrackFragmentRunSamples<true, false,false,true >,
+			&Mp4Demux::parseTrackFragmentRunSamples<false,true, false,true >,
+			&Mp4Demux::parseTrackFragmentRunSamples<true, true, false,true >,
+			&Mp4Demux::parseTrackFragmentRunSamples<false,false,true, true >,
+			&Mp4Demux::parseTrackFragmentRunSamples<true, false,true, true >,
+			&Mp4Demux::parseTrackFragmentRunSamples<false,true, true, true >,
+			&Mp4Demux::parseTrackFragmentRunSamples<true, true, true, true >,
+		};
 		ReadHeader();
 		uint32_t sample_count = ReadU32();
 		PRINTF( "sample_number=%" PRIu32 "\n", sample_count );
@@ -228,68 +441,25 @@ private:
 		{ // mandatory field? should never reach here
 			assert(0);
 		}
-		uint32_t sample_flags = 0;
 		if(flags & 0x0004)
 		{
-			sample_flags = ReadU32();
-			(void)sample_flags;
-			PRINTF( "first_sample_flags=0x%" PRIx32 "\n", sample_flags );
-		}
-		uint64_t dts = baseMediaDecodeTime;
-		for( unsigned int i=0; i<sample_count; i++ )
-		{
-			struct Mp4Sample sample;
-			sample.ptr = data_ptr;
-			sample.len = default_sample_size;
-			sample.pts = 0.0;
-			sample.dts = 0.0;
-			sample.duration = 0.0;
-			PRINTF( "[FRAME] %d\n", i );
-			uint32_t sample_duration = default_sample_duration;
-			if (flags & 0x0100)
-			{
-				sample_duration = ReadU32();
-				PRINTF( "sample_duration=%" PRIu32 "\n", sample_duration );
-				sample.duration = sample_duration / (double)timescale;
-			}
-			if (flags & 0x0200)
-			{
-				uint32_t sample_size = ReadU32();
-				PRINTF( "sample_size=%" PRIu32 "\n", sample_size );
-				sample.len = sample_size;
-			}
-			data_ptr += sample.len;
-			if (flags & 0x0400)
-			{ // rarely present?
-				sample_flags = ReadU32();
-				(void)sample_flags;
-				PRINTF( "sample_flags=0x%" PRIx32 "\n", sample_flags );
-			}
-			int32_t sample_composition_time_offset = 0;
-			if (flags & 0x0800)
-			{ // for samples where pts and dts differ (overriding 'trex')
-				sample_composition_time_offset = ReadI32();
-				PRINTF( "sample_composition_time_offset=%" PRIi32 "\n", sample_composition_time_offset );
-			}
-			sample.dts = dts/(double)timescale;
-			sample.pts = (dts+sample_composition_time_offset)/(double)timescale;
-			PRINTF( "dts=%f pts=%f\n", sample.dts, sample.pts );
-			dts += sample_duration;
-			samples.push_back( sample );
+			uint32_t first_sample_flags = ReadU32();
+			(void)first_sample_flags;
+			PRINTF( "first_sample_flags=0x%" PRIx32 "\n", first_sample_flags );
 		}
+		(this->*decoders[(flags>>8)&0xf])( sample_count, data_ptr );
 	}
 	
 	void parseMovieHeaderBox( void )
 	{
 		ReadHeader();
-		int sz = (version==1)?8:4;
-		creation_time = ReadBytes(sz);
-		modification_time = ReadBytes(sz);
+		creation_time = ReadVersionedU64();
+		modification_time = ReadVersionedU64();
 		timescale = ReadU32();
 		duration = ReadU32();
 		rate = ReadU32();
 		volume = ReadU32(); // fixed point
-		ptr += 8;
+		SkipBytes(8);
 		for( int  i=0; i<9; i++ )
 		{
 			matrix[i] = ReadI32();
@@ -310,16 +480,19 @@ private:
 		default_sample_duration = ReadU32();
 		default_sample_size = ReadU32();
 		default_sample_flags = ReadU32();
+		trex_default_sample_duration = default_sample_duration;
+		trex_default_sample_size = default_sample_size;
+		trex_default_sample_flags = default_sample_flags;
 	}
 	
 	void parseTrackHeader( void )
 	{
 		ReadHeader();
 		int sz = (version==1)?8:4;
-		creation_time = ReadBytes(sz);
-		modification_time = ReadBytes(sz);
+		creation_time = ReadVersionedU64();
+		modification_time = ReadVersionedU64();
 		track_id = ReadU32();
-		ptr += 20+sz; // duration, layer, alternate_group, volume
+		SkipBytes(20+sz); // duration, layer, alternate_group, volume
 		for( int i=0; i<9; i++ )
 		{
 			matrix[i] = ReadI32();
@@ -331,9 +504,8 @@ private:
 	void parseMediaHeaderBox( void )
 	{
 		ReadHeader();
-		int sz = (version==1)?8:4;
-		creation_time = ReadBytes(sz);
-		modification_time = ReadBytes(sz);
+		creation_time = ReadVersionedU64();
+		modification_time = ReadVersionedU64();
 		timescale = ReadU32();
 		duration = ReadU32();
 		language = ReadU16();
@@ -347,6 +519,169 @@ private:
 		DemuxHelper(next, indent+1);
 	}
 		
+	void resetProtection( void )
+	{
+		isProtected = false;
+		original_format = 0;
+		scheme_type = 0;
+		memset( default_kid, 0, sizeof(default_kid) );
+		default_iv_size = 0;
+		default_crypt_byte_block = 0;
+		default_skip_byte_block = 0;
+		constant_iv_size = 0;
+		protection_systems.clear();
+	}
+
+	void parseTrackEncryptionBox( void )
+	{
+		ReadHeader();
+		SkipBytes(1); // reserved
+		uint8_t pattern = ReadU8();
+		if( version > 0 )
+		{
+			default_crypt_byte_block = pattern>>4;
+			default_skip_byte_block = pattern&0xf;
+		}
+		isProtected = (ReadU8() != 0);
+		default_iv_size = ReadU8();
+		if( !Available(sizeof(default_kid)) ) return;
+		memcpy( default_kid, ptr, sizeof(default_kid) );
+		ptr += sizeof(default_kid);
+		constant_iv_size = 0;
+		if( isProtected && default_iv_size == 0 )
+		{
+			uint8_t size = ReadU8();
+			if( size <= sizeof(constant_iv) && Available(size) )
+			{
+				memcpy( constant_iv, ptr, size );
+				ptr += size;
+				constant_iv_size = size;
+			}
+		}
+		PRINTF( "tenc protected=%d iv_size=%d\n", isProtected, default_iv_size );
+	}
+
+	void parseProtectionSystemHeader( void )
+	{
+		ReadHeader();
+		if( !Available(16) ) return;
+		char uuid[37];
+		snprintf( uuid, sizeof(uuid), "%02x%02x%02x%02x-%02x%02x-%02x%02x-%02x%02x-%02x%02x%02x%02x%02x%02x",
+				 ptr[0], ptr[1], ptr[2], ptr[3], ptr[4], ptr[5], ptr[6], ptr[7],
+				 ptr[8], ptr[9], ptr[10], ptr[11], ptr[12], ptr[13], ptr[14], ptr[15] );
+		protection_systems.push_back( uuid );
+	}
+
+	/**
+	 * @brief read one sample's IV and optional subsample map, as laid out in senc and in saio aux info
+	 */
+	std::shared_ptr<const Mp4SampleEncryption> readSampleEncryption( bool has_subsamples )
+	{
+		std::shared_ptr<Mp4SampleEncryption> entry = std::make_shared<Mp4SampleEncryption>();
+		entry->iv_size = (default_iv_size <= sizeof(entry->iv))?default_iv_size:0;
+		if( !Available(entry->iv_size) ) return NULL;
+		memcpy( entry->iv, ptr, entry->iv_size );
+		ptr += entry->iv_size;
+		if( has_subsamples )
+		{
+			uint16_t subsample_count = ReadU16();
+			if( !Available(6*(size_t)subsample_count) ) return NULL;
+			entry->subsamples.reserve( subsample_count );
+			for( uint16_t i=0; i<subsample_count; i++ )
+			{
+				uint16_t clear = Mp4LoadU16(ptr);
+				uint32_t protectedBytes = Mp4LoadU32(ptr+2);
+				ptr += 6;
+				entry->subsamples.push_back( std::make_pair(clear,protectedBytes) );
+			}
+		}
+		return entry;
+	}
+
+	void parseSampleEncryptionBox( void )
+	{
+		ReadHeader();
+		bool has_subsamples = (flags & 0x2) != 0;
+		uint32_t sample_count = ReadU32();
+		traf_encryption.clear();
+		traf_encryption.reserve( sample_count );
+		for( uint32_t i=0; i<sample_count && !truncated; i++ )
+		{
+			std::shared_ptr<const Mp4SampleEncryption> entry = readSampleEncryption( has_subsamples );
+			if( !entry ) break;
+			traf_encryption.push_back( entry );
+		}
+	}
+
+	void parseSampleAuxInfoSizesBox( void )
+	{
+		ReadHeader();
+		if( flags & 0x1 )
+		{
+			SkipBytes(8); // aux_info_type, aux_info_type_parameter
+		}
+		saiz_default_size = ReadU8();
+		saiz_count = ReadU32();
+		saiz_sizes.clear();
+		if( saiz_default_size == 0 && Available(saiz_count) )
+		{
+			saiz_sizes.assign( ptr, ptr+saiz_count );
+			ptr += saiz_count;
+		}
+	}
+
+	void parseSampleAuxInfoOffsetsBox( void )
+	{
+		ReadHeader();
+		if( flags & 0x1 )
+		{
+			SkipBytes(8); // aux_info_type, aux_info_type_parameter
+		}
+		uint32_t entry_count = ReadU32();
+		if( entry_count >= 1 )
+		{ // CMAF fragments hold a single contiguous run
+			saio_offset = ReadVersionedU64();
+			saio_present = !truncated;
+		}
+	}
+
+	/**
+	 * @brief attach senc (or saiz/saio located) encryption entries to the samples of the traf just parsed
+	 */
+	void applySampleEncryption( size_t first_sample )
+	{
+		if( !isProtected )
+		{
+			return;
+		}
+		if( traf_encryption.empty() && saio_present && saiz_count && moof_ptr )
+		{ // no senc; the aux info is addressed relative to the moof
+			const uint8_t *saved_ptr = ptr;
+			bool saved_truncated = truncated;
+			if( saio_offset < (uint64_t)(limit - moof_ptr) )
+			{
+				ptr = moof_ptr + saio_offset;
+				for( uint32_t i=0; i<saiz_count && !truncated; i++ )
+				{
+					uint8_t size = saiz_default_size?saiz_default_size:(i<saiz_sizes.size()?saiz_sizes[i]:0);
+					if( !Available(size) ) break;
+					const uint8_t *entry_end = ptr + size;
+					std::shared_ptr<const Mp4SampleEncryption> entry = readSampleEncryption( size > default_iv_size );
+					if( !entry ) break;
+					traf_encryption.push_back( entry );
+					ptr = entry_end;
+				}
+			}
+			ptr = saved_ptr;
+			truncated = saved_truncated;
+		}
+		for( size_t i=0; i<traf_encryption.size() && first_sample+i<samples.size(); i++ )
+		{
+			samples[first_sample+i].encryption = traf_encryption[i];
+		}
+		traf_encryption.clear();
+	}
+
 	void parseStreamFormat( uint32_t type, const uint8_t *next, int indent )
 	{
 		int pad;
@@ -357,6 +692,7 @@ private:
 			case MultiChar_Constant("hev1"):
 			case MultiChar_Constant("avc1"): 
 			case MultiChar_Constant("hvc1"):
+			case MultiChar_Constant("encv"): // protected video, original format in sinf/frma
 				SkipBytes(4); // always zero?
 				info.data_reference_index = ReadU32();
 				SkipBytes(16); // always zero?
@@ -374,6 +710,7 @@ private:
 				
 			case MultiChar_Constant("mp4a"): 
 			case MultiChar_Constant("ec-3"): 
+			case MultiChar_Constant("enca"): // protected audio, original format in sinf/frma
 				SkipBytes(4); // zero
 				info.data_reference_index = ReadU32();
 				SkipBytes(8); // zero
@@ -397,7 +734,8 @@ private:
 		int rc = 0;
 		for(;;)
 		{
-			unsigned char octet = *ptr++;
+			if( truncated ) return rc;
+			unsigned char octet = ReadU8();
 			rc <<= 7;
 			rc |= octet&0x7f;
 			if( (octet&0x80)==0 ) return rc;
@@ -408,8 +746,13 @@ private:
 	{
 		while( ptr < next )
 		{
-			uint32_t tag = *ptr++;
+			uint32_t tag = ReadU8();
 			uint32_t len = readLen();
+			if( truncated || len > (size_t)(next - ptr) )
+			{
+				ptr = next;
+				return;
+			}
 			const uint8_t *end = ptr + len;
 			switch( tag )
 			{
@@ -421,9 +764,9 @@ private:
 					
 				case 0x04:
 					PRINTF( "DecoderConfigDescriptor:\n");
-					info.object_type_id = *ptr++;
-					info.stream_type = *ptr++; // >>2
-					info.upStream = *ptr++;
+					info.object_type_id = ReadU8();
+					info.stream_type = ReadU8(); // >>2
+					info.upStream = ReadU8();
 					info.buffer_size = ReadU16();
 					info.maxBitrate = ReadU32();
 					info.avgBitrate = ReadU32();
@@ -435,6 +778,7 @@ private:
 				case 0x05:
 					PRINTF( "DecodeSpecificInfo:\n") ;
 					info.codec_data_len = len;
+					free( info.codec_data ); // replaces codec_data of an earlier init header
 					info.codec_data = (uint8_t *)malloc( len );
 					if( info.codec_data )
 					{
@@ -468,6 +812,7 @@ private:
 		else
 		{
 			info.codec_data_len = next - ptr;
+			free( info.codec_data ); // replaces codec_data of an earlier init header
 			info.codec_data = (uint8_t *)malloc( info.codec_data_len );
 			if( info.codec_data )
 			{
@@ -480,10 +825,21 @@ private:
 	{
 		while( ptr < fin )
 		{
+			const uint8_t *box = ptr;
 			uint32_t size = ReadU32();
 			PRINTF( "size=%" PRIu32 "\n", size );
-			const uint8_t *next = ptr+size-4;
 			uint32_t type = ReadU32();
+			if( size == 0 )
+			{ // box extends to the end of its container
+				size = (uint32_t)(fin - box);
+			}
+			if( truncated || size < 8 || size > (size_t)(fin - box) )
+			{ // malformed or clipped box, stop walking this level
+				PRINTF( "bad box size\n" );
+				ptr = fin;
+				break;
+			}
+			const uint8_t *next = box+size;
 			for( int i=0; i<indent; i++ )
 			{
 				PRINTF( "\t" );
@@ -497,8 +853,39 @@ private:
 				case MultiChar_Constant("avc1"):
 				case MultiChar_Constant("mp4a"): 
 				case MultiChar_Constant("ec-3"): 
+				case MultiChar_Constant("encv"):
+				case MultiChar_Constant("enca"):
 					parseStreamFormat( type, next, indent );
 					break;
+
+				case MultiChar_Constant("frma"): // Original Format Box
+					original_format = ReadU32();
+					break;
+
+				case MultiChar_Constant("schm"): // Scheme Type Box
+					ReadHeader();
+					scheme_type = ReadU32();
+					break;
+
+				case MultiChar_Constant("tenc"): // Track Encryption Box
+					parseTrackEncryptionBox();
+					break;
+
+				case MultiChar_Constant("pssh"): // Protection System Specific Header
+					parseProtectionSystemHeader();
+					break;
+
+				case MultiChar_Constant("senc"): // Sample Encryption Box
+					parseSampleEncryptionBox();
+					break;
+
+				case MultiChar_Constant("saiz"): // Sample Auxiliary Information Sizes
+					parseSampleAuxInfoSizesBox();
+					break;
+
+				case MultiChar_Constant("saio"): // Sample Auxiliary Information Offsets
+					parseSampleAuxInfoOffsetsBox();
+					break;
 					
 				case MultiChar_Constant("hvcC"): 
 				case MultiChar_Constant("dec3"): 
@@ -625,7 +1012,23 @@ private:
 					break;
 					
 				case MultiChar_Constant("traf"): //  Track Fragment Boxes
+				{
+					size_t first_sample = samples.size();
+					traf_encryption.clear();
+					saiz_count = 0;
+					saio_present = false;
+					DemuxHelper(next, indent+1 ); // walk children
+					applySampleEncryption( first_sample );
+					break;
+				}
+
 				case MultiChar_Constant("moov"): //  Movie Boxes
+					resetProtection();
+					DemuxHelper(next, indent+1 ); // walk children
+					break;
+
+				case MultiChar_Constant("sinf"): //  Protection Scheme Information Box
+				case MultiChar_Constant("schi"): //  Scheme Information Box
 				case MultiChar_Constant("trak"): //  Track Box
 				case MultiChar_Constant("minf"): //  Media Information Container
 				case MultiChar_Constant("dinf"): //  Data Information Box
@@ -643,13 +1046,285 @@ private:
 		}
 	}
 
+	/**
+	 * @brief parse a complete top level box collected by ParseChunk
+	 * moof samples are turned into pending samples addressed by absolute stream offset
+	 */
+	void ParseCompleteBox( void )
+	{
+		std::vector<Mp4Sample> emitted;
+		emitted.swap( samples );
+		const uint8_t *base = boxBuf.data();
+		ptr = base;
+		limit = base + boxBuf.size();
+		truncated = false;
+		moof_ptr = NULL;
+		uint32_t type = ((uint32_t)base[4]<<24)|((uint32_t)base[5]<<16)|((uint32_t)base[6]<<8)|base[7];
+		DemuxHelper( limit, 0 );
+		if( type == MultiChar_Constant("moov") )
+		{
+			initHeaderParsed = true;
+		}
+		for( auto &sample : samples )
+		{ // data_offset in trun is relative to the moof start
+			Mp4PendingSample pending;
+			pending.offset = boxStart + (uint64_t)(sample.ptr - base);
+			pending.len = sample.len;
+			pending.pts = sample.pts;
+			pending.dts = sample.dts;
+			pending.duration = sample.duration;
+			pending.encryption = sample.encryption;
+			pendingSamples.push_back( pending );
+		}
+		samples.swap( emitted );
+	}
+
+	/**
+	 * @brief emit pending samples covered by mdat bytes [streamOffset, streamOffset+avail) starting at src
+	 */
+	void EmitChunkSamples( const uint8_t *src, size_t avail )
+	{
+		uint64_t rangeStart = streamOffset;
+		uint64_t rangeEnd = streamOffset + avail;
+		while( !pendingSamples.empty() )
+		{
+			const Mp4PendingSample &pending = pendingSamples.front();
+			uint64_t sampleEnd = pending.offset + pending.len;
+			Mp4Sample sample;
+			sample.len = pending.len;
+			sample.pts = pending.pts;
+			sample.dts = pending.dts;
+			sample.duration = pending.duration;
+			sample.carried = false;
+			sample.encryption = pending.encryption;
+			if( !sampleCarry.empty() )
+			{ // continue a sample begun in an earlier range
+				uint64_t from = pending.offset + sampleCarry.size();
+				if( from < rangeStart )
+				{ // tail bytes were never delivered
+					sampleCarry.clear();
+					pendingSamples.pop_front();
+					continue;
+				}
+				if( from >= rangeEnd ) break;
+				uint64_t to = (sampleEnd < rangeEnd)?sampleEnd:rangeEnd;
+				sampleCarry.insert( sampleCarry.end(), src + (from-rangeStart), src + (to-rangeStart) );
+				if( sampleCarry.size() < pending.len ) break;
+				carried.push_back( std::vector<uint8_t>() );
+				carried.back().swap( sampleCarry );
+				sample.ptr = carried.back().data();
+				sample.carried = true;
+			}
+			else if( pending.offset < rangeStart )
+			{ // sample data precedes what we were given, cannot be recovered
+				pendingSamples.pop_front();
+				continue;
+			}
+			else if( pending.offset >= rangeEnd )
+			{ // not arrived yet
+				break;
+			}
+			else if( sampleEnd <= rangeEnd )
+			{ // entirely inside this range
+				sample.ptr = src + (pending.offset - rangeStart);
+			}
+			else
+			{ // starts here, completes in a later range
+				sampleCarry.assign( src + (pending.offset - rangeStart), src + avail );
+				break;
+			}
+			samples.push_back( sample );
+			pendingSamples.pop_front();
+		}
+	}
+
 public:
-	Mp4Demux( const void *ptr, size_t len, uint32_t timescale=0 )
+	/**
+	 * @brief create a demux context that persists across fragments of one track
+	 * @param timescale timescale to assume until an init header provides one
+	 */
+	explicit Mp4Demux( uint32_t timescale=0 ):
+	timescale(timescale), info(), samples(), moof_ptr(NULL), ptr(NULL), limit(NULL), truncated(false), fragment_ptr(NULL), fragment_len(0),
+	version(), flags(), baseMediaDecodeTime(), fragment_duration(), track_id(), base_data_offset(),
+	default_sample_description_index(), default_sample_duration(), default_sample_size(), default_sample_flags(),
+	trex_default_sample_duration(), trex_default_sample_size(), trex_default_sample_flags(), caps(NULL),
+	chunkState(eCHUNK_BOX_HEADER), boxBuf(), boxStart(0), boxSize(0), streamOffset(0), mdatEnd(0),
+	pendingSamples(), sampleCarry(), carried(), initHeaderParsed(false),
+	isProtected(false), original_format(), scheme_type(), default_kid(), default_iv_size(), default_crypt_byte_block(),
+	default_skip_byte_block(), constant_iv_size(), constant_iv(), protection_systems(), preferred_protection_system(), traf_encryption(),
+	saiz_default_size(), saiz_sizes(), saiz_count(), saio_offset(), saio_present(false),
+	creation_time(), modification_time(), duration(), rate(), volume(), matrix(), layer(), alternate_group(),
+	width(), height(), language()
 	{
+	}
+
+	Mp4Demux( const void *ptr, size_t len, uint32_t timescale=0 ) : Mp4Demux(timescale)
+	{
+		Parse( ptr, len );
+	}
+
+	/**
+	 * @brief parse an init header or media fragment
+	 * moov derived state (timescale, trex defaults, tkhd, codec_data, caps) is kept from earlier calls;
+	 * samples of the previous fragment are discarded
+	 */
+	void Parse( const void *ptr, size_t len )
+	{
+		samples.clear();
+		carried.clear();
 		this->ptr = (const uint8_t *)ptr;
+		this->limit = this->ptr + len;
+		this->truncated = false;
 		this->moof_ptr = NULL;
-		this->timescale = timescale;
-		DemuxHelper( &this->ptr[len], 0 );
+		this->fragment_ptr = (const uint8_t *)ptr;
+		this->fragment_len = len;
+		DemuxHelper( limit, 0 );
+	}
+
+	/**
+	 * @brief decode a single trun box against the traf defaults left by the last Parse
+	 * Replaces the samples of that parse; lets the trun decoder be timed on its own.
+	 * @param trun start of the trun box
+	 * @param moof start of the moof holding the trun, base of its data_offset
+	 */
+	void ParseTrackFragmentRun( const void *trun, const void *moof )
+	{
+		const uint8_t *box = (const uint8_t *)trun;
+		samples.clear();
+		carried.clear();
+		moof_ptr = (const uint8_t *)moof;
+		ptr = box + 8;
+		limit = box + Mp4LoadU32(box);
+		truncated = false;
+		parseTrackFragmentRunBox();
+	}
+
+	/**
+	 * @brief discard partial box and sample state of the chunked parser, e.g. after flush, discontinuity
+	 * or ahead of a new segment when the previous one was cut short
+	 */
+	void ResetChunkParser( void )
+	{
+		chunkState = eCHUNK_BOX_HEADER;
+		boxBuf.clear();
+		boxStart = 0;
+		boxSize = 0;
+		streamOffset = 0;
+		mdatEnd = 0;
+		pendingSamples.clear();
+		sampleCarry.clear();
+	}
+
+	/**
+	 * @brief parse the next byte range of a low latency (CMAF chunked) segment
+	 *
+	 * Byte ranges may split boxes and samples anywhere. Every sample whose bytes are complete is
+	 * emitted straight away through count()/getPtr()/getBuffer(); a sample straddling ranges is
+	 * reassembled and emitted with the range completing it. Emitted samples stay valid until the
+	 * next Parse or ParseChunk call. moov derived state is kept exactly as for Parse.
+	 * @param ptr start of the byte range
+	 * @param len length of the byte range
+	 * @retval number of samples emitted from this range
+	 */
+	int ParseChunk( const void *ptr, size_t len )
+	{
+		samples.clear();
+		carried.clear();
+		initHeaderParsed = false;
+		fragment_ptr = (const uint8_t *)ptr;
+		fragment_len = len;
+		const uint8_t *src = (const uint8_t *)ptr;
+		const uint8_t *end = src + len;
+		while( src < end )
+		{
+			switch( chunkState )
+			{
+				case eCHUNK_BOX_HEADER:
+				{
+					if( boxBuf.empty() )
+					{
+						boxStart = streamOffset;
+					}
+					size_t need = ( boxBuf.size()<8 )?8:16; // 16 when size==1 signals a 64 bit largesize
+					size_t take = need - boxBuf.size();
+					if( take > (size_t)(end-src) ) take = end-src;
+					boxBuf.insert( boxBuf.end(), src, src+take );
+					src += take;
+					streamOffset += take;
+					if( boxBuf.size() < 8 ) break;
+					uint64_t size = ((uint64_t)boxBuf[0]<<24)|((uint64_t)boxBuf[1]<<16)|((uint64_t)boxBuf[2]<<8)|boxBuf[3];
+					size_t headerLen = 8;
+					if( size == 1 )
+					{
+						if( boxBuf.size() < 16 ) break;
+						size = 0;
+						for( int i=8; i<16; i++ )
+						{
+							size = (size<<8)|boxBuf[i];
+						}
+						headerLen = 16;
+					}
+					uint32_t type = ((uint32_t)boxBuf[4]<<24)|((uint32_t)boxBuf[5]<<16)|((uint32_t)boxBuf[6]<<8)|boxBuf[7];
+					if( type == MultiChar_Constant("mdat") )
+					{
+						mdatEnd = (size==0)?UINT64_MAX:(boxStart+size); // size 0 extends to end of stream
+						boxBuf.clear();
+						chunkState = eCHUNK_MDAT;
+					}
+					else if( size < headerLen )
+					{ // corrupt box, resynchronise on the next segment
+						ResetChunkParser();
+						return (int)samples.size();
+					}
+					else
+					{
+						boxSize = size;
+						chunkState = eCHUNK_BOX_BODY;
+					}
+					break;
+				}
+
+				case eCHUNK_BOX_BODY:
+				{
+					size_t take = (size_t)(boxSize - boxBuf.size());
+					if( take > (size_t)(end-src) ) take = end-src;
+					boxBuf.insert( boxBuf.end(), src, src+take );
+					src += take;
+					streamOffset += take;
+					if( boxBuf.size() == boxSize )
+					{
+						ParseCompleteBox();
+						boxBuf.clear();
+						boxSize = 0;
+						chunkState = eCHUNK_BOX_HEADER;
+					}
+					break;
+				}
+
+				case eCHUNK_MDAT:
+				{
+					size_t avail = (size_t)(end-src);
+					if( mdatEnd - streamOffset < avail ) avail = (size_t)(mdatEnd - streamOffset);
+					EmitChunkSamples( src, avail );
+					src += avail;
+					streamOffset += avail;
+					if( streamOffset == mdatEnd )
+					{
+						chunkState = eCHUNK_BOX_HEADER;
+					}
+					break;
+				}
+			}
+		}
+		return (int)samples.size();
+	}
+
+	/**
+	 * @brief true if the last ParseChunk call completed an init header; caller should apply setCaps
+	 */
+	bool gotInitHeader( void ) const
+	{
+		return initHeaderParsed;
 	}
 	
 	int count( void )
@@ -669,20 +1344,208 @@ public:
 	
 	double getPts( int part )
 	{
-		return samples[part].pts;
+		return timescale ? samples[part].pts/(double)timescale : 0;
 	}
 	
 	double getDts( int part )
 	{
-		return samples[part].dts;
+		return timescale ? samples[part].dts/(double)timescale : 0;
 	}
 	double getDuration( int part )
+	{
+		return timescale ? samples[part].duration/(double)timescale : 0;
+	}
+
+	/**
+	 * @brief exact sample timestamps in timescale units
+	 */
+	int64_t getPtsTicks( int part )
+	{
+		return samples[part].pts;
+	}
+
+	uint64_t getDtsTicks( int part )
+	{
+		return samples[part].dts;
+	}
+
+	uint32_t getDurationTicks( int part )
 	{
 		return samples[part].duration;
 	}
 
+	/**
+	 * @brief Common Encryption parameters of a sample
+	 * @retval NULL for clear samples
+	 */
+	const Mp4SampleEncryption *getEncryption( int part )
+	{
+		return samples[part].encryption.get();
+	}
+
+	/**
+	 * @brief true if the most recent init header declared a protected track (encv/enca with tenc)
+	 */
+	bool isEncrypted( void ) const
+	{
+		return isProtected;
+	}
+
+	/**
+	 * @brief select the DRM system whose pssh is advertised in caps when an init header carries several
+	 * @param systemId system id as "xxxxxxxx-xxxx-xxxx-xxxx-xxxxxxxxxxxx", optionally with "urn:uuid:" prefix; NULL clears it
+	 */
+	void setPreferredProtectionSystem( const char *systemId )
+	{
+		preferred_protection_system.clear();
+		if( systemId )
+		{
+			if( strncasecmp( systemId, "urn:uuid:", 9 ) == 0 )
+			{
+				systemId += 9;
+			}
+			for( ; *systemId; systemId++ )
+			{
+				preferred_protection_system.push_back( (char)tolower( (unsigned char)*systemId ) );
+			}
+		}
+	}
+
+	/**
+	 * @brief system id used in caps; the pssh matching the preferred system, else the first one
+	 * @retval empty string if the init header carried no pssh
+	 */
+	const std::string &getProtectionSystem( void ) const
+	{
+		static const std::string none;
+		for( const auto &system : protection_systems )
+		{
+			if( system == preferred_protection_system )
+			{
+				return system;
+			}
+		}
+		return protection_systems.empty()?none:protection_systems.front();
+	}
+
+	/**
+	 * @brief stamp a buffer with sample timing, scaling ticks to nanoseconds with integer math
+	 */
+	void SetBufferTimestamps( GstBuffer *buffer, const Mp4Sample &sample )
+	{
+		if( !timescale )
+		{
+			return;
+		}
+		// negative composition offsets ahead of the first dts are clamped rather than wrapped
+		GST_BUFFER_PTS(buffer) = (sample.pts > 0) ? gst_util_uint64_scale( (guint64)sample.pts, GST_SECOND, timescale ) : 0;
+		GST_BUFFER_DTS(buffer) = gst_util_uint64_scale( sample.dts, GST_SECOND, timescale );
+		GST_BUFFER_DURATION(buffer) = gst_util_uint64_scale( sample.duration, GST_SECOND, timescale );
+	}
+
+	/**
+	 * @brief attach the sample's Common Encryption parameters as GstProtectionMeta, in the layout used by qtdemux
+	 */
+	void AttachProtectionMeta( GstBuffer *buffer, const Mp4Sample &sample )
+	{
+		const Mp4SampleEncryption *encryption = sample.encryption.get();
+		if( !encryption )
+		{
+			return;
+		}
+		bool cbcs = (scheme_type == MultiChar_Constant("cbcs"));
+		GstBuffer *kid = gst_buffer_new_and_alloc( sizeof(default_kid) );
+		gst_buffer_fill( kid, 0, default_kid, sizeof(default_kid) );
+		GstStructure *info = gst_structure_new( cbcs?"application/x-cbcs":"application/x-cenc",
+											   "encrypted", G_TYPE_BOOLEAN, TRUE,
+											   "kid", GST_TYPE_BUFFER, kid,
+											   "subsample_count", G_TYPE_UINT, (guint)encryption->subsamples.size(),
+											   NULL );
+		gst_buffer_unref( kid );
+		const uint8_t *iv = encryption->iv;
+		guint iv_size = encryption->iv_size;
+		if( iv_size == 0 && constant_iv_size )
+		{ // cbcs constant IV from tenc
+			iv = constant_iv;
+			iv_size = constant_iv_size;
+			gst_structure_set( info, "constant_iv_size", G_TYPE_UINT, iv_size, NULL );
+		}
+		gst_structure_set( info, "iv_size", G_TYPE_UINT, iv_size, NULL );
+		if( iv_size )
+		{
+			GstBuffer *ivBuf = gst_buffer_new_and_alloc( iv_size );
+			gst_buffer_fill( ivBuf, 0, iv, iv_size );
+			gst_structure_set( info, "iv", GST_TYPE_BUFFER, ivBuf, NULL );
+			gst_buffer_unref( ivBuf );
+		}
+		if( !encryption->subsamples.empty() )
+		{ // 16 bit clear and 32 bit protected byte counts, big endian as in senc
+			size_t count = encryption->subsamples.size();
+			std::vector<uint8_t> map( 6*count );
+			for( size_t i=0; i<count; i++ )
+			{
+				uint16_t clear = MP4_BE16( encryption->subsamples[i].first );
+				uint32_t protectedBytes = MP4_BE32( encryption->subsamples[i].second );
+				memcpy( &map[6*i], &clear, 2 );
+				memcpy( &map[6*i+2], &protectedBytes, 4 );
+			}
+			GstBuffer *subsamples = gst_buffer_new_and_alloc( map.size() );
+			gst_buffer_fill( subsamples, 0, map.data(), map.size() );
+			gst_structure_set( info, "subsamples", GST_TYPE_BUFFER, subsamples, NULL );
+			gst_buffer_unref( subsamples );
+		}
+		if( cbcs )
+		{
+			gst_structure_set( info,
+							  "cipher-mode", G_TYPE_STRING, "cbcs",
+							  "crypt_byte_block", G_TYPE_UINT, (guint)default_crypt_byte_block,
+							  "skip_byte_block", G_TYPE_UINT, (guint)default_skip_byte_block,
+							  NULL );
+		}
+		gst_buffer_add_protection_meta( buffer, info );
+	}
+
+	/**
+	 * @brief create a timestamped sub-buffer for a sample, sharing the memory of the buffer wrapping the whole fragment
+	 * @param fragment buffer holding the same bytes that were parsed, at the same offsets
+	 * @param part sample index
+	 * @retval new buffer or NULL if the sample lies outside the fragment
+	 */
+	GstBuffer *getBuffer( GstBuffer *fragment, int part )
+	{
+		const Mp4Sample &sample = samples[part];
+		if( sample.carried )
+		{ // reassembled across chunks, no parent memory to share
+			GstBuffer *buffer = gst_buffer_new_and_alloc( sample.len );
+			if( buffer )
+			{
+				gst_buffer_fill( buffer, 0, sample.ptr, sample.len );
+				SetBufferTimestamps( buffer, sample );
+				AttachProtectionMeta( buffer, sample );
+			}
+			return buffer;
+		}
+		if( sample.ptr < fragment_ptr || sample.len > fragment_len ||
+		   (size_t)(sample.ptr - fragment_ptr) > fragment_len - sample.len ||
+		   gst_buffer_get_size(fragment) < fragment_len )
+		{
+			return NULL;
+		}
+		GstBuffer *buffer = gst_buffer_copy_region( fragment, GST_BUFFER_COPY_MEMORY, (gsize)(sample.ptr - fragment_ptr), (gsize)sample.len );
+		if( buffer )
+		{
+			SetBufferTimestamps( buffer, sample );
+			AttachProtectionMeta( buffer, sample );
+		}
+		return buffer;
+	}
+
 	~Mp4Demux()
 	{
+		if( caps )
+		{
+			gst_caps_unref( caps );
+		}
 	}
 	
 	Mp4Demux(const Mp4Demux & other)
@@ -695,7 +1558,11 @@ public:
 		assert(0);
 	}
 	
-	void setCaps( GstAppSrc *appsrc ) const
+	/**
+	 * @brief build caps from the most recent init header and apply them to appsrc
+	 * @retval true if caps were applied, false if unchanged from the previous init header or unsupported
+	 */
+	bool setCaps( GstAppSrc *appsrc )
 	{
 		GstCaps * caps = NULL;
 		GstBuffer *buf = gst_buffer_new_and_alloc(info.codec_data_len);
@@ -747,17 +1614,50 @@ public:
 				
 			default:
 				g_print( "unk codec_type: %" PRIu32 "\n", info.codec_type );
-				return;
+				gst_buffer_unref (buf);
+				return false;
 		}
-		gst_app_src_set_caps(appsrc, caps);
-		gst_caps_unref(caps);
 		gst_buffer_unref (buf);
+		if( isProtected )
+		{ // decryptors accept the protected caps and restore original-media-type downstream
+			GstStructure *structure = gst_caps_get_structure( caps, 0 );
+			gst_structure_set( structure, "original-media-type", G_TYPE_STRING, gst_structure_get_name(structure), NULL );
+			const std::string &system = getProtectionSystem();
+			if( !system.empty() )
+			{
+				gst_structure_set( structure, "protection-system", G_TYPE_STRING, system.c_str(), NULL );
+			}
+			gst_structure_set_name( structure, (scheme_type == MultiChar_Constant("cbcs"))?"application/x-cbcs":"application/x-cenc" );
+		}
+		if( this->caps && gst_caps_is_equal( this->caps, caps ) )
+		{ // repeated init header, avoid caps renegotiation
+			gst_caps_unref(caps);
+			return false;
+		}
+		gst_app_src_set_caps(appsrc, caps);
+		if( this->caps )
+		{
+			gst_caps_unref( this->caps );
+		}
+		this->caps = caps;
+		return true;
 	}
 };
 
 /**
- * @brief apply adjustment for pts restamping
+ * @brief apply adjustment for pts restamping to every tfdt, including all moofs of multi-moof fragments
+ * @param pts_restamp_delta signed delta in the fragment's media timescale units
+ * @retval restamped baseMediaDecodeTime of the first tfdt, 0 if none
+ * @note tfdt-only PlayerIsoBmffBuffer::rewriteFragment; use that directly to also remap track ids or strip emsg
  */
 uint64_t mp4_AdjustMediaDecodeTime( uint8_t *ptr, size_t len, int64_t pts_restamp_delta );
 
+/**
+ * @brief apply adjustment for pts restamping, with the delta expressed in another timescale
+ * @param pts_restamp_delta signed delta in delta_timescale units (e.g. GST_SECOND for nanoseconds)
+ * @param media_timescale timescale of the fragment (mdhd)
+ * @note the delta is rescaled with exact integer math, so repeated restamping does not drift
+ */
+uint64_t mp4_AdjustMediaDecodeTime( uint8_t *ptr, size_t len, int64_t pts_restamp_delta, uint32_t delta_timescale, uint32_t media_timescale );
+
 #endif /* parsemp4_hpp */
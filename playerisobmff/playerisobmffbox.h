@@ -115,11 +115,14 @@ public:
 	static constexpr const char *TRUN = "trun";
 	static constexpr const char *MDAT = "mdat";
 	static constexpr const char *TKHD = "tkhd";
+	static constexpr const char *MVEX = "mvex";
+	static constexpr const char *TREX = "trex";
 
 	static constexpr const char *STYP = "styp";
 	static constexpr const char *SIDX = "sidx";
 	static constexpr const char *PRFT = "prft";
 	static constexpr const char *SKIP = "skip";
+	static constexpr const char *FREE = "free";
 	static constexpr const char *SENC = "senc";
 	static constexpr const char *SAIZ = "saiz";
 
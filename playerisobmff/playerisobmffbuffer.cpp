@@ -80,6 +80,132 @@ bool PlayerIsoBmffBuffer::parseBuffer(bool correctBoxSize, int newTrackId)
 	return !!(boxes.size());
 }
 
+/**
+ *  @brief Restamp tfdt, remap track ids and blank emsg boxes in one in place pass
+ */
+size_t PlayerIsoBmffBuffer::rewriteFragment(uint8_t *buf, size_t size, const PlayerIsoBmffRewrite &params, uint64_t *firstBaseMediaDecodeTime)
+{
+	static const int MAX_DEPTH = 8; // moov/trak/mdia or moof/traf nest far less deep
+	const uint8_t *containerEnd[MAX_DEPTH];
+	int depth = 0;
+	size_t modified = 0;
+	bool haveFirstTfdt = false;
+	uint8_t *ptr = buf;
+	const uint8_t *end = buf + size;
+	if (firstBaseMediaDecodeTime)
+	{
+		*firstBaseMediaDecodeTime = 0;
+	}
+	for (;;)
+	{
+		const uint8_t *limit = depth ? containerEnd[depth - 1] : end;
+		if (ptr >= limit)
+		{
+			if (depth == 0)
+			{
+				break;
+			}
+			depth--;
+			continue;
+		}
+		if (limit - ptr < PLAYER_SIZEOF_SIZE_AND_TAG)
+		{
+			break;
+		}
+		uint8_t *box = ptr;
+		uint8_t *hdr = ptr;
+		uint64_t boxSize = PLAYER_READ_U32(hdr);
+		const uint8_t *type = hdr;
+		hdr += 4;
+		if (boxSize == 1)
+		{ // 64 bit largesize
+			if (limit - hdr < 8)
+			{
+				break;
+			}
+			boxSize = ReadUint64FromBuffer(hdr);
+			hdr += 8;
+		}
+		else if (boxSize == 0)
+		{ // extends to the end of its container
+			boxSize = (uint64_t)(limit - box);
+		}
+		if (boxSize < (uint64_t)(hdr - box) || boxSize > (uint64_t)(limit - box))
+		{
+			MW_LOG_WARN("Box size %" PRIu64 " out of range, rewrite stopped", boxSize);
+			break;
+		}
+		uint8_t *next = box + boxSize;
+		size_t payload = (size_t)(next - hdr);
+
+		if (IS_TYPE(type, IsoBmffBox::MOOV) || IS_TYPE(type, IsoBmffBox::TRAK) || IS_TYPE(type, IsoBmffBox::MDIA) ||
+			IS_TYPE(type, IsoBmffBox::MOOF) || IS_TYPE(type, IsoBmffBox::TRAF) || IS_TYPE(type, IsoBmffBox::MVEX))
+		{
+			if (depth == MAX_DEPTH)
+			{
+				break;
+			}
+			containerEnd[depth++] = next;
+			ptr = hdr;
+			continue;
+		}
+		if (IS_TYPE(type, IsoBmffBox::TFDT) && payload >= 8)
+		{
+			uint8_t version = hdr[0];
+			uint8_t *field = hdr + 4;
+			uint64_t baseMediaDecodeTime;
+			if (version == 1 && payload < 12)
+			{ // too short for the 64 bit field; a 32 bit write would corrupt it
+				MW_LOG_WARN("tfdt version 1 with %zu byte payload skipped", payload);
+				ptr = next;
+				continue;
+			}
+			if (version == 1)
+			{
+				baseMediaDecodeTime = ReadUint64FromBuffer(field) + params.baseMediaDecodeTimeDelta;
+				WriteUint64ToBuffer(field, baseMediaDecodeTime);
+			}
+			else
+			{
+				uint8_t *value = field;
+				uint32_t bmdt32 = PLAYER_READ_U32(value);
+				baseMediaDecodeTime = (uint32_t)(bmdt32 + params.baseMediaDecodeTimeDelta);
+				PLAYER_WRITE_U32(field, baseMediaDecodeTime);
+			}
+			if (firstBaseMediaDecodeTime && !haveFirstTfdt)
+			{
+				*firstBaseMediaDecodeTime = baseMediaDecodeTime;
+			}
+			haveFirstTfdt = true;
+			modified += (params.baseMediaDecodeTimeDelta != 0);
+		}
+		else if (params.newTrackId != -1 && (IS_TYPE(type, IsoBmffBox::TFHD) || IS_TYPE(type, IsoBmffBox::TREX)) && payload >= 8)
+		{
+			uint8_t *field = hdr + 4; // after version and flags
+			PLAYER_WRITE_U32(field, params.newTrackId);
+			modified++;
+		}
+		else if (params.newTrackId != -1 && IS_TYPE(type, IsoBmffBox::TKHD) && payload >= 4)
+		{
+			size_t offset = 4 + ((hdr[0] == 1) ? 16 : 8); // version, flags, creation and modification times
+			if (payload >= offset + 4)
+			{
+				uint8_t *field = hdr + offset;
+				PLAYER_WRITE_U32(field, params.newTrackId);
+				modified++;
+			}
+		}
+		else if (params.stripEmsg && IS_TYPE(type, IsoBmffBox::EMSG))
+		{
+			uint8_t *field = box + 4;
+			memcpy(field, IsoBmffBox::FREE, 4);
+			modified++;
+		}
+		ptr = next;
+	}
+	return modified;
+}
+
 /**
  *  @brief Get list of box handles in a parsed buffer
  */
@@ -34,6 +34,21 @@
 
 using namespace player_isobmff;
 
+/**
+ * @struct PlayerIsoBmffRewrite
+ * @brief In place edits applied by PlayerIsoBmffBuffer::rewriteFragment
+ */
+struct PlayerIsoBmffRewrite
+{
+	int64_t baseMediaDecodeTimeDelta; /**< Added to every tfdt, in media timescale units */
+	int newTrackId;                   /**< Written to every tkhd, trex and tfhd; -1 keeps the track ids */
+	bool stripEmsg;                   /**< Turn emsg boxes into free boxes of the same size */
+
+	PlayerIsoBmffRewrite() : baseMediaDecodeTimeDelta(0), newTrackId(-1), stripEmsg(false)
+	{
+	}
+};
+
 /**
  * @class PlayerIsoBmffBuffer
  * @brief Class for ISO BMFF Buffer
@@ -126,6 +141,22 @@ public:
 	 */
 	bool parseBuffer(bool correctBoxSize = false, int newTrackId = -1);
 
+	/**
+	 * @fn rewriteFragment
+	 *
+	 * @brief Restamp every tfdt, remap track ids and blank emsg boxes in a single in place walk.
+	 *        Handles init segments and media segments with any number of moof boxes; does not allocate.
+	 *        The walk stops at the first box whose size is out of range, leaving later boxes untouched;
+	 *        a tfdt too short for its version is skipped.
+	 *
+	 * @param[in,out] buf - init or media segment
+	 * @param[in] size - buffer size
+	 * @param[in] params - edits to apply
+	 * @param[out] firstBaseMediaDecodeTime - restamped value of the first tfdt, optional
+	 * @return number of boxes modified
+	 */
+	static size_t rewriteFragment(uint8_t *buf, size_t size, const PlayerIsoBmffRewrite &params, uint64_t *firstBaseMediaDecodeTime = NULL);
+
 	/**
 	 * @fn printBoxes
 	 *
@@ -1,4 +1,5 @@
 #include "commandProcessing.h"
+#include "InterfacePlayerPriv.h"
 #include <iostream>
 #include <algorithm>
 #include <sstream>
@@ -439,6 +440,201 @@ void clearProtectionEventCommand(InterfacePlayerRDK& player, const std::vector<s
     std::cout << "ClearProtectionEvent executed.\n";
 }
 
+void statsCommand(InterfacePlayerRDK& player, const std::vector<std::string>& params) {
+    if (params.size() > 2) {
+        std::cout << "Usage: stats [mediaType] [reset]\n";
+        return;
+    }
+    int first = 0;
+    int last = 3; // video, audio, subtitle, aux audio
+    if (!params.empty()) {
+        first = last = std::stoi(params[0]);
+    }
+    bool reset = (params.size() == 2 && params[1] == "reset");
+    static const char *latencyBuckets[PlayerInjectionStats::kLatencyBuckets] = {"<10us", "<100us", "<1ms", "<10ms", "<100ms", "<1s", ">=1s"};
+    for (int mediaType = first; mediaType <= last; mediaType++) {
+        PlayerInjectionStats stats;
+        if (!player.GetInjectionStats(mediaType, stats)) {
+            std::cout << "Invalid mediaType " << mediaType << "\n";
+            continue;
+        }
+        std::cout << "mediaType " << mediaType << ":\n"
+                  << "  pushed " << stats.bytesPushed << " bytes in " << stats.buffersPushed << " buffers, "
+                  << stats.pushCalls << " calls, " << stats.pushFailures << " failed\n"
+                  << "  throughput " << stats.bytesPerSecond << " bytes/s over " << stats.activeTimeUs << " us\n"
+                  << "  queue " << stats.queuedBytes << " bytes (max " << stats.maxQueuedBytes << ")\n"
+                  << "  need-data " << stats.needDataCount << ", enough-data " << stats.enoughDataCount
+                  << ", blocked " << stats.blockedTimeUs << " us\n"
+                  << "  push latency (max " << stats.maxPushLatencyUs << " us):";
+        for (int i = 0; i < PlayerInjectionStats::kLatencyBuckets; i++) {
+            std::cout << " " << latencyBuckets[i] << "=" << stats.pushLatencyHistogram[i];
+        }
+        std::cout << "\n";
+        if (reset) {
+            player.ResetInjectionStats(mediaType);
+        }
+    }
+}
+
+/**
+ * @brief source-setup handler for zapbench: give the appsrc raw video caps and queue one frame
+ */
+static void zapBenchSourceSetup(GstElement*, GstElement* source, gpointer) {
+    GstCaps* caps = gst_caps_from_string("video/x-raw,format=I420,width=16,height=16,framerate=25/1");
+    g_object_set(source, "caps", caps, "format", GST_FORMAT_TIME, NULL);
+    gst_caps_unref(caps);
+    GstBuffer* frame = gst_buffer_new_allocate(NULL, 16 * 16 * 3 / 2, NULL);
+    gst_buffer_memset(frame, 0, 0x80, 16 * 16 * 3 / 2);
+    GST_BUFFER_PTS(frame) = 0;
+    GST_BUFFER_DURATION(frame) = GST_SECOND / 25;
+    GstFlowReturn ret = GST_FLOW_OK;
+    g_signal_emit_by_name(source, "push-buffer", frame, &ret);
+    gst_buffer_unref(frame);
+}
+
+/**
+ * @brief Run one zap on a READY playbin: appsrc uri, fakesink, one frame, until PAUSED has prerolled
+ * @return true if the playbin prerolled within 5 seconds
+ */
+static bool zapBenchToPreroll(GstElement* playbin) {
+    g_object_set(playbin, "uri", "appsrc://", NULL);
+    g_signal_connect(playbin, "source-setup", G_CALLBACK(zapBenchSourceSetup), NULL);
+    if (gst_element_set_state(playbin, GST_STATE_PAUSED) == GST_STATE_CHANGE_FAILURE) {
+        return false;
+    }
+    GstState state = GST_STATE_VOID_PENDING;
+    return gst_element_get_state(playbin, &state, NULL, 5 * GST_SECOND) == GST_STATE_CHANGE_SUCCESS && state == GST_STATE_PAUSED;
+}
+
+void zapBenchCommand(InterfacePlayerRDK& player, const std::vector<std::string>& params) {
+    if (params.size() > 1) {
+        std::cout << "Usage: zapbench [iterations]\n";
+        return;
+    }
+    int iterations = params.empty() ? 10 : std::stoi(params[0]);
+    if (iterations <= 0) {
+        std::cout << "iterations must be positive\n";
+        return;
+    }
+    auto release = [](GstElement* playbin) {
+        gst_element_set_state(playbin, GST_STATE_NULL);
+        gst_object_unref(playbin);
+    };
+    // both paths get the same sink setup as a pooled video playbin: fakesink on video-sink only
+    auto build = []() {
+        GstElement* playbin = GST_ELEMENT(gst_object_ref_sink(gst_element_factory_make("playbin", NULL)));
+        g_object_set(playbin, "video-sink", gst_element_factory_make("fakesink", NULL), NULL);
+        gst_element_set_state(playbin, GST_STATE_READY);
+        return playbin;
+    };
+    auto elapsedUs = [](std::chrono::steady_clock::time_point start) {
+        return (long long)std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+    };
+
+    // cold: build the playbin as SetupStream does without the pool, then zap to preroll
+    long long coldUs = 0;
+    int coldCount = 0;
+    for (int i = 0; i < iterations; i++) {
+        auto start = std::chrono::steady_clock::now();
+        GstElement* playbin = build();
+        bool prerolled = zapBenchToPreroll(playbin);
+        long long us = elapsedUs(start);
+        release(playbin);
+        if (prerolled) {
+            coldUs += us;
+            coldCount++;
+        }
+    }
+
+    // warm: claim a playbin prebuilt by the pool, then the same zap to preroll
+    WarmPlaybinPool& pool = WarmPlaybinPool::GetInstance();
+    pool.Configure(iterations, "fakesink", NULL);
+    for (int waitMs = 0; pool.Available(eGST_MEDIATYPE_VIDEO) < iterations && waitMs < 10000; waitMs += 10) {
+        g_usleep(10 * 1000);
+    }
+    long long warmUs = 0;
+    int warmCount = 0;
+    int claimed = 0;
+    for (int i = 0; i < iterations; i++) {
+        auto start = std::chrono::steady_clock::now();
+        GstElement* playbin = pool.Claim(eGST_MEDIATYPE_VIDEO);
+        if (!playbin) {
+            continue;
+        }
+        claimed++;
+        bool prerolled = zapBenchToPreroll(playbin);
+        long long us = elapsedUs(start);
+        release(playbin);
+        if (prerolled) {
+            warmUs += us;
+            warmCount++;
+        }
+    }
+    pool.Clear();
+
+    std::cout << "zap to PAUSED preroll of one raw frame, fakesink, " << iterations << " iterations:\n"
+              << "  cold " << (coldCount ? coldUs / coldCount : 0) << " us per track (" << coldCount << " prerolled)\n"
+              << "  warm " << (warmCount ? warmUs / warmCount : 0) << " us per track (" << warmCount << " prerolled, " << claimed << " claimed from pool)\n";
+}
+
+void tuneTimelineCommand(InterfacePlayerRDK& player, const std::vector<std::string>& params) {
+    if (params.size() > 1 || (params.size() == 1 && params[0] != "json")) {
+        std::cout << "Usage: tunetimeline [json]\n";
+        return;
+    }
+    if (!params.empty()) {
+        std::cout << player.GetTuneTimelineJson() << "\n";
+        return;
+    }
+    PlayerTuneTimeline timeline;
+    player.GetTuneTimeline(timeline);
+    if (!timeline.startUs) {
+        std::cout << "No tune recorded\n";
+        return;
+    }
+    static const char* milestones[eTUNE_MILESTONE_COUNT] = {"configure", "pipeline created", "paused", "playing", "first frame"};
+    static const char* trackMilestones[eTUNE_TRACK_MILESTONE_COUNT] = {"setup start", "setup done", "caps set", "first buffer pushed", "first frame decoded"};
+    static const char* tracks[PlayerTuneTimeline::kTrackCount] = {"video", "audio", "subtitle", "aux audio"};
+    std::cout << "Tune timeline (ms from configure):\n";
+    for (int i = 0; i < eTUNE_MILESTONE_COUNT; i++) {
+        if (timeline.milestoneUs[i] >= 0) {
+            std::cout << "  " << milestones[i] << ": " << timeline.milestoneUs[i] / 1000.0 << "\n";
+        }
+    }
+    for (int track = 0; track < PlayerTuneTimeline::kTrackCount; track++) {
+        for (int i = 0; i < eTUNE_TRACK_MILESTONE_COUNT; i++) {
+            if (timeline.trackMilestoneUs[track][i] >= 0) {
+                std::cout << "  " << tracks[track] << " " << trackMilestones[i] << ": " << timeline.trackMilestoneUs[track][i] / 1000.0 << "\n";
+            }
+        }
+    }
+}
+
+void avSyncCommand(InterfacePlayerRDK& player, const std::vector<std::string>& params) {
+    if (params.size() > 1 || (params.size() == 1 && params[0] != "reset")) {
+        std::cout << "Usage: avsync [reset]\n";
+        return;
+    }
+    PlayerAVSyncStats stats;
+    if (!player.GetAVSyncStats(stats)) {
+        std::cout << "monitorAV is disabled\n";
+        return;
+    }
+    std::cout << "drift (video - audio) over " << stats.driftSamples << " samples: min " << stats.minDriftMs
+              << " ms, max " << stats.maxDriftMs << " ms\n"
+              << "  p50 " << stats.p50DriftMs << " ms, p90 " << stats.p90DriftMs << " ms, p99 " << stats.p99DriftMs
+              << " ms, p99.9 " << stats.p999DriftMs << " ms\n"
+              << "  out of sync " << stats.outOfSyncSamples << " samples\n"
+              << "  stalls " << stats.stallEvents << ", video freezes " << stats.videoFreezeEvents
+              << ", audio drops " << stats.audioDropEvents << ", jumps " << stats.jumpEvents
+              << ", stalled " << stats.stalledTimeMs << " ms\n"
+              << "  polls " << stats.polls << ", skipped " << stats.skippedPolls
+              << ", polling every " << stats.pollIntervalTicks << " progress ticks\n";
+    if (!params.empty()) {
+        player.ResetAVSyncStats();
+    }
+}
+
 void setVideoRectangle(InterfacePlayerRDK& player, const std::vector<std::string>& params) {
     if (params.size() != 4) {
         std::cout << "Usage: setvideorectangle <x> <y> <width> <height>\n";
@@ -557,6 +753,10 @@ std::map<std::string, Command> initializeCommands(CommandExecutor& executor, Int
     commands.emplace("destroypipeline", Command("destroypipeline", "Destroy pipeline.", [&player](const std::vector<std::string>& params) { destroyPipelineCommand(player, params); }));
     commands.emplace("removeprobes", Command("removeprobes", "Remove probes.", [&player](const std::vector<std::string>& params) { removeProbesCommand(player, params); }));
     commands.emplace("clearprotectionevent", Command("clearprotectionevent", "Clear protection event.", [&player](const std::vector<std::string>& params) { clearProtectionEventCommand(player, params); }));
+    commands.emplace("stats", Command("stats", "Show injection telemetry. Usage: stats [mediaType] [reset]", [&player](const std::vector<std::string>& params) { statsCommand(player, params); }));
+    commands.emplace("zapbench", Command("zapbench", "Time a zap to PAUSED preroll on a newly built playbin against one claimed from the pre-built pool, both with fakesink. Releases the warm pool when done. Usage: zapbench [iterations]", [&player](const std::vector<std::string>& params) { zapBenchCommand(player, params); }));
+    commands.emplace("tunetimeline", Command("tunetimeline", "Show the milestones of the current tune. Usage: tunetimeline [json]", [&player](const std::vector<std::string>& params) { tuneTimelineCommand(player, params); }));
+    commands.emplace("avsync", Command("avsync", "Show A/V drift percentiles and stall counters collected by monitorAV. Usage: avsync [reset]", [&player](const std::vector<std::string>& params) { avSyncCommand(player, params); }));
     commands.emplace("setvideorectangle", Command("setvideorectangle", "Usage: setvideorectangle <x> <y> <width> <height>", [&](const std::vector<std::string>& params) { setVideoRectangle(player, params); }));
     commands.emplace("injectfragment", Command("injectfragment", "Inject a fragment into the player. Usage: injectfragment <mediaType:int> <filePath> [pts] [dts] [duration] [fragmentPTSoffset]", [&player](const std::vector<std::string>& params) { injectFragmentCommand(player, params); } ) );
 
@@ -73,6 +73,10 @@ void tearDownStreamCommand(InterfacePlayerRDK& player, const std::vector<std::st
 void destroyPipelineCommand(InterfacePlayerRDK& player, const std::vector<std::string>& params);
 void removeProbesCommand(InterfacePlayerRDK& player, const std::vector<std::string>& params);
 void clearProtectionEventCommand(InterfacePlayerRDK& player, const std::vector<std::string>& params);
+void statsCommand(InterfacePlayerRDK& player, const std::vector<std::string>& params);
+void zapBenchCommand(InterfacePlayerRDK& player, const std::vector<std::string>& params);
+void tuneTimelineCommand(InterfacePlayerRDK& player, const std::vector<std::string>& params);
+void avSyncCommand(InterfacePlayerRDK& player, const std::vector<std::string>& params);
 
 // Register all commands
 std::map<std::string, Command> initializeCommands(CommandExecutor& executor, InterfacePlayerRDK& player);
@@ -162,6 +162,17 @@ void g_object_unref(gpointer object)
 	TRACE_FUNC();
 }
 
+gpointer g_object_get_qdata(GObject *object, GQuark quark)
+{
+	TRACE_FUNC();
+	return NULL;
+}
+
+void g_object_set_qdata(GObject *object, GQuark quark, gpointer data)
+{
+	TRACE_FUNC();
+}
+
 guint g_timeout_add(guint interval, GSourceFunc function, gpointer data)
 {
 	guint retval = 0;
@@ -228,6 +239,17 @@ void g_usleep(gulong microseconds)
 
 }
 
+gint64 g_get_monotonic_time(void)
+{
+	gint64 retval = 0;
+
+	if (g_mockGLib != nullptr)
+	{
+		retval = g_mockGLib->g_get_monotonic_time();
+	}
+	return retval;
+}
+
 gpointer g_malloc(gsize	 n_bytes)
 {
 	gpointer ptr = NULL;
@@ -19,11 +19,81 @@
 
 #include <gst/gst.h>
 #include <gst/app/gstappsrc.h>
+#include <cstdlib>
+#include <map>
 
 #include "MockGStreamer.h"
 
 MockGStreamer *g_mockGStreamer = nullptr;
 
+/**
+ * @brief Destroy notify of a buffer made by gst_buffer_new_wrapped_full
+ */
+struct FakeWrappedBuffer
+{
+	GDestroyNotify notify;
+	gpointer user_data;
+};
+
+/* Wrapped buffers are reference counted like real ones so their notify runs on the last unref */
+static std::map<GstMiniObject *, FakeWrappedBuffer> fakeWrappedBuffers;
+
+/**
+ * @brief Drop one reference of a wrapped buffer, running its notify on the last one
+ * @return false if mini_object is not a wrapped buffer
+ */
+static bool FakeWrappedBufferUnref(GstMiniObject *mini_object)
+{
+	auto it = fakeWrappedBuffers.find(mini_object);
+	if (it == fakeWrappedBuffers.end())
+	{
+		return false;
+	}
+	if (--mini_object->refcount == 0)
+	{
+		FakeWrappedBuffer wrapped = it->second;
+		fakeWrappedBuffers.erase(it);
+		free(mini_object);
+		if (wrapped.notify)
+		{
+			wrapped.notify(wrapped.user_data);
+		}
+	}
+	return true;
+}
+
+/**
+ * @brief Report the fields of a gst_structure_new or gst_structure_set argument list to the mock, one call per field
+ */
+static void FakeStructureSetValist(GstStructure *structure, const gchar *fieldname, va_list args)
+{
+	while (fieldname)
+	{
+		GType type = va_arg(args, GType);
+		if ((type == G_TYPE_UINT) || (type == G_TYPE_INT) || (type == G_TYPE_BOOLEAN))
+		{
+			g_mockGStreamer->gst_structure_set(structure, fieldname, va_arg(args, guint));
+		}
+		else if (type == G_TYPE_STRING)
+		{
+			g_mockGStreamer->gst_structure_set(structure, fieldname, (const gchar *)va_arg(args, gchar *));
+		}
+		else if ((type == G_TYPE_UINT64) || (type == G_TYPE_INT64))
+		{
+			va_arg(args, guint64);
+		}
+		else if ((type == G_TYPE_FLOAT) || (type == G_TYPE_DOUBLE))
+		{
+			va_arg(args, gdouble);
+		}
+		else
+		{ // boxed values such as GstBuffer
+			g_mockGStreamer->gst_structure_set(structure, fieldname, va_arg(args, gpointer));
+		}
+		fieldname = va_arg(args, const gchar *);
+	}
+}
+
 GstDebugCategory *GST_CAT_DEFAULT;
 GstDebugLevel _gst_debug_min;
 
@@ -54,6 +124,11 @@ GType gst_bin_get_type(void)
 GstMiniObject *gst_mini_object_ref(GstMiniObject *mini_object)
 {
 	TRACE_FUNC();
+	if (fakeWrappedBuffers.count(mini_object))
+	{
+		mini_object->refcount++;
+		return mini_object;
+	}
 	return NULL;
 }
 
@@ -64,6 +139,7 @@ void gst_mini_object_unref(GstMiniObject *mini_object)
 	{
 		g_mockGStreamer->gst_mini_object_unref(mini_object);
 	}
+	FakeWrappedBufferUnref(mini_object);
 }
 
 GType gst_app_src_get_type(void)
@@ -77,17 +153,198 @@ void gst_app_src_set_caps(GstAppSrc *appsrc, const GstCaps *caps)
 	TRACE_FUNC();
 }
 
+GstCaps *gst_app_src_get_caps(GstAppSrc *appsrc)
+{
+	TRACE_FUNC();
+	return NULL;
+}
+
+gboolean gst_caps_is_equal(const GstCaps *caps1, const GstCaps *caps2)
+{
+	TRACE_FUNC();
+	return FALSE;
+}
+
 void gst_app_src_set_stream_type(GstAppSrc *appsrc, GstAppStreamType type)
 {
 	TRACE_FUNC();
 }
 
 GstFlowReturn gst_app_src_push_buffer(GstAppSrc *appsrc, GstBuffer *buffer)
+{
+	GstFlowReturn rtn = GST_FLOW_OK;
+	TRACE_FUNC();
+	if (g_mockGStreamer != nullptr)
+	{
+		rtn = g_mockGStreamer->gst_app_src_push_buffer(appsrc, buffer);
+	}
+	// appsrc takes ownership of the buffer whatever the result
+	FakeWrappedBufferUnref(GST_MINI_OBJECT_CAST(buffer));
+	return rtn;
+}
+
+GstFlowReturn gst_app_src_push_buffer_list(GstAppSrc *appsrc, GstBufferList *buffer_list)
 {
 	TRACE_FUNC();
 	return GST_FLOW_OK;
 }
 
+GstBufferList *gst_buffer_list_new_sized(guint size)
+{
+	TRACE_FUNC();
+	return NULL;
+}
+
+void gst_buffer_list_insert(GstBufferList *list, gint idx, GstBuffer *buffer)
+{
+	TRACE_FUNC();
+}
+
+guint gst_buffer_list_length(GstBufferList *list)
+{
+	TRACE_FUNC();
+	return 0;
+}
+
+GstBuffer *gst_buffer_list_get(GstBufferList *list, guint idx)
+{
+	TRACE_FUNC();
+	return NULL;
+}
+
+gsize gst_buffer_list_calculate_size(GstBufferList *list)
+{
+	TRACE_FUNC();
+	return 0;
+}
+
+gsize gst_buffer_get_size(GstBuffer *buffer)
+{
+	TRACE_FUNC();
+	gsize rtn = 0;
+	if (g_mockGStreamer != nullptr)
+	{
+		rtn = g_mockGStreamer->gst_buffer_get_size(buffer);
+	}
+	return rtn;
+}
+
+gsize gst_buffer_fill(GstBuffer *buffer, gsize offset, gconstpointer src, gsize size)
+{
+	TRACE_FUNC();
+	gsize rtn = 0;
+	if (g_mockGStreamer != nullptr)
+	{
+		rtn = g_mockGStreamer->gst_buffer_fill(buffer, offset, src, size);
+	}
+	return rtn;
+}
+
+GstBuffer *gst_buffer_copy_region(GstBuffer *parent, GstBufferCopyFlags flags, gsize offset, gsize size)
+{
+	TRACE_FUNC();
+	GstBuffer *rtn = NULL;
+	if (g_mockGStreamer != nullptr)
+	{
+		rtn = g_mockGStreamer->gst_buffer_copy_region(parent, flags, offset, size);
+	}
+	return rtn;
+}
+
+GstProtectionMeta *gst_buffer_add_protection_meta(GstBuffer *buffer, GstStructure *info)
+{
+	TRACE_FUNC();
+	GstProtectionMeta *rtn = NULL;
+	if (g_mockGStreamer != nullptr)
+	{
+		rtn = g_mockGStreamer->gst_buffer_add_protection_meta(buffer, info);
+	}
+	return rtn;
+}
+
+GstBufferPool *gst_buffer_pool_new(void)
+{
+	TRACE_FUNC();
+	GstBufferPool *rtn = NULL;
+	if (g_mockGStreamer != nullptr)
+	{
+		rtn = g_mockGStreamer->gst_buffer_pool_new();
+	}
+	return rtn;
+}
+
+GstStructure *gst_buffer_pool_get_config(GstBufferPool *pool)
+{
+	TRACE_FUNC();
+	GstStructure *rtn = NULL;
+	if (g_mockGStreamer != nullptr)
+	{
+		rtn = g_mockGStreamer->gst_buffer_pool_get_config(pool);
+	}
+	return rtn;
+}
+
+void gst_buffer_pool_config_set_params(GstStructure *config, GstCaps *caps, guint size, guint min_buffers, guint max_buffers)
+{
+	TRACE_FUNC();
+	if (g_mockGStreamer != nullptr)
+	{
+		g_mockGStreamer->gst_buffer_pool_config_set_params(config, caps, size, min_buffers, max_buffers);
+	}
+}
+
+gboolean gst_buffer_pool_set_config(GstBufferPool *pool, GstStructure *config)
+{
+	TRACE_FUNC();
+	gboolean rtn = FALSE;
+	if (g_mockGStreamer != nullptr)
+	{
+		rtn = g_mockGStreamer->gst_buffer_pool_set_config(pool, config);
+	}
+	return rtn;
+}
+
+gboolean gst_buffer_pool_set_active(GstBufferPool *pool, gboolean active)
+{
+	TRACE_FUNC();
+	gboolean rtn = FALSE;
+	if (g_mockGStreamer != nullptr)
+	{
+		rtn = g_mockGStreamer->gst_buffer_pool_set_active(pool, active);
+	}
+	return rtn;
+}
+
+GstFlowReturn gst_buffer_pool_acquire_buffer(GstBufferPool *pool, GstBuffer **buffer, GstBufferPoolAcquireParams *params)
+{
+	TRACE_FUNC();
+	GstFlowReturn rtn = GST_FLOW_ERROR;
+	if (g_mockGStreamer != nullptr)
+	{
+		rtn = g_mockGStreamer->gst_buffer_pool_acquire_buffer(pool, buffer, params);
+	}
+	return rtn;
+}
+
+void gst_buffer_resize(GstBuffer *buffer, gssize offset, gssize size)
+{
+	TRACE_FUNC();
+	if (g_mockGStreamer != nullptr)
+	{
+		g_mockGStreamer->gst_buffer_resize(buffer, offset, size);
+	}
+}
+
+guint64 gst_util_uint64_scale(guint64 val, guint64 num, guint64 denom)
+{
+	return denom ? (guint64)(((unsigned __int128)val * num) / denom) : 0;
+}
+
+guint64 gst_util_uint64_scale_round(guint64 val, guint64 num, guint64 denom)
+{
+	return denom ? (guint64)(((unsigned __int128)val * num + denom / 2) / denom) : 0;
+}
+
 GstBuffer *gst_buffer_new(void)
 {
 
@@ -99,13 +356,38 @@ GstBuffer *gst_buffer_new_allocate(GstAllocator *allocator, gsize size, GstAlloc
 {
 
 	TRACE_FUNC();
-	return NULL;
+	GstBuffer *rtn = NULL;
+	if (g_mockGStreamer != nullptr)
+	{
+		rtn = g_mockGStreamer->gst_buffer_new_allocate(allocator, size, params);
+	}
+	return rtn;
 }
 
 GstBuffer *gst_buffer_new_wrapped(gpointer data, gsize size)
 {
+	GstBuffer *rtn = NULL;
 	TRACE_FUNC();
-	return NULL;
+	if (g_mockGStreamer != nullptr)
+	{
+		rtn = g_mockGStreamer->gst_buffer_new_wrapped(data, size);
+	}
+	return rtn;
+}
+
+GstBuffer *gst_buffer_new_wrapped_full(GstMemoryFlags flags, gpointer data, gsize maxsize, gsize offset,
+									   gsize size, gpointer user_data, GDestroyNotify notify)
+{
+	TRACE_FUNC();
+	// as gst_memory_new_wrapped, which refuses these without calling notify
+	if (data == NULL || offset + size > maxsize)
+	{
+		return NULL;
+	}
+	GstBuffer *buffer = (GstBuffer *)calloc(1, sizeof(GstBuffer));
+	buffer->mini_object.refcount = 1;
+	fakeWrappedBuffers[GST_MINI_OBJECT_CAST(buffer)] = FakeWrappedBuffer{notify, user_data};
+	return buffer;
 }
 
 gboolean gst_buffer_map(GstBuffer *buffer, GstMapInfo *info, GstMapFlags flags)
@@ -219,6 +501,33 @@ GstStructure *gst_context_writable_structure(GstContext *context)
 void gst_structure_set(GstStructure *structure, const gchar *fieldname, ...)
 {
 	TRACE_FUNC();
+	if ((g_mockGStreamer != nullptr) && structure)
+	{
+		va_list args;
+		va_start(args, fieldname);
+		FakeStructureSetValist(structure, fieldname, args);
+		va_end(args);
+	}
+}
+
+const gchar *gst_structure_get_name(const GstStructure *structure)
+{
+	TRACE_FUNC();
+	const gchar *rtn = NULL;
+	if (g_mockGStreamer != nullptr)
+	{
+		rtn = g_mockGStreamer->gst_structure_get_name(structure);
+	}
+	return rtn;
+}
+
+void gst_structure_set_name(GstStructure *structure, const gchar *name)
+{
+	TRACE_FUNC();
+	if (g_mockGStreamer != nullptr)
+	{
+		g_mockGStreamer->gst_structure_set_name(structure, name);
+	}
 }
 
 void gst_element_set_context(GstElement *element, GstContext *context)
@@ -466,6 +775,11 @@ gboolean gst_bus_remove_watch(GstBus *bus)
 	return FALSE;
 }
 
+void gst_bus_set_flushing(GstBus *bus, gboolean flushing)
+{
+	TRACE_FUNC();
+}
+
 gchar *gst_object_get_name(GstObject *object)
 {
 	if (object && object->name)
@@ -577,7 +891,19 @@ GstPluginFeature *gst_registry_lookup_feature(GstRegistry *registry, const char
 GstStructure *gst_structure_new(const gchar *name, const gchar *firstfield, ...)
 {
 	TRACE_FUNC();
-	return NULL;
+	GstStructure *rtn = NULL;
+	if (g_mockGStreamer != nullptr)
+	{
+		rtn = g_mockGStreamer->gst_structure_new(name);
+		if (rtn)
+		{
+			va_list args;
+			va_start(args, firstfield);
+			FakeStructureSetValist(rtn, firstfield, args);
+			va_end(args);
+		}
+	}
+	return rtn;
 }
 
 GstEvent *gst_event_new_custom(GstEventType type, GstStructure *structure)
@@ -23,3 +23,15 @@ GType gst_player_taskpool_get_type(void)
 {
 	return 0;
 }
+
+void gst_player_taskpool_set_sched(GstPlayerTaskpool *pool, guint task_class, const GstPlayerTaskpoolSched *sched)
+{
+}
+
+void gst_player_taskpool_set_task_class(GstTask *task, guint task_class)
+{
+}
+
+void gst_player_taskpool_set_max_idle_threads(gconstpointer owner, guint max_idle)
+{
+}
@@ -0,0 +1,51 @@
+/*
+ * If not stated otherwise in this file or this component's license file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2025 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "PlayerPositionClock.h"
+
+PlayerPositionClock::PlayerPositionClock() : mSequence(0), mValid(false), mPositionMs(0), mTimestampUs(0), mSlope(0.0),
+	mWriteMutex(), mRefreshing(false), mEpoch(0), mRefreshEpoch(0)
+{
+}
+
+int64_t PlayerPositionClock::NowUs()
+{
+	return 0;
+}
+
+bool PlayerPositionClock::Read(int64_t nowUs, long long &positionMs, int64_t &ageUs) const
+{
+	return false;
+}
+
+bool PlayerPositionClock::TryBeginRefresh()
+{
+	return true;
+}
+
+void PlayerPositionClock::Publish(long long positionMs, int64_t timestampUs, double slope)
+{
+}
+
+void PlayerPositionClock::EndRefresh()
+{
+}
+
+void PlayerPositionClock::Invalidate()
+{
+}
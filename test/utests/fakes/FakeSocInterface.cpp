@@ -29,6 +29,20 @@ std::shared_ptr<SocInterface> SocInterface::CreateSocInterface()
         std::shared_ptr<SocInterface> obj = std::make_shared<DefaultSocInterface>();
         return obj;
 }
+SocPlatformType SocInterface::GetPlatformType()
+{
+	return SOC_PLATFORM_DEFAULT;
+}
+bool SocInterface::IsFeatureAvailable(const char *featureName)
+{
+	GstPluginFeature* pluginFeature = gst_registry_lookup_feature(gst_registry_get(), featureName);
+	if (pluginFeature)
+	{
+		gst_object_unref(pluginFeature);
+		return true;
+	}
+	return false;
+}
 bool DefaultSocInterface::UseAppSrc()
 {
 #if defined (__APPLE__)
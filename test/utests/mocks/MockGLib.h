@@ -34,6 +34,7 @@ public:
 	MOCK_METHOD(gpointer, g_malloc, (gsize n_bytes));
 	MOCK_METHOD(void, g_free, (gpointer mem));
 	MOCK_METHOD(gpointer, g_realloc, (gpointer mem, gsize n_bytes));
+	MOCK_METHOD(gint64, g_get_monotonic_time, ());
 
 	MOCK_METHOD(void, g_object_set, (gpointer object, const gchar *property_name, int value));
 	MOCK_METHOD(void, g_object_set, (gpointer object, const gchar *property_name, char * value));
@@ -23,6 +23,7 @@
 #include <gmock/gmock.h>
 #include <gst/gstcaps.h>
 #include <gst/app/gstappsink.h>
+#include <gst/app/gstappsrc.h>
 
 class MockGStreamer
 {
@@ -53,6 +54,28 @@ public:
 	MOCK_METHOD(gboolean, gst_element_send_event, (GstElement *element, GstEvent *event));
 	MOCK_METHOD(GstEvent *, gst_event_new_step, (GstFormat format, guint64 amount, gdouble rate, gboolean flush, gboolean intermediate));
 	MOCK_METHOD(gboolean, gst_element_query_position, (GstElement *element, GstFormat format, gint64 *cur));
+	MOCK_METHOD(GstBuffer *, gst_buffer_new_wrapped, (gpointer data, gsize size));
+	MOCK_METHOD(GstFlowReturn, gst_app_src_push_buffer, (GstAppSrc *appsrc, GstBuffer *buffer));
+	MOCK_METHOD(GstBuffer *, gst_buffer_new_allocate, (GstAllocator *allocator, gsize size, GstAllocationParams *params));
+	MOCK_METHOD(gsize, gst_buffer_fill, (GstBuffer *buffer, gsize offset, gconstpointer src, gsize size));
+	MOCK_METHOD(gsize, gst_buffer_get_size, (GstBuffer *buffer));
+	MOCK_METHOD(GstBuffer *, gst_buffer_copy_region, (GstBuffer *parent, GstBufferCopyFlags flags, gsize offset, gsize size));
+	MOCK_METHOD(GstProtectionMeta *, gst_buffer_add_protection_meta, (GstBuffer *buffer, GstStructure *info));
+	MOCK_METHOD(void, gst_buffer_resize, (GstBuffer *buffer, gssize offset, gssize size));
+	MOCK_METHOD(GstBufferPool *, gst_buffer_pool_new, ());
+	MOCK_METHOD(GstStructure *, gst_buffer_pool_get_config, (GstBufferPool *pool));
+	MOCK_METHOD(void, gst_buffer_pool_config_set_params, (GstStructure *config, GstCaps *caps, guint size, guint min_buffers, guint max_buffers));
+	MOCK_METHOD(gboolean, gst_buffer_pool_set_config, (GstBufferPool *pool, GstStructure *config));
+	MOCK_METHOD(gboolean, gst_buffer_pool_set_active, (GstBufferPool *pool, gboolean active));
+	MOCK_METHOD(GstFlowReturn, gst_buffer_pool_acquire_buffer, (GstBufferPool *pool, GstBuffer **buffer, GstBufferPoolAcquireParams *params));
+
+	/* gst_structure_new and gst_structure_set report one call per field, by value type */
+	MOCK_METHOD(GstStructure *, gst_structure_new, (const gchar *name));
+	MOCK_METHOD(void, gst_structure_set, (GstStructure *structure, const gchar *fieldname, guint value));
+	MOCK_METHOD(void, gst_structure_set, (GstStructure *structure, const gchar *fieldname, const gchar *value));
+	MOCK_METHOD(void, gst_structure_set, (GstStructure *structure, const gchar *fieldname, gpointer value));
+	MOCK_METHOD(const gchar *, gst_structure_get_name, (const GstStructure *structure));
+	MOCK_METHOD(void, gst_structure_set_name, (GstStructure *structure, const gchar *name));
 
 	/*
 gst_app_sink_get_type
@@ -0,0 +1,186 @@
+/*
+ * If not stated otherwise in this file or this component's license file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2025 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+#include <vector>
+
+#include "InterfacePlayerRDK.h"
+#include "InterfacePlayerPriv.h"
+
+class AVSyncMonitorTests : public ::testing::Test
+{
+protected:
+	AVSyncMonitor mMonitor;
+
+	/**
+	 * @brief Record count in-sync polls of the given drift
+	 */
+	void RecordDrift(int driftMs, int count, bool outOfSync = false)
+	{
+		for (int i = 0; i < count; i++)
+		{
+			mMonitor.RecordPoll(outOfSync ? "avsync" : "ok", "ok", true, driftMs, outOfSync, 250, false);
+		}
+	}
+
+	/**
+	 * @brief Run progress ticks with a steady 20ms drift and return the ticks that polled
+	 */
+	std::vector<int> RunSteadyTicks(int firstTick, int lastTick, bool backoff)
+	{
+		std::vector<int> polled;
+		for (int tick = firstTick; tick <= lastTick; tick++)
+		{
+			if (mMonitor.ShouldPoll())
+			{
+				mMonitor.RecordPoll("ok", "ok", true, 20, false, 250, backoff);
+				polled.push_back(tick);
+			}
+		}
+		return polled;
+	}
+};
+
+TEST_F(AVSyncMonitorTests, BucketIndexAndMidpoint)
+{
+	// exact below 8ms
+	for (unsigned ms = 0; ms < (unsigned)AVSyncMonitor::kSubBuckets; ms++)
+	{
+		EXPECT_EQ(AVSyncMonitor::GetBucketIndex(ms), (int)ms);
+		EXPECT_EQ(AVSyncMonitor::GetBucketMidpoint((int)ms), ms);
+	}
+	// 8 sub-buckets per power of two above
+	EXPECT_EQ(AVSyncMonitor::GetBucketIndex(8), 8);
+	EXPECT_EQ(AVSyncMonitor::GetBucketIndex(15), 15);
+	EXPECT_EQ(AVSyncMonitor::GetBucketIndex(16), 16);
+	EXPECT_EQ(AVSyncMonitor::GetBucketIndex(17), 16);
+	EXPECT_EQ(AVSyncMonitor::GetBucketMidpoint(16), 17u);
+	EXPECT_EQ(AVSyncMonitor::GetBucketIndex(200), 44);
+	EXPECT_EQ(AVSyncMonitor::GetBucketMidpoint(44), 200u);
+
+	// monotonic, and the midpoint stays within half a bucket (1/16 of the magnitude)
+	int previous = 0;
+	for (unsigned ms = AVSyncMonitor::kSubBuckets; ms < (1u << (AVSyncMonitor::kMaxExponent + 1)); ms++)
+	{
+		int index = AVSyncMonitor::GetBucketIndex(ms);
+		ASSERT_GE(index, previous);
+		ASSERT_LT(index, (int)AVSyncMonitor::kBucketCount);
+		unsigned midpoint = AVSyncMonitor::GetBucketMidpoint(index);
+		unsigned error = (midpoint > ms) ? midpoint - ms : ms - midpoint;
+		ASSERT_LE(error, ms / 16) << "ms " << ms;
+		previous = index;
+	}
+	EXPECT_EQ(previous, (int)AVSyncMonitor::kBucketCount - 1);
+	EXPECT_EQ(AVSyncMonitor::GetBucketIndex(1u << (AVSyncMonitor::kMaxExponent + 1)), (int)AVSyncMonitor::kBucketCount - 1);
+	EXPECT_EQ(AVSyncMonitor::GetBucketIndex(0xffffffffu), (int)AVSyncMonitor::kBucketCount - 1);
+}
+
+TEST_F(AVSyncMonitorTests, Percentiles)
+{
+	PlayerAVSyncStats stats;
+
+	RecordDrift(-100, 10, true);
+	RecordDrift(5, 80);
+	RecordDrift(24, 9);
+	RecordDrift(300, 1, true);
+	mMonitor.Snapshot(stats);
+	EXPECT_EQ(stats.polls, 100u);
+	EXPECT_EQ(stats.driftSamples, 100u);
+	EXPECT_EQ(stats.outOfSyncSamples, 11u);
+	EXPECT_EQ(stats.minDriftMs, -100);
+	EXPECT_EQ(stats.maxDriftMs, 300);
+	EXPECT_EQ(stats.p50DriftMs, 5);
+	EXPECT_EQ(stats.p90DriftMs, 5);
+	EXPECT_EQ(stats.p99DriftMs, 25);  // midpoint of the 24..25 bucket
+	EXPECT_EQ(stats.p999DriftMs, 300); // midpoint 304, clamped to the largest drift seen
+
+	// video behind: walked from the most negative drift
+	mMonitor.Reset();
+	RecordDrift(-50, 3);
+	RecordDrift(-2, 1);
+	mMonitor.Snapshot(stats);
+	EXPECT_EQ(stats.p50DriftMs, -50);
+	EXPECT_EQ(stats.p999DriftMs, -2);
+
+	mMonitor.Reset();
+	mMonitor.Snapshot(stats);
+	EXPECT_EQ(stats.driftSamples, 0u);
+	EXPECT_EQ(stats.p50DriftMs, 0);
+	EXPECT_EQ(stats.minDriftMs, 0);
+}
+
+TEST_F(AVSyncMonitorTests, StallEventsCountedOnEntry)
+{
+	PlayerAVSyncStats stats;
+
+	mMonitor.RecordPoll("ok", NULL, true, 20, false, 0, false);
+	mMonitor.RecordPoll("video freeze", "ok", true, -230, true, 250, false);
+	mMonitor.RecordPoll("video freeze", "video freeze", true, -480, true, 250, false);
+	mMonitor.RecordPoll("stall", "video freeze", true, -480, true, 250, false);
+	mMonitor.RecordPoll("ok", "stall", true, 20, false, 250, false);
+	mMonitor.RecordPoll("audio drop", "ok", true, 270, true, 300, false);
+	mMonitor.RecordPoll("jump", "audio drop", true, 20, false, 250, false);
+	mMonitor.RecordPoll("eos", "jump", false, 0, false, 250, false);
+	mMonitor.Snapshot(stats);
+
+	EXPECT_EQ(stats.polls, 8u);
+	EXPECT_EQ(stats.driftSamples, 7u);
+	EXPECT_EQ(stats.videoFreezeEvents, 1u);
+	EXPECT_EQ(stats.stallEvents, 1u);
+	EXPECT_EQ(stats.audioDropEvents, 1u);
+	EXPECT_EQ(stats.jumpEvents, 1u);
+	EXPECT_EQ(stats.stalledTimeMs, 250u + 250u + 250u + 300u);
+}
+
+TEST_F(AVSyncMonitorTests, BackoffWhileInSync)
+{
+	PlayerAVSyncStats stats;
+
+	// first sample, then 4 stable ones: every other tick, 4 more: every fourth tick
+	EXPECT_EQ(RunSteadyTicks(1, 17, true), std::vector<int>({1, 2, 3, 4, 5, 7, 9, 11, 13, 17}));
+	mMonitor.Snapshot(stats);
+	EXPECT_EQ(stats.pollIntervalTicks, (int)AVSyncMonitor::kMaxPollIntervalTicks);
+	EXPECT_EQ(stats.polls, 10u);
+	EXPECT_EQ(stats.skippedPolls, 7u);
+
+	// the first anomaly polls on every tick again
+	EXPECT_TRUE(RunSteadyTicks(18, 20, true).empty());
+	ASSERT_TRUE(mMonitor.ShouldPoll());
+	mMonitor.RecordPoll("avsync", "ok", true, 400, true, 1000, true);
+	mMonitor.Snapshot(stats);
+	EXPECT_EQ(stats.pollIntervalTicks, 1);
+	EXPECT_TRUE(mMonitor.ShouldPoll());
+}
+
+TEST_F(AVSyncMonitorTests, NoBackoffUnlessEnabled)
+{
+	PlayerAVSyncStats stats;
+
+	EXPECT_EQ(RunSteadyTicks(1, 17, false).size(), 17u);
+	mMonitor.Snapshot(stats);
+	EXPECT_EQ(stats.pollIntervalTicks, 1);
+	EXPECT_EQ(stats.skippedPolls, 0u);
+
+	// once switched off, every tick polls again after the poll already scheduled
+	mMonitor.Reset();
+	RunSteadyTicks(1, 13, true);
+	mMonitor.Snapshot(stats);
+	ASSERT_EQ(stats.pollIntervalTicks, (int)AVSyncMonitor::kMaxPollIntervalTicks);
+	EXPECT_EQ(RunSteadyTicks(14, 20, false), std::vector<int>({17, 18, 19, 20}));
+}
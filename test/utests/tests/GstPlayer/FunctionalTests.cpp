@@ -19,6 +19,7 @@
 
 #include <gtest/gtest.h>
 #include <gmock/gmock.h>
+#include <future>
 #include "InterfacePlayerRDK.h"
 #include "InterfacePlayerPriv.h"
 #include "GstUtils.h"
@@ -42,6 +43,7 @@ using ::testing::SaveArgPointee;
 using ::testing::SaveArg;
 using ::testing::Pointer;
 using ::testing::Matcher;
+using ::testing::Invoke;
 
 class GstPlayerTests : public ::testing::Test
 {
@@ -637,3 +639,511 @@ TEST_F(GstPlayerTests, MonitorAV )
 	}
 	DestroyAMPGstPlayer();
 }
+
+/**
+ * @brief Inject one fragment through SendHelper and let the fake appsrc accept it
+ */
+static void PushFragment(InterfacePlayerRDK *player, GstBuffer *buffer, int type, double fpts, double fDuration)
+{
+	static char payload[16];
+	bool discontinuity = false;
+	bool notifyFirstBufferProcessed = false;
+	bool sendNewSegmentEvent = false;
+	bool resetTrickUTC = false;
+	bool firstBufferPushed = false;
+
+	EXPECT_CALL(*g_mockGStreamer, gst_buffer_new_wrapped(payload, sizeof(payload)))
+		.WillOnce(Return(buffer));
+	EXPECT_TRUE(player->SendHelper(type, payload, sizeof(payload), fpts, fpts, fDuration, 0.0, false, false,
+								   discontinuity, notifyFirstBufferProcessed, sendNewSegmentEvent, resetTrickUTC, firstBufferPushed));
+}
+
+/**
+ * @brief A/V sources configured and past their first buffer, so SendHelper takes the lock free path
+ */
+static void ConfigureSources(InterfacePlayerRDK *player)
+{
+	GstPlayerPriv *privateContext = player->GetPrivatePlayer()->gstPrivateContext;
+	for (int type : {eGST_MEDIATYPE_VIDEO, eGST_MEDIATYPE_AUDIO})
+	{
+		privateContext->stream[type].sourceState = eGST_SOURCE_CONFIGURED;
+		privateContext->stream[type].resetPosition = false;
+	}
+}
+
+/**
+ * @brief Pipeline playing at positionNs, with the A/V sources configured and past their first buffer
+ */
+static void PrepareInBufferSeek(InterfacePlayerRDK *player, GstElement *pipeline, gint64 positionNs)
+{
+	ConfigureSources(player);
+	EXPECT_CALL(*g_mockGStreamer, gst_element_get_state(pipeline, _, _, _))
+		.WillRepeatedly(DoAll(
+			SetArgPointee<1>(GST_STATE_PLAYING),
+			SetArgPointee<2>(GST_STATE_VOID_PENDING),
+			Return(GST_STATE_CHANGE_SUCCESS)));
+	EXPECT_CALL(*g_mockGStreamer, gst_element_query_position(pipeline, GST_FORMAT_TIME, _))
+		.WillRepeatedly(DoAll(
+			SetArgPointee<2>(positionNs),
+			Return(TRUE)));
+}
+
+TEST_F(GstPlayerTests, SeekWithinQueuedData_BufferPtsOnSeekTimeline)
+{
+	GstBuffer buffers[4] = {};
+	GstEvent step = {};
+
+	ConstructAMPGstPlayer();
+	SetupPipeline(&tbl[0]);
+	PrepareInBufferSeek(mInterfaceGstPlayer, &gst_element_pipeline, 10 * GST_SECOND);
+	GstPlayerPriv *privateContext = mInterfaceGstPlayer->GetPrivatePlayer()->gstPrivateContext;
+
+	// fragment times in seconds become the buffer PTS the queued range is built from
+	PushFragment(mInterfaceGstPlayer, &buffers[0], eGST_MEDIATYPE_VIDEO, 10.0, 2.0);
+	PushFragment(mInterfaceGstPlayer, &buffers[1], eGST_MEDIATYPE_VIDEO, 12.0, 2.0);
+	PushFragment(mInterfaceGstPlayer, &buffers[2], eGST_MEDIATYPE_AUDIO, 10.0, 2.0);
+	PushFragment(mInterfaceGstPlayer, &buffers[3], eGST_MEDIATYPE_AUDIO, 12.0, 2.0);
+	EXPECT_EQ(GST_BUFFER_PTS(&buffers[1]), 12 * GST_SECOND);
+	EXPECT_EQ(privateContext->stream[eGST_MEDIATYPE_VIDEO].queuedEndPts.load(), 14 * GST_SECOND);
+	EXPECT_EQ(privateContext->stream[eGST_MEDIATYPE_AUDIO].queuedEndPts.load(), 14 * GST_SECOND);
+
+	// seeking to the PTS of the second fragment steps exactly the distance from the queried position
+	privateContext->bufferingTimeoutTimerId = 42;
+	EXPECT_CALL(*g_mockGLib, g_source_remove(42)).WillOnce(Return(TRUE));
+	EXPECT_CALL(*g_mockGStreamer, gst_event_new_step(GST_FORMAT_TIME, 2 * GST_SECOND, 1.0, TRUE, FALSE))
+		.WillOnce(Return(&step));
+	EXPECT_CALL(*g_mockGStreamer, gst_element_send_event(&gst_element_pipeline, &step))
+		.WillOnce(Return(TRUE));
+	EXPECT_TRUE(mInterfaceGstPlayer->SeekWithinQueuedData(12.0));
+	EXPECT_EQ(privateContext->bufferingTimeoutTimerId, (guint)PLAYER_TASK_ID_INVALID);
+
+	DestroyAMPGstPlayer();
+}
+
+TEST_F(GstPlayerTests, SeekWithinQueuedData_OutsideQueuedRange)
+{
+	GstBuffer buffers[2] = {};
+
+	ConstructAMPGstPlayer();
+	SetupPipeline(&tbl[0]);
+	PrepareInBufferSeek(mInterfaceGstPlayer, &gst_element_pipeline, 10 * GST_SECOND);
+	GstPlayerPriv *privateContext = mInterfaceGstPlayer->GetPrivatePlayer()->gstPrivateContext;
+
+	PushFragment(mInterfaceGstPlayer, &buffers[0], eGST_MEDIATYPE_VIDEO, 10.0, 4.0);
+	PushFragment(mInterfaceGstPlayer, &buffers[1], eGST_MEDIATYPE_AUDIO, 10.0, 4.0);
+
+	privateContext->bufferingTimeoutTimerId = 42;
+	EXPECT_CALL(*g_mockGLib, g_source_remove(_)).Times(0);
+	EXPECT_CALL(*g_mockGStreamer, gst_event_new_step(_, _, _, _, _)).Times(0);
+	EXPECT_FALSE(mInterfaceGstPlayer->SeekWithinQueuedData(9.0));  // backwards
+	EXPECT_FALSE(mInterfaceGstPlayer->SeekWithinQueuedData(13.6)); // less than the margin left
+	EXPECT_FALSE(mInterfaceGstPlayer->SeekWithinQueuedData(20.0)); // not queued yet
+
+	// restamped PTS are not on the seek timeline
+	mInterfaceGstPlayer->m_gstConfigParam->enablePTSReStamp = true;
+	EXPECT_FALSE(mInterfaceGstPlayer->SeekWithinQueuedData(12.0));
+	mInterfaceGstPlayer->m_gstConfigParam->enablePTSReStamp = false;
+
+	// data queued for one track only
+	privateContext->stream[eGST_MEDIATYPE_AUDIO].queuedEndPts.store(GST_CLOCK_TIME_NONE);
+	EXPECT_FALSE(mInterfaceGstPlayer->SeekWithinQueuedData(12.0));
+	EXPECT_EQ(privateContext->bufferingTimeoutTimerId, 42u);
+	privateContext->bufferingTimeoutTimerId = PLAYER_TASK_ID_INVALID;
+
+	DestroyAMPGstPlayer();
+}
+
+TEST_F(GstPlayerTests, TuneTimeline_FirstMarksInOrder)
+{
+	ConstructAMPGstPlayer();
+	TuneTimelineRecorder &recorder = mInterfaceGstPlayer->GetPrivatePlayer()->gstPrivateContext->tuneTimeline;
+	PlayerTuneTimeline timeline;
+
+	// nothing is recorded before the timeline starts
+	recorder.Mark(eTUNE_MILESTONE_PAUSED);
+	recorder.MarkTrack(eGST_MEDIATYPE_VIDEO, eTUNE_TRACK_SETUP_START);
+	EXPECT_EQ(mInterfaceGstPlayer->GetTuneTimelineJson(), "{\"start_us\":0,\"milestones\":{},\"tracks\":{}}");
+
+	EXPECT_CALL(*g_mockGLib, g_get_monotonic_time())
+		.WillOnce(Return(1000))  // Start
+		.WillOnce(Return(1100))  // video setup_start
+		.WillOnce(Return(1200))  // pipeline_created
+		.WillOnce(Return(1500))  // video first_buffer_pushed
+		.WillOnce(Return(1800))  // playing
+		.WillOnce(Return(1900))  // pipeline_created again
+		.WillOnce(Return(2000))  // Start again
+		.WillRepeatedly(Return(0));
+	recorder.Start();
+	recorder.MarkTrack(eGST_MEDIATYPE_VIDEO, eTUNE_TRACK_SETUP_START);
+	recorder.Mark(eTUNE_MILESTONE_PIPELINE_CREATED);
+	recorder.MarkTrack(eGST_MEDIATYPE_VIDEO, eTUNE_TRACK_FIRST_BUFFER_PUSHED);
+	recorder.Mark(eTUNE_MILESTONE_PLAYING);
+	recorder.Mark(eTUNE_MILESTONE_PIPELINE_CREATED);
+	recorder.Start();
+
+	mInterfaceGstPlayer->GetTuneTimeline(timeline);
+	EXPECT_EQ(timeline.startUs, 1000);
+	EXPECT_EQ(timeline.milestoneUs[eTUNE_MILESTONE_CONFIGURE], 0);
+	EXPECT_EQ(timeline.milestoneUs[eTUNE_MILESTONE_PIPELINE_CREATED], 200);
+	EXPECT_EQ(timeline.milestoneUs[eTUNE_MILESTONE_PAUSED], -1);
+	EXPECT_EQ(timeline.milestoneUs[eTUNE_MILESTONE_PLAYING], 800);
+	EXPECT_EQ(timeline.milestoneUs[eTUNE_MILESTONE_FIRST_FRAME], -1);
+	EXPECT_EQ(timeline.trackMilestoneUs[eGST_MEDIATYPE_VIDEO][eTUNE_TRACK_SETUP_START], 100);
+	EXPECT_EQ(timeline.trackMilestoneUs[eGST_MEDIATYPE_VIDEO][eTUNE_TRACK_SETUP_DONE], -1);
+	EXPECT_EQ(timeline.trackMilestoneUs[eGST_MEDIATYPE_VIDEO][eTUNE_TRACK_FIRST_BUFFER_PUSHED], 500);
+	for (int i = 0; i < eTUNE_TRACK_MILESTONE_COUNT; i++)
+	{
+		EXPECT_EQ(timeline.trackMilestoneUs[eGST_MEDIATYPE_AUDIO][i], -1);
+	}
+
+	// unreached milestones and tracks without any milestone are omitted
+	EXPECT_EQ(mInterfaceGstPlayer->GetTuneTimelineJson(),
+			  "{\"start_us\":1000,"
+			  "\"milestones\":{\"configure\":0,\"pipeline_created\":200,\"playing\":800},"
+			  "\"tracks\":{\"video\":{\"setup_start\":100,\"first_buffer_pushed\":500}}}");
+
+	DestroyAMPGstPlayer();
+}
+
+TEST_F(GstPlayerTests, TuneTimeline_NewTuneStartsNewTimeline)
+{
+	ConstructAMPGstPlayer();
+	TuneTimelineRecorder &recorder = mInterfaceGstPlayer->GetPrivatePlayer()->gstPrivateContext->tuneTimeline;
+
+	EXPECT_CALL(*g_mockGLib, g_get_monotonic_time())
+		.WillOnce(Return(1000))  // first tune Start
+		.WillOnce(Return(1400))  // first tune audio caps_set
+		.WillOnce(Return(1600))  // first tune playing
+		.WillOnce(Return(5000))  // second tune Start
+		.WillOnce(Return(5300))  // second tune paused
+		.WillRepeatedly(Return(0));
+	recorder.Start();
+	recorder.MarkTrack(eGST_MEDIATYPE_AUDIO, eTUNE_TRACK_CAPS_SET);
+	recorder.Mark(eTUNE_MILESTONE_PLAYING);
+	EXPECT_EQ(mInterfaceGstPlayer->GetTuneTimelineJson(),
+			  "{\"start_us\":1000,\"milestones\":{\"configure\":0,\"playing\":600},\"tracks\":{\"audio\":{\"caps_set\":400}}}");
+
+	// milestones of the previous tune are dropped and marks wait for the next Start
+	mInterfaceGstPlayer->ResetTuneTimeline();
+	recorder.Mark(eTUNE_MILESTONE_FIRST_FRAME);
+	EXPECT_EQ(mInterfaceGstPlayer->GetTuneTimelineJson(), "{\"start_us\":0,\"milestones\":{},\"tracks\":{}}");
+
+	recorder.Start();
+	recorder.Mark(eTUNE_MILESTONE_PAUSED);
+	EXPECT_EQ(mInterfaceGstPlayer->GetTuneTimelineJson(),
+			  "{\"start_us\":5000,\"milestones\":{\"configure\":0,\"paused\":300},\"tracks\":{}}");
+
+	DestroyAMPGstPlayer();
+}
+
+TEST_F(GstPlayerTests, AsyncTeardown_PendingLimitFailsTune)
+{
+	GstElement reaped = {.object = {.name = (gchar *)"reapedPipeline"}};
+	std::promise<void> release;
+	std::shared_future<void> released = release.get_future().share();
+	std::vector<MsgType> busEvents;
+
+	ConstructAMPGstPlayer();
+	mInterfaceGstPlayer->RegisterBusEvent([&busEvents](const BusEventData &event) {
+		busEvents.push_back(event.msgType);
+	});
+	mInterfaceGstPlayer->m_gstConfigParam->asyncPipelineTeardown = true;
+	mInterfaceGstPlayer->m_gstConfigParam->asyncTeardownMaxPending = 0;
+	GstPlayerPriv *privateContext = mInterfaceGstPlayer->GetPrivatePlayer()->gstPrivateContext;
+	privateContext->pipeline = &gst_element_pipeline;
+	privateContext->bus = &bus;
+
+	// the outgoing pipeline is stuck in its NULL transition until released
+	EXPECT_CALL(*g_mockGStreamer, gst_element_set_state(&reaped, GST_STATE_NULL))
+		.WillOnce(Invoke([released](GstElement *, GstState) {
+			released.wait();
+			return GST_STATE_CHANGE_SUCCESS;
+		}));
+	EXPECT_CALL(*g_mockGStreamer, gst_element_set_state(&gst_element_pipeline, _)).Times(0);
+	PipelineReaper::GetInstance().Reap(&reaped, NULL, NULL);
+	EXPECT_FALSE(PipelineReaper::GetInstance().WaitForPending(0, 10));
+	EXPECT_EQ(PipelineReaper::GetInstance().Pending(), 1);
+
+	// the new pipeline stays in READY and the tune fails
+	mInterfaceGstPlayer->ConfigurePipeline(GST_FORMAT_INVALID, GST_FORMAT_INVALID, GST_FORMAT_INVALID, GST_FORMAT_INVALID,
+										   false, false, false, false, 0, GST_NORMAL_PLAY_RATE, "testPipeline", 0, false, "testManifest");
+	ASSERT_EQ(busEvents.size(), 1u);
+	EXPECT_EQ(busEvents[0], MESSAGE_ERROR);
+
+	release.set_value();
+	EXPECT_TRUE(PipelineReaper::GetInstance().WaitForPending(0, 2000));
+	EXPECT_EQ(PipelineReaper::GetInstance().Pending(), 0);
+	testing::Mock::VerifyAndClearExpectations(g_mockGStreamer);
+
+	privateContext->pipeline = NULL;
+	privateContext->bus = NULL;
+	DestroyAMPGstPlayer();
+}
+
+TEST_F(GstPlayerTests, AsyncTeardown_StuckPusherFlushedBeforeReap)
+{
+	GstElement sinkbin = {.object = {.name = (gchar *)"videoSinkbin"}};
+
+	ConstructAMPGstPlayer();
+	mInterfaceGstPlayer->m_gstConfigParam->asyncPipelineTeardown = true;
+	GstPlayerPriv *privateContext = mInterfaceGstPlayer->GetPrivatePlayer()->gstPrivateContext;
+	privateContext->pipeline = &gst_element_pipeline;
+	privateContext->bus = &bus;
+	gst_media_stream *video = &privateContext->stream[eGST_MEDIATYPE_VIDEO];
+	video->format = GST_FORMAT_ISO_BMFF;
+	video->sinkbin = &sinkbin;
+	video->sourceState = eGST_SOURCE_CONFIGURED;
+	// a push that is still inside the appsrc when Stop starts
+	ASSERT_TRUE(video->EnterConfiguredSource());
+
+	// the sinkbin NULL transition fails the push, and has to happen while the pipeline is still attached
+	EXPECT_CALL(*g_mockGStreamer, gst_element_set_state(&sinkbin, GST_STATE_NULL))
+		.WillOnce(Invoke([privateContext, video, this](GstElement *, GstState) {
+			EXPECT_EQ(privateContext->pipeline, &gst_element_pipeline);
+			video->LeaveConfiguredSource();
+			return GST_STATE_CHANGE_SUCCESS;
+		}));
+	mInterfaceGstPlayer->Stop(false);
+	EXPECT_EQ(video->activePushers.load(), 0);
+	EXPECT_EQ(video->sinkbin, nullptr);
+	EXPECT_EQ(privateContext->pipeline, nullptr);
+	EXPECT_TRUE(PipelineReaper::GetInstance().WaitForPending(0, 2000));
+	testing::Mock::VerifyAndClearExpectations(g_mockGStreamer);
+
+	DestroyAMPGstPlayer();
+}
+
+TEST_F(GstPlayerTests, MonitorAV_BackoffFollowsConfig)
+{
+	PlayerAVSyncStats stats;
+	int queries = 0;
+
+	ConstructAMPGstPlayer();
+	SetupPipeline(&tbl[0]);
+	mInterfaceGstPlayer->m_gstConfigParam->monitorAV = true;
+	mInterfaceGstPlayer->m_gstConfigParam->monitorAvsyncThresholdPositiveMs = 100;
+	mInterfaceGstPlayer->m_gstConfigParam->monitorAvsyncThresholdNegativeMs = -100;
+	mInterfaceGstPlayer->m_gstConfigParam->monitorAvJumpThresholdMs = 1000;
+
+	// both tracks advance with the wall clock, video 20ms ahead of audio
+	EXPECT_CALL(*g_mockGStreamer, gst_element_get_state(&gst_element_pipeline, _, _, _))
+		.WillRepeatedly(DoAll(
+			SetArgPointee<1>(GST_STATE_PLAYING),
+			SetArgPointee<2>(GST_STATE_PLAYING),
+			Return(GST_STATE_CHANGE_SUCCESS)));
+	EXPECT_CALL(*g_mockPlayerUtils, GetCurrentTimeMS())
+		.WillRepeatedly(Invoke([&queries]() { return 1000 + 250 * (long long)(queries / 2); }));
+	EXPECT_CALL(*g_mockGStreamer, gst_element_query_position(_, GST_FORMAT_TIME, _))
+		.WillRepeatedly(Invoke([&queries](GstElement *, GstFormat, gint64 *cur) {
+			bool video = (queries % 2) == 0;
+			*cur = (gint64)(1000 + 250 * (queries / 2) - (video ? 0 : 20)) * GST_MSECOND;
+			queries++;
+			return TRUE;
+		}));
+
+	// off by default: every progress tick polls
+	ASSERT_FALSE(mInterfaceGstPlayer->m_gstConfigParam->monitorAvBackoff);
+	for (int tick = 0; tick < 17; tick++)
+	{
+		MonitorAV(mInterfaceGstPlayer);
+	}
+	EXPECT_TRUE(mInterfaceGstPlayer->GetAVSyncStats(stats));
+	EXPECT_EQ(stats.polls, 17u);
+	EXPECT_EQ(stats.skippedPolls, 0u);
+	EXPECT_EQ(stats.driftSamples, 17u);
+	EXPECT_EQ(stats.outOfSyncSamples, 0u);
+	EXPECT_EQ(stats.p50DriftMs, 20);
+	EXPECT_EQ(stats.pollIntervalTicks, 1);
+
+	mInterfaceGstPlayer->ResetAVSyncStats();
+	mInterfaceGstPlayer->m_gstConfigParam->monitorAvBackoff = true;
+	for (int tick = 0; tick < 17; tick++)
+	{
+		MonitorAV(mInterfaceGstPlayer);
+	}
+	mInterfaceGstPlayer->GetAVSyncStats(stats);
+	EXPECT_EQ(stats.polls, 10u);
+	EXPECT_EQ(stats.skippedPolls, 7u);
+	EXPECT_EQ(stats.pollIntervalTicks, (int)AVSyncMonitor::kMaxPollIntervalTicks);
+
+	DestroyAMPGstPlayer();
+}
+
+/**
+ * @brief PlayerBufferReleaseCallback counting the releases of a fragment
+ */
+static void CountRelease(void *ptr, void *releaseData)
+{
+	(*static_cast<int *>(releaseData))++;
+}
+
+/**
+ * @brief Inject a caller owned video fragment through SendHelperZeroCopy
+ */
+static bool PushZeroCopy(InterfacePlayerRDK *player, const void *ptr, size_t len, int *releases)
+{
+	bool discontinuity = false;
+	bool notifyFirstBufferProcessed = false;
+	bool sendNewSegmentEvent = false;
+	bool resetTrickUTC = false;
+	bool firstBufferPushed = false;
+
+	return player->SendHelperZeroCopy(eGST_MEDIATYPE_VIDEO, ptr, len, CountRelease, releases, 10.0, 10.0, 2.0, 0.0, false,
+									  discontinuity, notifyFirstBufferProcessed, sendNewSegmentEvent, resetTrickUTC, firstBufferPushed);
+}
+
+TEST_F(GstPlayerTests, ZeroCopy_ReleasedOnceAfterLastUnref)
+{
+	static char payload[16];
+	int releases = 0;
+	GstBuffer *queued = NULL;
+
+	ConstructAMPGstPlayer();
+	SetupPipeline(&tbl[0]);
+	ConfigureSources(mInterfaceGstPlayer);
+	std::atomic<int> &outstanding = *mInterfaceGstPlayer->GetPrivatePlayer()->gstPrivateContext->stream[eGST_MEDIATYPE_VIDEO].zeroCopyBuffersOutstanding;
+
+	// the pipeline keeps a reference after the push, as a queue would
+	EXPECT_CALL(*g_mockGStreamer, gst_app_src_push_buffer(_, NotNull()))
+		.WillOnce(Invoke([&queued](GstAppSrc *, GstBuffer *buffer) {
+			queued = gst_buffer_ref(buffer);
+			return GST_FLOW_OK;
+		}));
+	EXPECT_TRUE(PushZeroCopy(mInterfaceGstPlayer, payload, sizeof(payload), &releases));
+	EXPECT_EQ(releases, 0);
+	EXPECT_EQ(outstanding.load(), 1);
+
+	ASSERT_NE(queued, nullptr);
+	gst_buffer_unref(queued);
+	EXPECT_EQ(releases, 1);
+	EXPECT_EQ(outstanding.load(), 0);
+
+	DestroyAMPGstPlayer();
+}
+
+TEST_F(GstPlayerTests, ZeroCopy_ReleasedOnceOnPushFailure)
+{
+	static char payload[16];
+	int releases = 0;
+
+	ConstructAMPGstPlayer();
+	SetupPipeline(&tbl[0]);
+	ConfigureSources(mInterfaceGstPlayer);
+	std::atomic<int> &outstanding = *mInterfaceGstPlayer->GetPrivatePlayer()->gstPrivateContext->stream[eGST_MEDIATYPE_VIDEO].zeroCopyBuffersOutstanding;
+
+	EXPECT_CALL(*g_mockGStreamer, gst_app_src_push_buffer(_, NotNull()))
+		.WillOnce(Return(GST_FLOW_FLUSHING));
+	PushZeroCopy(mInterfaceGstPlayer, payload, sizeof(payload), &releases);
+	EXPECT_EQ(releases, 1);
+	EXPECT_EQ(outstanding.load(), 0);
+
+	DestroyAMPGstPlayer();
+}
+
+TEST_F(GstPlayerTests, ZeroCopy_ReleasedOnceWhenInjectorPaused)
+{
+	static char payload[16];
+	int releases = 0;
+
+	ConstructAMPGstPlayer();
+	SetupPipeline(&tbl[0]);
+	ConfigureSources(mInterfaceGstPlayer);
+	std::atomic<int> &outstanding = *mInterfaceGstPlayer->GetPrivatePlayer()->gstPrivateContext->stream[eGST_MEDIATYPE_VIDEO].zeroCopyBuffersOutstanding;
+
+	mInterfaceGstPlayer->PauseInjector();
+	EXPECT_CALL(*g_mockGStreamer, gst_app_src_push_buffer(_, _)).Times(0);
+	EXPECT_FALSE(PushZeroCopy(mInterfaceGstPlayer, payload, sizeof(payload), &releases));
+	EXPECT_EQ(releases, 1);
+	EXPECT_EQ(outstanding.load(), 0);
+	mInterfaceGstPlayer->ResumeInjector();
+
+	DestroyAMPGstPlayer();
+}
+
+TEST_F(GstPlayerTests, ZeroCopy_ReleasedOnceWhenWrapFails)
+{
+	int releases = 0;
+
+	ConstructAMPGstPlayer();
+	SetupPipeline(&tbl[0]);
+	ConfigureSources(mInterfaceGstPlayer);
+	std::atomic<int> &outstanding = *mInterfaceGstPlayer->GetPrivatePlayer()->gstPrivateContext->stream[eGST_MEDIATYPE_VIDEO].zeroCopyBuffersOutstanding;
+
+	// gst_buffer_new_wrapped_full refuses NULL memory without calling its notify
+	EXPECT_CALL(*g_mockGStreamer, gst_app_src_push_buffer(_, _)).Times(0);
+	EXPECT_FALSE(PushZeroCopy(mInterfaceGstPlayer, NULL, 16, &releases));
+	EXPECT_EQ(releases, 1);
+	EXPECT_EQ(outstanding.load(), 0);
+
+	DestroyAMPGstPlayer();
+}
+
+TEST_F(GstPlayerTests, ZeroCopyTicks_ExactTimestamps)
+{
+	static char payload[16];
+	int releases = 0;
+	bool discontinuity = false;
+	bool notifyFirstBufferProcessed = false;
+	bool sendNewSegmentEvent = false;
+	bool resetTrickUTC = false;
+	bool firstBufferPushed = false;
+	GstClockTime pts = GST_CLOCK_TIME_NONE;
+	GstClockTime duration = GST_CLOCK_TIME_NONE;
+	// a month of 90kHz ticks plus one, beyond what a double in seconds holds to the nanosecond
+	const uint64_t ptsTicks = 90000ull * 3600 * 24 * 30 + 1;
+
+	ConstructAMPGstPlayer();
+	SetupPipeline(&tbl[0]);
+	ConfigureSources(mInterfaceGstPlayer);
+
+	EXPECT_CALL(*g_mockGStreamer, gst_app_src_push_buffer(_, NotNull()))
+		.WillOnce(Invoke([&pts, &duration](GstAppSrc *, GstBuffer *buffer) {
+			pts = GST_BUFFER_PTS(buffer);
+			duration = GST_BUFFER_DURATION(buffer);
+			return GST_FLOW_OK;
+		}));
+	EXPECT_TRUE(mInterfaceGstPlayer->SendHelperZeroCopyTicks(eGST_MEDIATYPE_VIDEO, payload, sizeof(payload), CountRelease, &releases,
+															 ptsTicks, ptsTicks, 3003, 90000, 0.0, false,
+															 discontinuity, notifyFirstBufferProcessed, sendNewSegmentEvent, resetTrickUTC, firstBufferPushed));
+	EXPECT_EQ(pts, gst_util_uint64_scale(ptsTicks, GST_SECOND, 90000));
+	EXPECT_EQ(duration, 33366666u);
+	EXPECT_EQ(releases, 1);
+
+	// no timescale: nothing is pushed and the memory goes straight back
+	EXPECT_CALL(*g_mockGStreamer, gst_app_src_push_buffer(_, _)).Times(0);
+	EXPECT_FALSE(mInterfaceGstPlayer->SendHelperZeroCopyTicks(eGST_MEDIATYPE_VIDEO, payload, sizeof(payload), CountRelease, &releases,
+															  ptsTicks, ptsTicks, 3003, 0, 0.0, false,
+															  discontinuity, notifyFirstBufferProcessed, sendNewSegmentEvent, resetTrickUTC, firstBufferPushed));
+	EXPECT_EQ(releases, 2);
+
+	DestroyAMPGstPlayer();
+}
+
+TEST_F(GstPlayerTests, ChunkTicks_ExactTimestamps)
+{
+	static char payload[16];
+	GstBuffer buffer = {};
+	bool discontinuity = false;
+	bool notifyFirstBufferProcessed = false;
+	bool sendNewSegmentEvent = false;
+	bool resetTrickUTC = false;
+	bool firstBufferPushed = false;
+	const uint64_t ptsTicks = 48000ull * 3600 * 24 * 30 + 1;
+
+	ConstructAMPGstPlayer();
+	SetupPipeline(&tbl[0]);
+	ConfigureSources(mInterfaceGstPlayer);
+
+	EXPECT_CALL(*g_mockGStreamer, gst_buffer_new_wrapped(payload, sizeof(payload)))
+		.WillOnce(Return(&buffer));
+	EXPECT_TRUE(mInterfaceGstPlayer->SendHelperChunkTicks(eGST_MEDIATYPE_AUDIO, payload, sizeof(payload), ptsTicks, ptsTicks, 1024, 48000, 0.0, false, true,
+														  discontinuity, notifyFirstBufferProcessed, sendNewSegmentEvent, resetTrickUTC, firstBufferPushed));
+	EXPECT_EQ(GST_BUFFER_PTS(&buffer), gst_util_uint64_scale(ptsTicks, GST_SECOND, 48000));
+	EXPECT_EQ(GST_BUFFER_DURATION(&buffer), 21333333u);
+
+	EXPECT_CALL(*g_mockGStreamer, gst_buffer_new_wrapped(_, _)).Times(0);
+	EXPECT_FALSE(mInterfaceGstPlayer->SendHelperChunkTicks(eGST_MEDIATYPE_AUDIO, payload, sizeof(payload), ptsTicks, ptsTicks, 1024, 0, 0.0, false, true,
+														   discontinuity, notifyFirstBufferProcessed, sendNewSegmentEvent, resetTrickUTC, firstBufferPushed));
+
+	DestroyAMPGstPlayer();
+}
@@ -0,0 +1,173 @@
+/*
+ * If not stated otherwise in this file or this component's license file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2025 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+#include <map>
+
+#include "MockGStreamer.h"
+#include "InterfacePlayerRDK.h"
+#include "InterfacePlayerPriv.h"
+
+using ::testing::_;
+using ::testing::DoAll;
+using ::testing::Invoke;
+using ::testing::NiceMock;
+using ::testing::Return;
+using ::testing::SaveArg;
+using ::testing::SaveArgPointee;
+using ::testing::SetArgPointee;
+
+class InjectionBufferPoolTests : public ::testing::Test
+{
+protected:
+	struct PoolConfig
+	{
+		guint size;
+		guint maxBuffers;
+	};
+	static const size_t kKiB = 1024;
+	static const size_t kMiB = 1024 * 1024;
+
+	GstBufferPool mGstPools[InjectionBufferPool::kSizeClassCount * 2] = {};
+	int mPoolsCreated = 0;
+	std::map<GstBufferPool *, PoolConfig> mConfigs;
+	GstBuffer mBuffer = {};
+	InjectionBufferPool *mPool = nullptr;
+
+	void SetUp() override
+	{
+		g_mockGStreamer = new NiceMock<MockGStreamer>();
+		// each new pool is a distinct object; its config is identified by the pool itself
+		ON_CALL(*g_mockGStreamer, gst_buffer_pool_new())
+			.WillByDefault(Invoke([this]() { return &mGstPools[mPoolsCreated++]; }));
+		ON_CALL(*g_mockGStreamer, gst_buffer_pool_get_config(_))
+			.WillByDefault(Invoke([](GstBufferPool *pool) { return (GstStructure *)pool; }));
+		ON_CALL(*g_mockGStreamer, gst_buffer_pool_config_set_params(_, _, _, _, _))
+			.WillByDefault(Invoke([this](GstStructure *config, GstCaps *, guint size, guint, guint maxBuffers) {
+				mConfigs[(GstBufferPool *)config] = {size, maxBuffers};
+			}));
+		ON_CALL(*g_mockGStreamer, gst_buffer_pool_set_config(_, _)).WillByDefault(Return(TRUE));
+		ON_CALL(*g_mockGStreamer, gst_buffer_pool_set_active(_, _)).WillByDefault(Return(TRUE));
+		ON_CALL(*g_mockGStreamer, gst_buffer_pool_acquire_buffer(_, _, _))
+			.WillByDefault(DoAll(SetArgPointee<1>(&mBuffer), Return(GST_FLOW_OK)));
+		mPool = new InjectionBufferPool();
+		mPool->Configure(4 * kMiB, 0);
+	}
+
+	void TearDown() override
+	{
+		delete mPool;
+		mPool = nullptr;
+		delete g_mockGStreamer;
+		g_mockGStreamer = nullptr;
+	}
+
+	/**
+	 * @brief Acquire len bytes and return the size class of the pool the buffer came from, 0 if none
+	 */
+	guint AcquiredClass(size_t len)
+	{
+		GstBufferPool *from = nullptr;
+		EXPECT_CALL(*g_mockGStreamer, gst_buffer_pool_acquire_buffer(_, _, _))
+			.WillRepeatedly(DoAll(SaveArg<0>(&from), SetArgPointee<1>(&mBuffer), Return(GST_FLOW_OK)));
+		GstBuffer *buffer = mPool->Acquire(len);
+		testing::Mock::VerifyAndClearExpectations(g_mockGStreamer);
+		if (!buffer)
+		{
+			return 0;
+		}
+		EXPECT_EQ(buffer, &mBuffer);
+		return mConfigs.count(from) ? mConfigs[from].size : 0;
+	}
+};
+
+TEST_F(InjectionBufferPoolTests, SizeClassIsSmallestThatFits)
+{
+	EXPECT_EQ(AcquiredClass(1), 16 * kKiB);
+	EXPECT_EQ(AcquiredClass(16 * kKiB), 16 * kKiB);
+	EXPECT_EQ(AcquiredClass(16 * kKiB + 1), 64 * kKiB);
+	EXPECT_EQ(AcquiredClass(256 * kKiB), 256 * kKiB);
+	EXPECT_EQ(AcquiredClass(256 * kKiB + 1), 1 * kMiB);
+	EXPECT_EQ(AcquiredClass(4 * kMiB), 4 * kMiB);
+	// one pool per class, created on first use
+	EXPECT_EQ(mPoolsCreated, 5);
+}
+
+TEST_F(InjectionBufferPoolTests, LargerThanBiggestClassIsNotPooled)
+{
+	EXPECT_CALL(*g_mockGStreamer, gst_buffer_pool_new()).Times(0);
+	EXPECT_EQ(mPool->Acquire(4 * kMiB + 1), nullptr);
+}
+
+TEST_F(InjectionBufferPoolTests, BuffersPerClassBoundedByQueueBytes)
+{
+	mPool->Configure(1 * kMiB, 0);
+	ASSERT_NE(mPool->Acquire(1), nullptr);
+	ASSERT_NE(mPool->Acquire(4 * kMiB), nullptr);
+	EXPECT_EQ(mConfigs[&mGstPools[0]].maxBuffers, 64u);
+	// never fewer than one queued and one being filled
+	EXPECT_EQ(mConfigs[&mGstPools[1]].maxBuffers, 2u);
+
+	mPool->Reset();
+	mPool->Configure(1 * kMiB, 8);
+	ASSERT_NE(mPool->Acquire(1), nullptr);
+	EXPECT_EQ(mConfigs[&mGstPools[2]].maxBuffers, 8u);
+}
+
+TEST_F(InjectionBufferPoolTests, ExhaustedClassFallsBack)
+{
+	GstBufferPoolAcquireParams params = {};
+	// a class whose buffers are all queued downstream does not block the injector
+	EXPECT_CALL(*g_mockGStreamer, gst_buffer_pool_acquire_buffer(_, _, _))
+		.WillOnce(DoAll(SaveArgPointee<2>(&params), Return(GST_FLOW_EOS)));
+	EXPECT_CALL(*g_mockGStreamer, gst_buffer_resize(_, _, _)).Times(0);
+	EXPECT_EQ(mPool->Acquire(1000), nullptr);
+	EXPECT_TRUE(params.flags & GST_BUFFER_POOL_ACQUIRE_FLAG_DONTWAIT);
+}
+
+TEST_F(InjectionBufferPoolTests, ReusedBufferSizedToEachRequest)
+{
+	// the pool hands the same buffer back at its full class size; each acquire trims it to the fragment
+	EXPECT_CALL(*g_mockGStreamer, gst_buffer_resize(&mBuffer, 0, 100)).Times(1);
+	EXPECT_EQ(mPool->Acquire(100), &mBuffer);
+	EXPECT_CALL(*g_mockGStreamer, gst_buffer_resize(&mBuffer, 0, 16000)).Times(1);
+	EXPECT_EQ(mPool->Acquire(16000), &mBuffer);
+	EXPECT_EQ(mPoolsCreated, 1);
+}
+
+TEST_F(InjectionBufferPoolTests, UnusablePoolFallsBack)
+{
+	EXPECT_CALL(*g_mockGStreamer, gst_buffer_pool_set_active(_, TRUE)).WillOnce(Return(FALSE));
+	EXPECT_CALL(*g_mockGStreamer, gst_object_unref(&mGstPools[0])).Times(1);
+	EXPECT_EQ(mPool->Acquire(100), nullptr);
+}
+
+TEST_F(InjectionBufferPoolTests, ResetDeactivatesAndDropsPools)
+{
+	ASSERT_NE(mPool->Acquire(100), nullptr);
+	EXPECT_CALL(*g_mockGStreamer, gst_buffer_pool_set_active(&mGstPools[0], FALSE)).WillOnce(Return(TRUE));
+	EXPECT_CALL(*g_mockGStreamer, gst_object_unref(&mGstPools[0])).Times(1);
+	mPool->Reset();
+	testing::Mock::VerifyAndClearExpectations(g_mockGStreamer);
+
+	// the next acquire starts a new pool
+	ASSERT_NE(mPool->Acquire(100), nullptr);
+	EXPECT_EQ(mPoolsCreated, 2);
+}
@@ -0,0 +1,134 @@
+/*
+ * If not stated otherwise in this file or this component's license file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2025 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+#include <cstring>
+
+#include "InterfacePlayerRDK.h"
+#include "InterfacePlayerPriv.h"
+
+class InjectionStatsCountersTests : public ::testing::Test
+{
+protected:
+	static const gint64 kStartUs = 1000000;
+
+	InjectionStatsCounters mCounters;
+
+	PlayerInjectionStats Snapshot()
+	{
+		PlayerInjectionStats stats = {};
+		mCounters.Snapshot(stats);
+		return stats;
+	}
+
+	/**
+	 * @brief Record one successful push taking elapsedUs and return the latency bucket it landed in, -1 if none
+	 */
+	int BucketOf(gint64 elapsedUs)
+	{
+		mCounters.Reset();
+		mCounters.RecordPush(100, 1, kStartUs, kStartUs + elapsedUs, true, 0);
+		PlayerInjectionStats stats = Snapshot();
+		for (int i = 0; i < PlayerInjectionStats::kLatencyBuckets; i++)
+		{
+			if (stats.pushLatencyHistogram[i])
+			{
+				return i;
+			}
+		}
+		return -1;
+	}
+};
+
+TEST_F(InjectionStatsCountersTests, LatencyBucketsAreDecades)
+{
+	EXPECT_EQ(BucketOf(0), 0);
+	EXPECT_EQ(BucketOf(9), 0);
+	EXPECT_EQ(BucketOf(10), 1);
+	EXPECT_EQ(BucketOf(99), 1);
+	EXPECT_EQ(BucketOf(100), 2);
+	EXPECT_EQ(BucketOf(999), 2);
+	EXPECT_EQ(BucketOf(1000), 3);
+	EXPECT_EQ(BucketOf(10000), 4);
+	EXPECT_EQ(BucketOf(100000), 5);
+	EXPECT_EQ(BucketOf(999999), 5);
+	// one second and above share the last bucket
+	EXPECT_EQ(BucketOf(1000000), 6);
+	EXPECT_EQ(BucketOf(60000000), 6);
+	// a clock step backwards counts as no time
+	EXPECT_EQ(BucketOf(-5), 0);
+}
+
+TEST_F(InjectionStatsCountersTests, FailedPushCountedButNotItsPayload)
+{
+	mCounters.RecordPush(1000, 1, kStartUs, kStartUs + 50, true, 4000);
+	mCounters.RecordPush(2000, 3, kStartUs + 100, kStartUs + 2000, false, 1000);
+	PlayerInjectionStats stats = Snapshot();
+	EXPECT_EQ(stats.pushCalls, 2u);
+	EXPECT_EQ(stats.pushFailures, 1u);
+	EXPECT_EQ(stats.bytesPushed, 1000u);
+	EXPECT_EQ(stats.buffersPushed, 1u);
+	// latency and queue level are sampled whatever the outcome
+	EXPECT_EQ(stats.pushLatencyHistogram[1], 1u);
+	EXPECT_EQ(stats.pushLatencyHistogram[3], 1u);
+	EXPECT_EQ(stats.maxPushLatencyUs, 1900u);
+	EXPECT_EQ(stats.queuedBytes, 1000u);
+	EXPECT_EQ(stats.maxQueuedBytes, 4000u);
+}
+
+TEST_F(InjectionStatsCountersTests, ThroughputOverActiveTime)
+{
+	EXPECT_EQ(Snapshot().bytesPerSecond, 0.0);
+
+	// a single instantaneous push has no active time to divide by
+	mCounters.RecordPush(500000, 1, kStartUs, kStartUs, true, 0);
+	EXPECT_EQ(Snapshot().activeTimeUs, 0u);
+	EXPECT_EQ(Snapshot().bytesPerSecond, 0.0);
+
+	mCounters.RecordPush(500000, 1, kStartUs + 1000000, kStartUs + 1000000, true, 0);
+	mCounters.RecordPush(1000000, 2, kStartUs + 1500000, kStartUs + 2000000, true, 0);
+	PlayerInjectionStats stats = Snapshot();
+	EXPECT_EQ(stats.bytesPushed, 2000000u);
+	EXPECT_EQ(stats.buffersPushed, 4u);
+	// from the start of the first push to the end of the last one
+	EXPECT_EQ(stats.activeTimeUs, 2000000u);
+	EXPECT_DOUBLE_EQ(stats.bytesPerSecond, 1000000.0);
+}
+
+TEST_F(InjectionStatsCountersTests, ResetClearsEverything)
+{
+	mCounters.RecordPush(1000, 1, kStartUs, kStartUs + 10, false, 100);
+	mCounters.RecordNeedData();
+	mCounters.RecordEnoughData();
+	mCounters.RecordBlocked(250);
+	mCounters.RecordBlocked(-1);
+	PlayerInjectionStats stats = Snapshot();
+	EXPECT_EQ(stats.needDataCount, 1u);
+	EXPECT_EQ(stats.enoughDataCount, 1u);
+	EXPECT_EQ(stats.blockedTimeUs, 250u);
+
+	mCounters.Reset();
+	PlayerInjectionStats cleared = Snapshot();
+	PlayerInjectionStats zero = {};
+	EXPECT_EQ(memcmp(&cleared, &zero, sizeof(zero)), 0);
+
+	// the active window restarts from the next push
+	mCounters.RecordPush(1000, 1, kStartUs * 5, kStartUs * 5 + 1000, true, 0);
+	EXPECT_EQ(Snapshot().activeTimeUs, 1000u);
+}
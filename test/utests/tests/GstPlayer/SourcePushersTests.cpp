@@ -0,0 +1,147 @@
+/*
+ * If not stated otherwise in this file or this component's license file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2025 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+#include "InterfacePlayerRDK.h"
+#include "InterfacePlayerPriv.h"
+
+/**
+ * @brief Enter/leave/drain state machine of the lock free injection path
+ */
+class SourcePushersTests : public ::testing::Test
+{
+protected:
+	gst_media_stream mStream;
+
+	void Configure()
+	{
+		mStream.sourceState.store(eGST_SOURCE_CONFIGURED);
+	}
+};
+
+TEST_F(SourcePushersTests, EnterOnlyWhenConfigured)
+{
+	EXPECT_FALSE(mStream.EnterConfiguredSource());
+	EXPECT_EQ(mStream.activePushers.load(), 0);
+
+	Configure();
+	EXPECT_TRUE(mStream.EnterConfiguredSource());
+	EXPECT_TRUE(mStream.EnterConfiguredSource());
+	EXPECT_EQ(mStream.activePushers.load(), 2);
+	mStream.LeaveConfiguredSource();
+	mStream.LeaveConfiguredSource();
+	EXPECT_EQ(mStream.activePushers.load(), 0);
+}
+
+TEST_F(SourcePushersTests, DrainWithoutPushersReturnsAtOnce)
+{
+	Configure();
+	EXPECT_TRUE(mStream.DrainPushers(0));
+	EXPECT_EQ(mStream.sourceState.load(), eGST_SOURCE_TEARDOWN);
+	// pushers arriving after the drain take the locked path and are not counted
+	EXPECT_FALSE(mStream.EnterConfiguredSource());
+	EXPECT_EQ(mStream.activePushers.load(), 0);
+}
+
+TEST_F(SourcePushersTests, DrainTimesOutWhilePusherActive)
+{
+	Configure();
+	ASSERT_TRUE(mStream.EnterConfiguredSource());
+	EXPECT_FALSE(mStream.DrainPushers(20));
+	EXPECT_EQ(mStream.sourceState.load(), eGST_SOURCE_TEARDOWN);
+	EXPECT_EQ(mStream.activePushers.load(), 1);
+	// a later drain, as TearDownStream retries, completes once the pusher leaves
+	mStream.LeaveConfiguredSource();
+	EXPECT_TRUE(mStream.DrainPushers(0));
+}
+
+TEST_F(SourcePushersTests, LastLeaveWakesDrain)
+{
+	Configure();
+	ASSERT_TRUE(mStream.EnterConfiguredSource());
+	ASSERT_TRUE(mStream.EnterConfiguredSource());
+	std::atomic<bool> drainReturned{false};
+	bool drained = false;
+	std::thread drainer([&]()
+	{
+		drained = mStream.DrainPushers(10000);
+		drainReturned = true;
+	});
+	while (mStream.sourceState.load() != eGST_SOURCE_TEARDOWN)
+	{
+		std::this_thread::yield();
+	}
+	mStream.LeaveConfiguredSource();
+	std::this_thread::sleep_for(std::chrono::milliseconds(20));
+	EXPECT_FALSE(drainReturned.load());
+	auto start = std::chrono::steady_clock::now();
+	mStream.LeaveConfiguredSource();
+	drainer.join();
+	EXPECT_TRUE(drained);
+	// woken by the leave, not by the timeout
+	EXPECT_LT(std::chrono::steady_clock::now() - start, std::chrono::seconds(5));
+}
+
+TEST_F(SourcePushersTests, NoPusherInsideAfterDrain)
+{
+	const int kPushers = 4;
+	Configure();
+	std::atomic<int> inside{0};
+	std::atomic<bool> stop{false};
+	std::atomic<bool> violated{false};
+	std::vector<std::thread> pushers;
+	for (int i = 0; i < kPushers; i++)
+	{
+		pushers.emplace_back([&]()
+		{
+			while (!stop.load())
+			{
+				if (mStream.EnterConfiguredSource())
+				{
+					inside++;
+					if (mStream.sourceState.load() == eGST_SOURCE_UNCONFIGURED)
+					{ // teardown released the source while this pusher was still on it
+						violated = true;
+					}
+					inside--;
+					mStream.LeaveConfiguredSource();
+				}
+			}
+		});
+	}
+	std::this_thread::sleep_for(std::chrono::milliseconds(20));
+	while (!mStream.DrainPushers(200))
+	{
+	}
+	EXPECT_EQ(inside.load(), 0);
+	EXPECT_EQ(mStream.activePushers.load(), 0);
+	mStream.sourceState.store(eGST_SOURCE_UNCONFIGURED);
+	std::this_thread::sleep_for(std::chrono::milliseconds(20));
+	stop = true;
+	for (auto &pusher : pushers)
+	{
+		pusher.join();
+	}
+	EXPECT_FALSE(violated.load());
+}
@@ -0,0 +1,247 @@
+/*
+* If not stated otherwise in this file or this component's license file the
+* following copyright and licenses apply:
+*
+* Copyright 2025 RDK Management
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+#include <gtest/gtest.h>
+#include <gst/gst.h>
+#include <errno.h>
+#include <unistd.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <algorithm>
+#include <vector>
+
+#include "gstplayertaskpool.h"
+
+namespace
+{
+/** Tasks run on the calling thread so far; 1 inside the first task of a new thread */
+thread_local int tasksOnThread = 0;
+
+int ThreadNice()
+{
+	return getpriority(PRIO_PROCESS, (id_t)syscall(SYS_gettid));
+}
+
+/**
+ * @brief What one task saw of the thread it ran on; the task blocks until released
+ */
+struct TaskRun
+{
+	GMutex lock;
+	GCond cond;
+	bool released;
+	bool finished;
+	int tasksOnThread;
+	int nice;
+
+	explicit TaskRun(bool release = true) : released(release), finished(false), tasksOnThread(0), nice(0)
+	{
+		g_mutex_init(&lock);
+		g_cond_init(&cond);
+	}
+
+	~TaskRun()
+	{
+		g_mutex_clear(&lock);
+		g_cond_clear(&cond);
+	}
+
+	void Release()
+	{
+		g_mutex_lock(&lock);
+		released = true;
+		g_cond_signal(&cond);
+		g_mutex_unlock(&lock);
+	}
+};
+
+void TaskBody(gpointer data)
+{
+}
+
+void RunTask(gpointer data)
+{
+	TaskRun *run = (TaskRun *)g_object_get_data(G_OBJECT(data), "task-run");
+	g_mutex_lock(&run->lock);
+	while (!run->released)
+	{
+		g_cond_wait(&run->cond, &run->lock);
+	}
+	run->tasksOnThread = ++tasksOnThread;
+	run->nice = ThreadNice();
+	run->finished = true;
+	g_mutex_unlock(&run->lock);
+}
+}
+
+class GstPlayerTaskPoolTests : public ::testing::Test
+{
+protected:
+	GstTaskPool *mPool;
+	std::vector<GstTask *> mTasks;
+
+	void SetUp() override
+	{
+		mPool = (GstTaskPool *)g_object_new(GST_TYPE_PLAYER_TASKPOOL, NULL);
+	}
+
+	void TearDown() override
+	{
+		// retires whatever this test left parked
+		gst_player_taskpool_set_max_idle_threads(this, 0);
+		for (GstTask *task : mTasks)
+		{
+			gst_object_unref(task);
+		}
+		gst_object_unref(mPool);
+	}
+
+	/**
+	 * @brief Push a task of taskClass the way GstTask does, with the task itself as data
+	 */
+	gpointer Push(TaskRun &run, guint taskClass = 0)
+	{
+		GstTask *task = gst_task_new(TaskBody, NULL, NULL);
+		gst_player_taskpool_set_task_class(task, taskClass);
+		g_object_set_data(G_OBJECT(task), "task-run", &run);
+		mTasks.push_back(task);
+
+		GError *error = NULL;
+		gpointer id = gst_task_pool_push(mPool, RunTask, task, &error);
+		EXPECT_NE(id, nullptr);
+		EXPECT_EQ(error, nullptr);
+		return id;
+	}
+
+	/**
+	 * @brief Run one task to completion and report how many tasks its thread has run
+	 */
+	int RunOne(guint taskClass = 0, int *nice = NULL)
+	{
+		TaskRun run;
+		gst_task_pool_join(mPool, Push(run, taskClass));
+		EXPECT_TRUE(run.finished);
+		if (nice)
+		{
+			*nice = run.nice;
+		}
+		return run.tasksOnThread;
+	}
+};
+
+TEST_F(GstPlayerTaskPoolTests, NoIdleThreadsEndsEachThread)
+{
+	EXPECT_EQ(RunOne(), 1);
+	EXPECT_EQ(RunOne(), 1);
+}
+
+TEST_F(GstPlayerTaskPoolTests, ParkedThreadIsReused)
+{
+	gst_player_taskpool_set_max_idle_threads(this, 1);
+	EXPECT_EQ(RunOne(), 1);
+	EXPECT_EQ(RunOne(), 2);
+	EXPECT_EQ(RunOne(), 3);
+}
+
+TEST_F(GstPlayerTaskPoolTests, JoinWaitsForTheTask)
+{
+	gst_player_taskpool_set_max_idle_threads(this, 1);
+	TaskRun run(false);
+	gpointer id = Push(run);
+	g_usleep(20 * 1000);
+	g_mutex_lock(&run.lock);
+	EXPECT_FALSE(run.finished);
+	g_mutex_unlock(&run.lock);
+	run.Release();
+	gst_task_pool_join(mPool, id);
+	EXPECT_TRUE(run.finished);
+}
+
+TEST_F(GstPlayerTaskPoolTests, IdleCapLimitsParkedThreads)
+{
+	gst_player_taskpool_set_max_idle_threads(this, 1);
+
+	// two tasks at once need two threads; only one of them may park afterwards
+	TaskRun first(false), second(false);
+	gpointer firstId = Push(first);
+	gpointer secondId = Push(second);
+	first.Release();
+	second.Release();
+	gst_task_pool_join(mPool, firstId);
+	gst_task_pool_join(mPool, secondId);
+	EXPECT_EQ(first.tasksOnThread, 1);
+	EXPECT_EQ(second.tasksOnThread, 1);
+
+	TaskRun third(false), fourth(false);
+	gpointer thirdId = Push(third);
+	gpointer fourthId = Push(fourth);
+	third.Release();
+	fourth.Release();
+	gst_task_pool_join(mPool, thirdId);
+	gst_task_pool_join(mPool, fourthId);
+	EXPECT_EQ(std::min(third.tasksOnThread, fourth.tasksOnThread), 1);
+	EXPECT_EQ(std::max(third.tasksOnThread, fourth.tasksOnThread), 2);
+}
+
+TEST_F(GstPlayerTaskPoolTests, LoweringTheCapRetiresParkedThreads)
+{
+	gst_player_taskpool_set_max_idle_threads(this, 1);
+	EXPECT_EQ(RunOne(), 1);
+	gst_player_taskpool_set_max_idle_threads(this, 0);
+	EXPECT_EQ(RunOne(), 1);
+}
+
+TEST_F(GstPlayerTaskPoolTests, LargestRequestOfAnyOwnerApplies)
+{
+	int otherOwner = 0;
+	gst_player_taskpool_set_max_idle_threads(this, 1);
+	gst_player_taskpool_set_max_idle_threads(&otherOwner, 0);
+	EXPECT_EQ(RunOne(), 1);
+	EXPECT_EQ(RunOne(), 2);
+
+	gst_player_taskpool_set_max_idle_threads(&otherOwner, 2);
+	gst_player_taskpool_set_max_idle_threads(this, 0);
+	EXPECT_EQ(RunOne(), 3);
+
+	gst_player_taskpool_set_max_idle_threads(&otherOwner, 0);
+	EXPECT_EQ(RunOne(), 1);
+}
+
+TEST_F(GstPlayerTaskPoolTests, ParkedThreadOnlyReusedForMatchingSched)
+{
+	int baseNice = ThreadNice();
+	if (baseNice >= 19)
+	{
+		GTEST_SKIP() << "nice cannot be raised from " << baseNice;
+	}
+	GstPlayerTaskpoolSched sched = { SCHED_OTHER, 0, baseNice + 1, 0 };
+	gst_player_taskpool_set_sched(GST_PLAYER_TASKPOOL(mPool), 1, &sched);
+	gst_player_taskpool_set_max_idle_threads(this, 2);
+
+	int nice = 0;
+	EXPECT_EQ(RunOne(0, &nice), 1);
+	EXPECT_EQ(nice, baseNice);
+	// raising the nice of the parked class 0 thread could not be undone without CAP_SYS_NICE
+	EXPECT_EQ(RunOne(1, &nice), 1);
+	EXPECT_EQ(nice, baseNice + 1);
+	EXPECT_EQ(RunOne(0, &nice), 2);
+	EXPECT_EQ(nice, baseNice);
+	EXPECT_EQ(RunOne(1, &nice), 2);
+	EXPECT_EQ(nice, baseNice + 1);
+}
@@ -39,6 +39,7 @@ protected:
 
     void TearDown() override
     {
+        ClearCapsCache();
         delete g_mockGStreamer;
         g_mockGStreamer = nullptr;
     }
@@ -56,6 +57,16 @@ TEST_F(GstUtilsTests, esMP3test)
     EXPECT_TRUE(GetCaps(GST_FORMAT_AUDIO_ES_MP3)==caps);
 }
 
+TEST_F(GstUtilsTests, CapsCachedPerFormat)
+{
+    GstCaps dummycaps;
+    GstCaps *caps{&dummycaps};
+    EXPECT_CALL(*g_mockGStreamer,gst_caps_new_simple(StrEq("audio/x-ac3"),_,_,_,_)).WillOnce(Return(caps));
+
+    EXPECT_TRUE(GetCaps(GST_FORMAT_AUDIO_ES_AC3)==caps);
+    EXPECT_TRUE(GetCaps(GST_FORMAT_AUDIO_ES_AC3)==caps);
+}
+
 TEST_F(GstUtilsTests, GstCapsFormatsTest)
 {
     GstCaps dummycapslist;
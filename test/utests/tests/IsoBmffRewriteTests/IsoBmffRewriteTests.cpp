@@ -0,0 +1,307 @@
+/*
+* If not stated otherwise in this file or this component's license file the
+* following copyright and licenses apply:
+*
+* Copyright 2025 RDK Management
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+#include <gtest/gtest.h>
+#include <cstring>
+#include <vector>
+
+#include "playerisobmffbuffer.h"
+#include "mp4demux.hpp"
+
+namespace
+{
+typedef std::vector<uint8_t> Bytes;
+
+void PutU32(Bytes &out, uint32_t value)
+{
+	for (int shift = 24; shift >= 0; shift -= 8)
+	{
+		out.push_back((uint8_t)(value >> shift));
+	}
+}
+
+void PutU64(Bytes &out, uint64_t value)
+{
+	PutU32(out, (uint32_t)(value >> 32));
+	PutU32(out, (uint32_t)value);
+}
+
+uint64_t GetU(const Bytes &in, size_t offset, int bytes)
+{
+	uint64_t value = 0;
+	for (int i = 0; i < bytes; i++)
+	{
+		value = (value << 8) | in[offset + i];
+	}
+	return value;
+}
+
+Bytes Box(const char *type, const Bytes &body, bool sizeZero = false)
+{
+	Bytes out;
+	PutU32(out, sizeZero ? 0 : (uint32_t)(8 + body.size()));
+	out.insert(out.end(), type, type + 4);
+	out.insert(out.end(), body.begin(), body.end());
+	return out;
+}
+
+void Append(Bytes &out, const Bytes &more)
+{
+	out.insert(out.end(), more.begin(), more.end());
+}
+
+Bytes Tfdt(uint8_t version, uint64_t baseMediaDecodeTime)
+{
+	Bytes body;
+	PutU32(body, (uint32_t)version << 24);
+	if (version == 1)
+	{
+		PutU64(body, baseMediaDecodeTime);
+	}
+	else
+	{
+		PutU32(body, (uint32_t)baseMediaDecodeTime);
+	}
+	return Box("tfdt", body);
+}
+
+Bytes Tfhd(uint32_t trackId)
+{
+	Bytes body;
+	PutU32(body, 0x020000); // default-base-is-moof
+	PutU32(body, trackId);
+	return Box("tfhd", body);
+}
+
+/**
+ * @brief moof with a single traf holding tfhd and the given tfdt, followed by a small mdat
+ */
+Bytes MoofAndMdat(const Bytes &tfdt, bool moofSizeZero = false)
+{
+	Bytes mfhd;
+	PutU32(mfhd, 0);
+	PutU32(mfhd, 1);
+	Bytes traf = Tfhd(1);
+	Append(traf, tfdt);
+	Bytes moofBody = Box("mfhd", mfhd);
+	Append(moofBody, Box("traf", traf));
+	Bytes out = Box("moof", moofBody, moofSizeZero);
+	if (!moofSizeZero)
+	{
+		Append(out, Box("mdat", Bytes(16, 0xaa)));
+	}
+	return out;
+}
+
+/**
+ * @brief Offsets of the baseMediaDecodeTime field of every tfdt, found by scanning for the tag
+ */
+std::vector<size_t> TfdtValueOffsets(const Bytes &segment)
+{
+	std::vector<size_t> offsets;
+	for (size_t i = 4; i + 4 <= segment.size(); i++)
+	{
+		if (memcmp(&segment[i], "tfdt", 4) == 0)
+		{
+			offsets.push_back(i + 8);
+		}
+	}
+	return offsets;
+}
+}
+
+class IsoBmffRewriteTests : public ::testing::Test
+{
+protected:
+	PlayerIsoBmffRewrite mParams;
+
+	/**
+	 * @brief Apply the restamp directly and through mp4_AdjustMediaDecodeTime and check they agree byte for byte
+	 */
+	Bytes Restamp(const Bytes &segment, int64_t delta, uint64_t &first, size_t &modified)
+	{
+		mParams.baseMediaDecodeTimeDelta = delta;
+		Bytes rewritten = segment;
+		modified = PlayerIsoBmffBuffer::rewriteFragment(rewritten.data(), rewritten.size(), mParams, &first);
+
+		Bytes adjusted = segment;
+		uint64_t adjustedFirst = mp4_AdjustMediaDecodeTime(adjusted.data(), adjusted.size(), delta);
+		EXPECT_EQ(adjusted, rewritten);
+		EXPECT_EQ(adjustedFirst, first);
+		return rewritten;
+	}
+};
+
+TEST_F(IsoBmffRewriteTests, RestampsEveryMoofOfMultiMoofSegment)
+{
+	Bytes segment = Box("styp", Bytes{'m', 's', 'd', 'h', 0, 0, 0, 0});
+	Append(segment, MoofAndMdat(Tfdt(0, 90000)));
+	Append(segment, MoofAndMdat(Tfdt(1, 93000)));
+	Append(segment, MoofAndMdat(Tfdt(0, 96000)));
+
+	uint64_t first = 0;
+	size_t modified = 0;
+	Bytes rewritten = Restamp(segment, 1000, first, modified);
+	EXPECT_EQ(modified, 3u);
+	EXPECT_EQ(first, 91000u);
+
+	std::vector<size_t> offsets = TfdtValueOffsets(rewritten);
+	ASSERT_EQ(offsets.size(), 3u);
+	EXPECT_EQ(GetU(rewritten, offsets[0], 4), 91000u);
+	EXPECT_EQ(GetU(rewritten, offsets[1], 8), 94000u);
+	EXPECT_EQ(GetU(rewritten, offsets[2], 4), 97000u);
+}
+
+TEST_F(IsoBmffRewriteTests, Version0WrapsAndVersion1Carries)
+{
+	Bytes segment = MoofAndMdat(Tfdt(0, 0xfffffff0u));
+	Append(segment, MoofAndMdat(Tfdt(1, 0xfffffff0u)));
+
+	uint64_t first = 0;
+	size_t modified = 0;
+	Bytes rewritten = Restamp(segment, 0x20, first, modified);
+	EXPECT_EQ(modified, 2u);
+	EXPECT_EQ(first, 0x10u);
+
+	std::vector<size_t> offsets = TfdtValueOffsets(rewritten);
+	ASSERT_EQ(offsets.size(), 2u);
+	EXPECT_EQ(GetU(rewritten, offsets[0], 4), 0x10u);
+	EXPECT_EQ(GetU(rewritten, offsets[1], 8), 0x100000010ull);
+
+	// negative deltas restamp backwards
+	rewritten = Restamp(rewritten, -0x20, first, modified);
+	EXPECT_EQ(GetU(rewritten, offsets[0], 4), 0xfffffff0u);
+	EXPECT_EQ(GetU(rewritten, offsets[1], 8), 0xfffffff0ull);
+}
+
+TEST_F(IsoBmffRewriteTests, ShortVersion1TfdtIsSkipped)
+{
+	// version 1 tfdt with only a 32 bit value: 8 bytes of payload instead of 12
+	Bytes body;
+	PutU32(body, 1u << 24);
+	PutU32(body, 90000);
+	Bytes segment = MoofAndMdat(Box("tfdt", body));
+	Append(segment, MoofAndMdat(Tfdt(0, 180000)));
+
+	uint64_t first = 0;
+	size_t modified = 0;
+	Bytes rewritten = Restamp(segment, 1000, first, modified);
+	std::vector<size_t> offsets = TfdtValueOffsets(rewritten);
+	ASSERT_EQ(offsets.size(), 2u);
+	EXPECT_EQ(GetU(rewritten, offsets[0] - 4, 8), (1ull << 56) | 90000u); // untouched
+	EXPECT_EQ(modified, 1u);
+	EXPECT_EQ(first, 181000u);
+	EXPECT_EQ(GetU(rewritten, offsets[1], 4), 181000u);
+}
+
+TEST_F(IsoBmffRewriteTests, TruncatedBoxStopsTheWalk)
+{
+	Bytes segment = MoofAndMdat(Tfdt(1, 90000));
+	Bytes second = MoofAndMdat(Tfdt(1, 180000));
+	Append(segment, second);
+	size_t full = segment.size();
+	// cut the second moof inside its tfdt value
+	std::vector<size_t> offsets = TfdtValueOffsets(segment);
+	ASSERT_EQ(offsets.size(), 2u);
+	segment.resize(offsets[1] + 4);
+	ASSERT_LT(segment.size(), full);
+
+	uint64_t first = 0;
+	size_t modified = 0;
+	Bytes rewritten = Restamp(segment, 1000, first, modified);
+	EXPECT_EQ(modified, 1u);
+	EXPECT_EQ(first, 91000u);
+	EXPECT_EQ(GetU(rewritten, offsets[0], 8), 91000u);
+	EXPECT_EQ(GetU(rewritten, offsets[1], 4), 0u); // high half of 180000, untouched
+}
+
+TEST_F(IsoBmffRewriteTests, SizeZeroBoxExtendsToEndOfBuffer)
+{
+	Bytes segment = MoofAndMdat(Tfdt(0, 90000));
+	Append(segment, MoofAndMdat(Tfdt(1, 180000), true));
+
+	uint64_t first = 0;
+	size_t modified = 0;
+	Bytes rewritten = Restamp(segment, 1000, first, modified);
+	EXPECT_EQ(modified, 2u);
+	std::vector<size_t> offsets = TfdtValueOffsets(rewritten);
+	ASSERT_EQ(offsets.size(), 2u);
+	EXPECT_EQ(GetU(rewritten, offsets[0], 4), 91000u);
+	EXPECT_EQ(GetU(rewritten, offsets[1], 8), 181000u);
+}
+
+TEST_F(IsoBmffRewriteTests, RemapsTrackIdsAndStripsEmsg)
+{
+	Bytes emsg;
+	PutU32(emsg, 0);
+	emsg.insert(emsg.end(), {'u', 'r', 'n', 0, 0});
+	Bytes segment = Box("emsg", emsg);
+	Append(segment, MoofAndMdat(Tfdt(0, 90000)));
+
+	mParams.newTrackId = 7;
+	mParams.stripEmsg = true;
+	size_t modified = PlayerIsoBmffBuffer::rewriteFragment(segment.data(), segment.size(), mParams);
+	EXPECT_EQ(modified, 2u);
+	EXPECT_EQ(memcmp(&segment[4], "free", 4), 0);
+	for (size_t i = 4; i + 4 <= segment.size(); i++)
+	{
+		if (memcmp(&segment[i], "tfhd", 4) == 0)
+		{
+			EXPECT_EQ(GetU(segment, i + 8, 4), 7u);
+		}
+	}
+	EXPECT_EQ(GetU(segment, TfdtValueOffsets(segment)[0], 4), 90000u);
+}
+
+TEST_F(IsoBmffRewriteTests, RescaledDeltaKeepsItsSign)
+{
+	Bytes segment = MoofAndMdat(Tfdt(1, 480000));
+	size_t offset = TfdtValueOffsets(segment)[0];
+
+	// one second at 1kHz is 48000 ticks at 48kHz, in either direction
+	EXPECT_EQ(mp4_AdjustMediaDecodeTime(segment.data(), segment.size(), 1000, 1000, 48000), 528000u);
+	EXPECT_EQ(GetU(segment, offset, 8), 528000u);
+	EXPECT_EQ(mp4_AdjustMediaDecodeTime(segment.data(), segment.size(), -1000, 1000, 48000), 480000u);
+	EXPECT_EQ(GetU(segment, offset, 8), 480000u);
+}
+
+TEST_F(IsoBmffRewriteTests, RescaledDeltaRoundsToNearestTick)
+{
+	Bytes segment = MoofAndMdat(Tfdt(1, 1000000));
+	size_t offset = TfdtValueOffsets(segment)[0];
+
+	// 1/90000s is 0.53 ticks at 48kHz; the magnitude rounds so both signs move by one tick
+	EXPECT_EQ(mp4_AdjustMediaDecodeTime(segment.data(), segment.size(), 1, 90000, 48000), 1000001u);
+	EXPECT_EQ(mp4_AdjustMediaDecodeTime(segment.data(), segment.size(), -1, 90000, 48000), 1000000u);
+	// 3 ticks at 90kHz is 1.6 ticks at 48kHz
+	EXPECT_EQ(mp4_AdjustMediaDecodeTime(segment.data(), segment.size(), -3, 90000, 48000), 999998u);
+	// same timescale is a plain add
+	EXPECT_EQ(mp4_AdjustMediaDecodeTime(segment.data(), segment.size(), 12345, 48000, 48000), 1012343u);
+	EXPECT_EQ(GetU(segment, offset, 8), 1012343u);
+}
+
+TEST_F(IsoBmffRewriteTests, RescaleWithoutTimescaleLeavesSegmentAlone)
+{
+	Bytes segment = MoofAndMdat(Tfdt(0, 90000));
+	Bytes original = segment;
+
+	EXPECT_EQ(mp4_AdjustMediaDecodeTime(segment.data(), segment.size(), 1000, 0, 48000), 0u);
+	EXPECT_EQ(mp4_AdjustMediaDecodeTime(segment.data(), segment.size(), 1000, 1000, 0), 0u);
+	EXPECT_EQ(segment, original);
+}
@@ -0,0 +1,929 @@
+/*
+* If not stated otherwise in this file or this component's license file the
+* following copyright and licenses apply:
+*
+* Copyright 2025 RDK Management
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <deque>
+#include <iostream>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "mp4demux.hpp"
+#include "MockGStreamer.h"
+
+using ::testing::_;
+using ::testing::An;
+using ::testing::Invoke;
+using ::testing::NiceMock;
+
+namespace
+{
+const uint32_t kTimescale = 90000;
+const uint32_t kDefaultDuration = 3000;
+const uint32_t kDefaultSize = 24;
+const uint32_t kBaseMediaDecodeTime = 900000;
+const uint8_t kConstantIv[16] = {0xa0, 0xa1, 0xa2, 0xa3, 0xa4, 0xa5, 0xa6, 0xa7, 0xa8, 0xa9, 0xaa, 0xab, 0xac, 0xad, 0xae, 0xaf};
+
+typedef std::vector<uint8_t> Bytes;
+
+void PutU32(Bytes &out, uint32_t value)
+{
+	for (int shift = 24; shift >= 0; shift -= 8)
+	{
+		out.push_back((uint8_t)(value >> shift));
+	}
+}
+
+Bytes Box(const char *type, const Bytes &body)
+{
+	Bytes out;
+	PutU32(out, (uint32_t)(8 + body.size()));
+	out.insert(out.end(), type, type + 4);
+	out.insert(out.end(), body.begin(), body.end());
+	return out;
+}
+
+void Append(Bytes &out, const Bytes &more)
+{
+	out.insert(out.end(), more.begin(), more.end());
+}
+
+/**
+ * @brief Expected per-sample values for a generated fragment
+ */
+struct ExpectedSample
+{
+	uint32_t duration;
+	uint32_t size;
+	int32_t cto;
+	uint64_t dts;
+};
+
+/**
+ * @brief Build styp+moof+mdat with one trun using the given optional per-sample fields
+ * @param trunFlags trun flags; 0x001 (data offset) is always added
+ */
+Bytes MakeFragment(uint32_t trunFlags, uint32_t sampleCount, std::vector<ExpectedSample> &expected, size_t &trunOffset, const Bytes &trafExtra = Bytes())
+{
+	trunFlags |= 0x001;
+	expected.clear();
+	uint64_t dts = kBaseMediaDecodeTime;
+	for (uint32_t i = 0; i < sampleCount; i++)
+	{
+		ExpectedSample sample;
+		sample.duration = (trunFlags & 0x100) ? (kDefaultDuration + (i % 5)) : kDefaultDuration;
+		sample.size = (trunFlags & 0x200) ? (8 + (i * 7) % 53) : kDefaultSize;
+		sample.cto = (trunFlags & 0x800) ? ((i % 3) ? 6000 : -3000) : 0;
+		sample.dts = dts;
+		dts += sample.duration;
+		expected.push_back(sample);
+	}
+
+	Bytes mfhd;
+	PutU32(mfhd, 0);
+	PutU32(mfhd, 1);
+
+	Bytes tfhd;
+	PutU32(tfhd, 0x000018); // default duration + default size present
+	PutU32(tfhd, 1);
+	PutU32(tfhd, kDefaultDuration);
+	PutU32(tfhd, kDefaultSize);
+
+	Bytes tfdt;
+	PutU32(tfdt, 0);
+	PutU32(tfdt, kBaseMediaDecodeTime);
+
+	Bytes trun;
+	PutU32(trun, trunFlags);
+	PutU32(trun, sampleCount);
+	size_t dataOffsetPos = trun.size();
+	PutU32(trun, 0); // patched below
+	if (trunFlags & 0x004)
+	{
+		PutU32(trun, 0x02000000);
+	}
+	for (const auto &sample : expected)
+	{
+		if (trunFlags & 0x100) PutU32(trun, sample.duration);
+		if (trunFlags & 0x200) PutU32(trun, sample.size);
+		if (trunFlags & 0x400) PutU32(trun, 0x01010000);
+		if (trunFlags & 0x800) PutU32(trun, (uint32_t)sample.cto);
+	}
+
+	Bytes traf;
+	Append(traf, Box("tfhd", tfhd));
+	Append(traf, Box("tfdt", tfdt));
+	size_t trunInTraf = traf.size();
+	Append(traf, Box("trun", trun));
+	Append(traf, trafExtra);
+
+	Bytes moofBody;
+	Append(moofBody, Box("mfhd", mfhd));
+	size_t trafInMoof = 8 + moofBody.size();
+	Append(moofBody, Box("traf", traf));
+	Bytes moof = Box("moof", moofBody);
+
+	size_t trunInMoof = trafInMoof + 8 + trunInTraf;
+	uint32_t dataOffset = (uint32_t)(moof.size() + 8);
+	size_t patch = trunInMoof + 8 + dataOffsetPos;
+	for (int i = 0; i < 4; i++)
+	{
+		moof[patch + i] = (uint8_t)(dataOffset >> (8 * (3 - i)));
+	}
+
+	Bytes mdat;
+	for (uint32_t i = 0; i < sampleCount; i++)
+	{
+		for (uint32_t k = 0; k < expected[i].size; k++)
+		{
+			mdat.push_back((uint8_t)(i * 31 + k));
+		}
+	}
+
+	Bytes fragment = Box("styp", Bytes{'m', 's', 'd', 'h', 0, 0, 0, 0});
+	trunOffset = fragment.size() + trunInMoof;
+	Append(fragment, moof);
+	Append(fragment, Box("mdat", mdat));
+	return fragment;
+}
+
+/**
+ * @brief Init header for a protected avc1 track with the given per-sample IV size
+ * @param cbcs cbcs scheme with a 1:9 pattern, and kConstantIv when ivSize is 0; cenc otherwise
+ */
+Bytes MakeEncryptedInit(uint8_t ivSize, const uint8_t kid[16], bool withPlayReady = false, bool cbcs = false)
+{
+	Bytes mdhd;
+	PutU32(mdhd, 0);
+	PutU32(mdhd, 0);
+	PutU32(mdhd, 0);
+	PutU32(mdhd, kTimescale);
+	PutU32(mdhd, 0);
+	PutU32(mdhd, 0x55c40000); // language, pre_defined
+
+	Bytes tenc;
+	PutU32(tenc, cbcs ? 0x01000000 : 0); // version 1 carries the pattern
+	tenc.push_back(0);
+	tenc.push_back(cbcs ? 0x19 : 0); // crypt 1, skip 9
+	tenc.push_back(1); // default_isProtected
+	tenc.push_back(ivSize);
+	tenc.insert(tenc.end(), kid, kid + 16);
+	if (cbcs && ivSize == 0)
+	{
+		tenc.push_back(sizeof(kConstantIv));
+		tenc.insert(tenc.end(), kConstantIv, kConstantIv + sizeof(kConstantIv));
+	}
+
+	Bytes schm;
+	PutU32(schm, 0);
+	if (cbcs)
+	{
+		schm.insert(schm.end(), {'c', 'b', 'c', 's'});
+	}
+	else
+	{
+		schm.insert(schm.end(), {'c', 'e', 'n', 'c'});
+	}
+	PutU32(schm, 0x00010000);
+
+	Bytes sinf;
+	Append(sinf, Box("frma", Bytes{'a', 'v', 'c', '1'}));
+	Append(sinf, Box("schm", schm));
+	Append(sinf, Box("schi", Box("tenc", tenc)));
+
+	Bytes encv(78, 0);
+	encv[7] = 1; // data_reference_index
+	encv[24] = 0x05; // width 1280
+	encv[25] = 0x00;
+	encv[26] = 0x02; // height 720
+	encv[27] = 0xd0;
+	encv[74] = 0x00;
+	encv[75] = 0x18; // depth
+	encv[76] = 0xff; // pre_defined
+	encv[77] = 0xff;
+	Append(encv, Box("avcC", Bytes{1, 0x64, 0, 0x1f, 0xff, 0xe0, 0}));
+	Append(encv, Box("sinf", sinf));
+
+	Bytes stsd;
+	PutU32(stsd, 0);
+	PutU32(stsd, 1);
+	Append(stsd, Box("encv", encv));
+
+	Bytes pssh;
+	PutU32(pssh, 0);
+	const uint8_t widevine[16] = {0xed, 0xef, 0x8b, 0xa9, 0x79, 0xd6, 0x4a, 0xce, 0xa3, 0xc8, 0x27, 0xdc, 0xd5, 0x1d, 0x21, 0xed};
+	pssh.insert(pssh.end(), widevine, widevine + 16);
+	PutU32(pssh, 0);
+
+	Bytes minf = Box("stbl", Box("stsd", stsd));
+	Bytes mdia = Box("mdhd", mdhd);
+	Append(mdia, Box("minf", minf));
+	Bytes moov = Box("trak", Box("mdia", mdia));
+	Append(moov, Box("pssh", pssh));
+	if (withPlayReady)
+	{
+		Bytes playreadyPssh;
+		PutU32(playreadyPssh, 0);
+		const uint8_t playready[16] = {0x9a, 0x04, 0xf0, 0x79, 0x98, 0x40, 0x42, 0x86, 0xab, 0x92, 0xe6, 0x5b, 0xe0, 0x88, 0x5f, 0x95};
+		playreadyPssh.insert(playreadyPssh.end(), playready, playready + 16);
+		PutU32(playreadyPssh, 0);
+		Append(moov, Box("pssh", playreadyPssh));
+	}
+	return Box("moov", moov);
+}
+
+/**
+ * @brief Byte-at-a-time trun decoder equivalent to the parser this suite replaced, used as reference and benchmark baseline
+ */
+class LegacyTrunDecoder
+{
+	const uint8_t *ptr;
+
+	uint64_t ReadBytes(int n)
+	{
+		uint64_t rc = 0;
+		for (int i = 0; i < n; i++)
+		{
+			rc <<= 8;
+			rc |= *ptr++;
+		}
+		return rc;
+	}
+
+public:
+	struct Sample
+	{
+		const uint8_t *ptr;
+		size_t len;
+		double pts;
+		double dts;
+		double duration;
+	};
+	std::vector<Sample> samples;
+
+	void Decode(const uint8_t *trunBox, const uint8_t *moof)
+	{
+		samples.clear();
+		ptr = trunBox + 8;
+		ptr++; // version
+		uint32_t flags = (uint32_t)ReadBytes(3);
+		uint32_t sampleCount = (uint32_t)ReadBytes(4);
+		const uint8_t *dataPtr = moof + (int32_t)ReadBytes(4);
+		if (flags & 0x0004)
+		{
+			(void)ReadBytes(4);
+		}
+		uint64_t dts = kBaseMediaDecodeTime;
+		for (uint32_t i = 0; i < sampleCount; i++)
+		{
+			Sample sample;
+			sample.ptr = dataPtr;
+			sample.len = kDefaultSize;
+			uint32_t sampleDuration = kDefaultDuration;
+			if (flags & 0x0100)
+			{
+				sampleDuration = (uint32_t)ReadBytes(4);
+			}
+			sample.duration = sampleDuration / (double)kTimescale;
+			if (flags & 0x0200)
+			{
+				sample.len = (uint32_t)ReadBytes(4);
+			}
+			dataPtr += sample.len;
+			if (flags & 0x0400)
+			{
+				(void)ReadBytes(4);
+			}
+			int32_t cto = 0;
+			if (flags & 0x0800)
+			{
+				cto = (int32_t)ReadBytes(4);
+			}
+			sample.dts = dts / (double)kTimescale;
+			sample.pts = (dts + cto) / (double)kTimescale;
+			dts += sampleDuration;
+			samples.push_back(sample);
+		}
+	}
+};
+}
+
+class Mp4DemuxTests : public ::testing::Test
+{
+protected:
+	std::vector<ExpectedSample> expected;
+	size_t trunOffset = 0;
+};
+
+/**
+ * @brief Records the buffers, structures, protection metas and caps Mp4Demux creates through the GStreamer fakes
+ */
+class Mp4DemuxGstTests : public Mp4DemuxTests
+{
+protected:
+	struct Structure
+	{
+		std::string name;
+		std::map<std::string, guint> uints;
+		std::map<std::string, std::string> strings;
+		std::map<std::string, Bytes> buffers;
+	};
+	std::deque<Structure> structures;
+	std::deque<GstBuffer> buffers;
+	std::map<GstBuffer *, Bytes> contents;
+	std::map<GstBuffer *, Structure *> metas;
+	GstCaps caps{};
+	Structure *capsStructure = nullptr;
+
+	static Structure *AsStructure(const GstStructure *structure)
+	{
+		return reinterpret_cast<Structure *>(const_cast<GstStructure *>(structure));
+	}
+
+	GstBuffer *NewBuffer(const Bytes &bytes)
+	{
+		buffers.emplace_back();
+		GstBuffer *buffer = &buffers.back();
+		contents[buffer] = bytes;
+		return buffer;
+	}
+
+	GstStructure *NewStructure(const gchar *name)
+	{
+		structures.emplace_back();
+		structures.back().name = name;
+		return reinterpret_cast<GstStructure *>(&structures.back());
+	}
+
+	void SetUp() override
+	{
+		NiceMock<MockGStreamer> *mock = new NiceMock<MockGStreamer>();
+		g_mockGStreamer = mock;
+		ON_CALL(*mock, gst_buffer_new_allocate(_, _, _))
+			.WillByDefault(Invoke([this](GstAllocator *, gsize size, GstAllocationParams *) { return NewBuffer(Bytes(size)); }));
+		ON_CALL(*mock, gst_buffer_fill(_, _, _, _))
+			.WillByDefault(Invoke([this](GstBuffer *buffer, gsize offset, gconstpointer src, gsize size) {
+				memcpy(contents[buffer].data() + offset, src, size);
+				return size;
+			}));
+		ON_CALL(*mock, gst_buffer_get_size(_))
+			.WillByDefault(Invoke([this](GstBuffer *buffer) { return (gsize)contents[buffer].size(); }));
+		ON_CALL(*mock, gst_buffer_copy_region(_, _, _, _))
+			.WillByDefault(Invoke([this](GstBuffer *parent, GstBufferCopyFlags, gsize offset, gsize size) {
+				const Bytes &parentBytes = contents[parent];
+				return NewBuffer(Bytes(parentBytes.begin() + offset, parentBytes.begin() + offset + size));
+			}));
+		ON_CALL(*mock, gst_buffer_add_protection_meta(_, _))
+			.WillByDefault(Invoke([this](GstBuffer *buffer, GstStructure *info) {
+				metas[buffer] = AsStructure(info);
+				return (GstProtectionMeta *)nullptr;
+			}));
+		ON_CALL(*mock, gst_structure_new(_))
+			.WillByDefault(Invoke([this](const gchar *name) { return NewStructure(name); }));
+		ON_CALL(*mock, gst_structure_set(_, _, An<guint>()))
+			.WillByDefault(Invoke([](GstStructure *structure, const gchar *fieldname, guint value) { AsStructure(structure)->uints[fieldname] = value; }));
+		ON_CALL(*mock, gst_structure_set(_, _, An<const gchar *>()))
+			.WillByDefault(Invoke([](GstStructure *structure, const gchar *fieldname, const gchar *value) { AsStructure(structure)->strings[fieldname] = value; }));
+		ON_CALL(*mock, gst_structure_set(_, _, An<gpointer>()))
+			.WillByDefault(Invoke([this](GstStructure *structure, const gchar *fieldname, gpointer value) {
+				AsStructure(structure)->buffers[fieldname] = contents[(GstBuffer *)value];
+			}));
+		ON_CALL(*mock, gst_structure_get_name(_))
+			.WillByDefault(Invoke([](const GstStructure *structure) { return AsStructure(structure)->name.c_str(); }));
+		ON_CALL(*mock, gst_structure_set_name(_, _))
+			.WillByDefault(Invoke([](GstStructure *structure, const gchar *name) { AsStructure(structure)->name = name; }));
+		ON_CALL(*mock, gst_caps_new_simple(_, _, _, _, _))
+			.WillByDefault(Invoke([this](const char *mediaType, const char *, GType, const int, void *) {
+				capsStructure = AsStructure(NewStructure(mediaType));
+				return &caps;
+			}));
+		ON_CALL(*mock, gst_caps_get_structure(&caps, 0))
+			.WillByDefault(Invoke([this](const GstCaps *, guint) { return reinterpret_cast<GstStructure *>(capsStructure); }));
+	}
+
+	void TearDown() override
+	{
+		delete g_mockGStreamer;
+		g_mockGStreamer = nullptr;
+	}
+
+	/**
+	 * @brief Expected GstProtectionMeta subsamples field: 16 bit clear and 32 bit protected byte counts, big endian
+	 */
+	static Bytes SubsampleMap(const std::vector<std::pair<uint16_t, uint32_t>> &subsamples)
+	{
+		Bytes map;
+		for (const auto &subsample : subsamples)
+		{
+			map.push_back((uint8_t)(subsample.first >> 8));
+			map.push_back((uint8_t)subsample.first);
+			PutU32(map, subsample.second);
+		}
+		return map;
+	}
+};
+
+TEST_F(Mp4DemuxTests, ParsesEveryTrunFieldCombination)
+{
+	for (uint32_t combo = 0; combo < 16; combo++)
+	{
+		for (uint32_t firstSampleFlags : {0u, 0x004u})
+		{
+			uint32_t trunFlags = (combo << 8) | firstSampleFlags;
+			Bytes fragment = MakeFragment(trunFlags, 40, expected, trunOffset);
+			Mp4Demux demux(kTimescale);
+			demux.Parse(fragment.data(), fragment.size());
+			ASSERT_EQ(demux.count(), 40) << "trun flags 0x" << std::hex << trunFlags;
+
+			size_t dataOffset = fragment.size();
+			for (const auto &sample : expected)
+			{
+				dataOffset -= sample.size;
+			}
+			for (int i = 0; i < demux.count(); i++)
+			{
+				const ExpectedSample &want = expected[i];
+				EXPECT_EQ(demux.getLen(i), want.size);
+				EXPECT_EQ(demux.getPtr(i), fragment.data() + dataOffset);
+				EXPECT_DOUBLE_EQ(demux.getDts(i), want.dts / (double)kTimescale);
+				EXPECT_DOUBLE_EQ(demux.getPts(i), (want.dts + want.cto) / (double)kTimescale);
+				EXPECT_DOUBLE_EQ(demux.getDuration(i), want.duration / (double)kTimescale);
+				dataOffset += want.size;
+			}
+		}
+	}
+}
+
+TEST_F(Mp4DemuxTests, TickTimestampsAreExactAfterLongUptime)
+{
+	Bytes fragment = MakeFragment(0x900, 30, expected, trunOffset);
+	// move tfdt to ~30h of 90kHz ticks; a 32 bit tfdt still fits
+	const uint64_t base = 4000000000ULL;
+	size_t tfdtValue = trunOffset - 4;
+	for (int i = 0; i < 4; i++)
+	{
+		fragment[tfdtValue + i] = (uint8_t)(base >> (8 * (3 - i)));
+	}
+	Mp4Demux demux(kTimescale);
+	demux.Parse(fragment.data(), fragment.size());
+	ASSERT_EQ(demux.count(), 30);
+	uint64_t dts = base;
+	for (int i = 0; i < demux.count(); i++)
+	{
+		EXPECT_EQ(demux.getDtsTicks(i), dts);
+		EXPECT_EQ(demux.getPtsTicks(i), (int64_t)dts + expected[i].cto);
+		EXPECT_EQ(demux.getDurationTicks(i), expected[i].duration);
+		dts += expected[i].duration;
+	}
+}
+
+TEST_F(Mp4DemuxTests, SampleEncryptionFromSenc)
+{
+	const uint8_t kid[16] = {1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16};
+	const uint32_t count = 12;
+	Bytes senc;
+	PutU32(senc, 0x000002); // subsample map present
+	PutU32(senc, count);
+	for (uint32_t i = 0; i < count; i++)
+	{
+		for (int k = 0; k < 8; k++)
+		{
+			senc.push_back((uint8_t)(i * 16 + k));
+		}
+		senc.push_back(0);
+		senc.push_back(2);
+		senc.push_back(0);
+		senc.push_back((uint8_t)(4 + i));
+		PutU32(senc, 100 + i);
+		senc.push_back(0);
+		senc.push_back(1);
+		PutU32(senc, 7);
+	}
+	Bytes init = MakeEncryptedInit(8, kid);
+	Bytes fragment = MakeFragment(0x300, count, expected, trunOffset, Box("senc", senc));
+
+	Mp4Demux demux;
+	demux.Parse(init.data(), init.size());
+	EXPECT_TRUE(demux.isEncrypted());
+	EXPECT_EQ(demux.timescale, kTimescale);
+	demux.Parse(fragment.data(), fragment.size());
+	ASSERT_EQ(demux.count(), (int)count);
+	for (uint32_t i = 0; i < count; i++)
+	{
+		const Mp4SampleEncryption *encryption = demux.getEncryption(i);
+		ASSERT_NE(encryption, nullptr);
+		ASSERT_EQ(encryption->iv_size, 8);
+		EXPECT_EQ(encryption->iv[0], i * 16);
+		EXPECT_EQ(encryption->iv[7], i * 16 + 7);
+		ASSERT_EQ(encryption->subsamples.size(), 2u);
+		EXPECT_EQ(encryption->subsamples[0].first, 4 + i);
+		EXPECT_EQ(encryption->subsamples[0].second, 100 + i);
+		EXPECT_EQ(encryption->subsamples[1].first, 1);
+		EXPECT_EQ(encryption->subsamples[1].second, 7u);
+	}
+}
+
+TEST_F(Mp4DemuxTests, SampleEncryptionFromSaizSaio)
+{
+	const uint8_t kid[16] = {0};
+	const uint32_t count = 5;
+	// moof(8) + mfhd(16) + traf(8) + tfhd(24) + tfdt(16) + trun + saiz(17) + saio(20) + free header(8)
+	const uint32_t trunSize = 8 + 12 + 4 * count;
+	const uint32_t auxOffset = 8 + 16 + 8 + 24 + 16 + trunSize + 17 + 20 + 8;
+	Bytes saiz;
+	PutU32(saiz, 0);
+	saiz.push_back(16);
+	PutU32(saiz, count);
+	Bytes saio;
+	PutU32(saio, 0);
+	PutU32(saio, 1);
+	PutU32(saio, auxOffset);
+	Bytes aux;
+	for (uint32_t i = 0; i < count * 16; i++)
+	{
+		aux.push_back((uint8_t)i);
+	}
+	Bytes extra = Box("saiz", saiz);
+	Append(extra, Box("saio", saio));
+	Append(extra, Box("free", aux));
+
+	Bytes init = MakeEncryptedInit(16, kid);
+	Bytes fragment = MakeFragment(0x200, count, expected, trunOffset, extra);
+	Mp4Demux demux;
+	demux.Parse(init.data(), init.size());
+	demux.Parse(fragment.data(), fragment.size());
+	ASSERT_EQ(demux.count(), (int)count);
+	for (uint32_t i = 0; i < count; i++)
+	{
+		const Mp4SampleEncryption *encryption = demux.getEncryption(i);
+		ASSERT_NE(encryption, nullptr);
+		EXPECT_EQ(encryption->iv_size, 16);
+		EXPECT_EQ(encryption->iv[0], i * 16);
+		EXPECT_EQ(encryption->iv[15], i * 16 + 15);
+		EXPECT_TRUE(encryption->subsamples.empty());
+	}
+}
+
+TEST_F(Mp4DemuxTests, ProtectionSystemFollowsPreferredDrm)
+{
+	const uint8_t kid[16] = {0};
+	const std::string widevine = "edef8ba9-79d6-4ace-a3c8-27dcd51d21ed";
+	const std::string playready = "9a04f079-9840-4286-ab92-e65be0885f95";
+	Bytes init = MakeEncryptedInit(8, kid, true);
+	Mp4Demux demux;
+	demux.Parse(init.data(), init.size());
+	ASSERT_TRUE(demux.isEncrypted());
+
+	// no preference: first pssh
+	EXPECT_EQ(demux.getProtectionSystem(), widevine);
+	demux.setPreferredProtectionSystem("urn:uuid:9A04F079-9840-4286-AB92-E65BE0885F95");
+	EXPECT_EQ(demux.getProtectionSystem(), playready);
+	demux.setPreferredProtectionSystem(widevine.c_str());
+	EXPECT_EQ(demux.getProtectionSystem(), widevine);
+	// no matching pssh: first one
+	demux.setPreferredProtectionSystem("e2719d58-a985-b3c9-781a-b030af78d30e");
+	EXPECT_EQ(demux.getProtectionSystem(), widevine);
+
+	// a new init header replaces the pssh list, the preference stays
+	demux.setPreferredProtectionSystem(playready.c_str());
+	Bytes widevineOnly = MakeEncryptedInit(8, kid);
+	demux.Parse(widevineOnly.data(), widevineOnly.size());
+	EXPECT_EQ(demux.getProtectionSystem(), widevine);
+}
+
+TEST_F(Mp4DemuxTests, ClearSamplesCarryNoEncryption)
+{
+	Bytes fragment = MakeFragment(0x300, 4, expected, trunOffset);
+	Mp4Demux demux(kTimescale);
+	demux.Parse(fragment.data(), fragment.size());
+	ASSERT_EQ(demux.count(), 4);
+	EXPECT_FALSE(demux.isEncrypted());
+	for (int i = 0; i < demux.count(); i++)
+	{
+		EXPECT_EQ(demux.getEncryption(i), nullptr);
+	}
+}
+
+TEST_F(Mp4DemuxGstTests, CencSamplesCarryProtectionMeta)
+{
+	const uint8_t kid[16] = {1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16};
+	const uint32_t count = 6;
+	Bytes senc;
+	PutU32(senc, 0x000002); // subsample map present
+	PutU32(senc, count);
+	for (uint32_t i = 0; i < count; i++)
+	{
+		for (int k = 0; k < 8; k++)
+		{
+			senc.push_back((uint8_t)(i * 16 + k));
+		}
+		senc.push_back(0);
+		senc.push_back(2);
+		senc.push_back(0x01);
+		senc.push_back((uint8_t)(4 + i)); // clear bytes above 255 check the 16 bit layout
+		PutU32(senc, 0x10000 + i);
+		senc.push_back(0);
+		senc.push_back(1);
+		PutU32(senc, 7);
+	}
+	Bytes init = MakeEncryptedInit(8, kid);
+	Bytes fragment = MakeFragment(0x300, count, expected, trunOffset, Box("senc", senc));
+	Mp4Demux demux;
+	demux.Parse(init.data(), init.size());
+	demux.Parse(fragment.data(), fragment.size());
+	ASSERT_EQ(demux.count(), (int)count);
+
+	GstBuffer *fragmentBuffer = NewBuffer(fragment);
+	for (uint32_t i = 0; i < count; i++)
+	{
+		GstBuffer *sample = demux.getBuffer(fragmentBuffer, i);
+		ASSERT_NE(sample, nullptr);
+		EXPECT_EQ(contents[sample], Bytes(demux.getPtr(i), demux.getPtr(i) + demux.getLen(i)));
+		ASSERT_EQ(metas.count(sample), 1u);
+		const Structure *meta = metas[sample];
+		EXPECT_EQ(meta->name, "application/x-cenc");
+		EXPECT_EQ(meta->uints.at("encrypted"), (guint)TRUE);
+		EXPECT_EQ(meta->buffers.at("kid"), Bytes(kid, kid + 16));
+		EXPECT_EQ(meta->uints.at("iv_size"), 8u);
+		Bytes iv;
+		for (int k = 0; k < 8; k++)
+		{
+			iv.push_back((uint8_t)(i * 16 + k));
+		}
+		EXPECT_EQ(meta->buffers.at("iv"), iv);
+		EXPECT_EQ(meta->uints.at("subsample_count"), 2u);
+		EXPECT_EQ(meta->buffers.at("subsamples"), SubsampleMap({{(uint16_t)(0x104 + i), 0x10000 + i}, {1, 7}}));
+		// cenc has no pattern and no constant IV
+		EXPECT_EQ(meta->uints.count("crypt_byte_block"), 0u);
+		EXPECT_EQ(meta->uints.count("skip_byte_block"), 0u);
+		EXPECT_EQ(meta->uints.count("constant_iv_size"), 0u);
+		EXPECT_EQ(meta->strings.count("cipher-mode"), 0u);
+	}
+}
+
+TEST_F(Mp4DemuxGstTests, CbcsSamplesCarryPatternAndConstantIv)
+{
+	const uint8_t kid[16] = {0xf0, 0xf1, 0xf2, 0xf3, 0xf4, 0xf5, 0xf6, 0xf7, 0xf8, 0xf9, 0xfa, 0xfb, 0xfc, 0xfd, 0xfe, 0xff};
+	const uint32_t count = 4;
+	Bytes senc;
+	PutU32(senc, 0x000002); // subsample map present, no per-sample IV
+	PutU32(senc, count);
+	for (uint32_t i = 0; i < count; i++)
+	{
+		senc.push_back(0);
+		senc.push_back(1);
+		senc.push_back(0);
+		senc.push_back((uint8_t)(32 + i));
+		PutU32(senc, 160 * (i + 1));
+	}
+	Bytes init = MakeEncryptedInit(0, kid, false, true);
+	Bytes fragment = MakeFragment(0x300, count, expected, trunOffset, Box("senc", senc));
+	Mp4Demux demux;
+	demux.Parse(init.data(), init.size());
+	demux.Parse(fragment.data(), fragment.size());
+	ASSERT_EQ(demux.count(), (int)count);
+
+	GstBuffer *fragmentBuffer = NewBuffer(fragment);
+	for (uint32_t i = 0; i < count; i++)
+	{
+		GstBuffer *sample = demux.getBuffer(fragmentBuffer, i);
+		ASSERT_NE(sample, nullptr);
+		ASSERT_EQ(metas.count(sample), 1u);
+		const Structure *meta = metas[sample];
+		EXPECT_EQ(meta->name, "application/x-cbcs");
+		EXPECT_EQ(meta->buffers.at("kid"), Bytes(kid, kid + 16));
+		EXPECT_EQ(meta->uints.at("iv_size"), (guint)sizeof(kConstantIv));
+		EXPECT_EQ(meta->uints.at("constant_iv_size"), (guint)sizeof(kConstantIv));
+		EXPECT_EQ(meta->buffers.at("iv"), Bytes(kConstantIv, kConstantIv + sizeof(kConstantIv)));
+		EXPECT_EQ(meta->strings.at("cipher-mode"), "cbcs");
+		EXPECT_EQ(meta->uints.at("crypt_byte_block"), 1u);
+		EXPECT_EQ(meta->uints.at("skip_byte_block"), 9u);
+		EXPECT_EQ(meta->uints.at("subsample_count"), 1u);
+		EXPECT_EQ(meta->buffers.at("subsamples"), SubsampleMap({{(uint16_t)(32 + i), 160 * (i + 1)}}));
+	}
+}
+
+TEST_F(Mp4DemuxGstTests, ClearSamplesCarryNoProtectionMeta)
+{
+	Bytes fragment = MakeFragment(0x300, 4, expected, trunOffset);
+	Mp4Demux demux(kTimescale);
+	demux.Parse(fragment.data(), fragment.size());
+	ASSERT_EQ(demux.count(), 4);
+	GstBuffer *fragmentBuffer = NewBuffer(fragment);
+	for (int i = 0; i < demux.count(); i++)
+	{
+		GstBuffer *sample = demux.getBuffer(fragmentBuffer, i);
+		ASSERT_NE(sample, nullptr);
+		EXPECT_EQ(metas.count(sample), 0u);
+	}
+}
+
+TEST_F(Mp4DemuxGstTests, ProtectedCapsAdvertiseSchemeAndPreferredSystem)
+{
+	const uint8_t kid[16] = {0};
+	Bytes init = MakeEncryptedInit(8, kid, true);
+	Mp4Demux demux;
+	demux.Parse(init.data(), init.size());
+
+	// several pssh boxes and no preference: the first one
+	ASSERT_TRUE(demux.setCaps(nullptr));
+	ASSERT_NE(capsStructure, nullptr);
+	EXPECT_EQ(capsStructure->name, "application/x-cenc");
+	EXPECT_EQ(capsStructure->strings.at("original-media-type"), "video/x-h264");
+	EXPECT_EQ(capsStructure->strings.at("protection-system"), "edef8ba9-79d6-4ace-a3c8-27dcd51d21ed");
+
+	// the preferred system is chosen among the pssh boxes of the init header
+	demux.setPreferredProtectionSystem("urn:uuid:9a04f079-9840-4286-ab92-e65be0885f95");
+	ASSERT_TRUE(demux.setCaps(nullptr));
+	EXPECT_EQ(capsStructure->name, "application/x-cenc");
+	EXPECT_EQ(capsStructure->strings.at("protection-system"), "9a04f079-9840-4286-ab92-e65be0885f95");
+
+	Bytes cbcsInit = MakeEncryptedInit(0, kid, true, true);
+	demux.Parse(cbcsInit.data(), cbcsInit.size());
+	ASSERT_TRUE(demux.setCaps(nullptr));
+	EXPECT_EQ(capsStructure->name, "application/x-cbcs");
+	EXPECT_EQ(capsStructure->strings.at("original-media-type"), "video/x-h264");
+	EXPECT_EQ(capsStructure->strings.at("protection-system"), "9a04f079-9840-4286-ab92-e65be0885f95");
+}
+
+TEST_F(Mp4DemuxGstTests, ClearCapsKeepMediaType)
+{
+	const uint8_t kid[16] = {0};
+	Bytes init = MakeEncryptedInit(8, kid);
+	// flip tenc default_isProtected off: same sample entry, clear track
+	Bytes tencType = {'t', 'e', 'n', 'c'};
+	auto tenc = std::search(init.begin(), init.end(), tencType.begin(), tencType.end());
+	ASSERT_NE(tenc, init.end());
+	tenc[4 + 4 + 2] = 0;
+	Mp4Demux demux;
+	demux.Parse(init.data(), init.size());
+	ASSERT_FALSE(demux.isEncrypted());
+	ASSERT_TRUE(demux.setCaps(nullptr));
+	EXPECT_EQ(capsStructure->name, "video/x-h264");
+	EXPECT_EQ(capsStructure->strings.count("original-media-type"), 0u);
+	EXPECT_EQ(capsStructure->strings.count("protection-system"), 0u);
+}
+
+TEST_F(Mp4DemuxTests, TruncatedFragmentNeverReadsPastEnd)
+{
+	Bytes fragment = MakeFragment(0xb00, 64, expected, trunOffset);
+	for (size_t len = 0; len < fragment.size(); len++)
+	{
+		// copy into an exactly sized heap block so out of bounds reads are caught by sanitizers
+		std::vector<uint8_t> clipped(fragment.begin(), fragment.begin() + len);
+		Mp4Demux demux(kTimescale);
+		demux.Parse(clipped.data(), clipped.size());
+		EXPECT_LE(demux.count(), 64);
+	}
+}
+
+TEST_F(Mp4DemuxTests, ChunkedParseMatchesWholeFragment)
+{
+	Bytes fragment = MakeFragment(0xf04, 50, expected, trunOffset);
+	Mp4Demux whole(kTimescale);
+	whole.Parse(fragment.data(), fragment.size());
+	ASSERT_EQ(whole.count(), 50);
+
+	for (size_t step = 1; step <= fragment.size(); step = step * 2 + 1)
+	{
+		Mp4Demux chunked(kTimescale);
+		std::vector<std::string> payloads;
+		std::vector<double> pts;
+		for (size_t offset = 0; offset < fragment.size(); offset += step)
+		{
+			size_t len = std::min(step, fragment.size() - offset);
+			int count = chunked.ParseChunk(fragment.data() + offset, len);
+			for (int i = 0; i < count; i++)
+			{
+				payloads.emplace_back((const char *)chunked.getPtr(i), chunked.getLen(i));
+				pts.push_back(chunked.getPts(i));
+			}
+		}
+		ASSERT_EQ(payloads.size(), 50u) << "step " << step;
+		for (int i = 0; i < 50; i++)
+		{
+			EXPECT_EQ(payloads[i], std::string((const char *)whole.getPtr(i), whole.getLen(i)));
+			EXPECT_DOUBLE_EQ(pts[i], whole.getPts(i));
+		}
+	}
+}
+
+TEST_F(Mp4DemuxTests, ChunkedParseRestartsAfterTruncatedSegment)
+{
+	Bytes fragment = MakeFragment(0x300, 20, expected, trunOffset);
+	Mp4Demux whole(kTimescale);
+	whole.Parse(fragment.data(), fragment.size());
+	ASSERT_EQ(whole.count(), 20);
+
+	// first segment is cut off half way into its mdat, e.g. by an aborted download
+	Mp4Demux chunked(kTimescale);
+	size_t cut = fragment.size() - (fragment.size() - trunOffset) / 2;
+	int partial = chunked.ParseChunk(fragment.data(), cut);
+	EXPECT_LT(partial, 20);
+
+	// the next segment has to be parsed from its first box, not as the rest of the old mdat
+	chunked.ResetChunkParser();
+	std::vector<std::string> payloads;
+	const size_t step = 37;
+	for (size_t offset = 0; offset < fragment.size(); offset += step)
+	{
+		size_t len = std::min(step, fragment.size() - offset);
+		int count = chunked.ParseChunk(fragment.data() + offset, len);
+		for (int i = 0; i < count; i++)
+		{
+			payloads.emplace_back((const char *)chunked.getPtr(i), chunked.getLen(i));
+			EXPECT_DOUBLE_EQ(chunked.getPts(i), whole.getPts((int)payloads.size() - 1));
+		}
+	}
+	ASSERT_EQ(payloads.size(), 20u);
+	for (int i = 0; i < 20; i++)
+	{
+		EXPECT_EQ(payloads[i], std::string((const char *)whole.getPtr(i), whole.getLen(i)));
+	}
+}
+
+TEST_F(Mp4DemuxTests, TrunDecoderMatchesLegacyDecoder)
+{
+	for (uint32_t combo = 0; combo < 16; combo++)
+	{
+		for (uint32_t firstSampleFlags : {0u, 0x004u})
+		{
+			uint32_t trunFlags = (combo << 8) | firstSampleFlags;
+			Bytes fragment = MakeFragment(trunFlags, 1000, expected, trunOffset);
+			const uint8_t *moof = fragment.data() + 16; // after styp
+
+			LegacyTrunDecoder legacy;
+			legacy.Decode(fragment.data() + trunOffset, moof);
+			Mp4Demux demux(kTimescale);
+			demux.Parse(fragment.data(), fragment.size());
+
+			ASSERT_EQ(demux.count(), (int)legacy.samples.size()) << "trun flags 0x" << std::hex << trunFlags;
+			for (int i = 0; i < demux.count(); i++)
+			{
+				EXPECT_EQ(demux.getPtr(i), legacy.samples[i].ptr);
+				EXPECT_EQ(demux.getLen(i), legacy.samples[i].len);
+				EXPECT_DOUBLE_EQ(demux.getPts(i), legacy.samples[i].pts);
+				EXPECT_DOUBLE_EQ(demux.getDts(i), legacy.samples[i].dts);
+				EXPECT_DOUBLE_EQ(demux.getDuration(i), legacy.samples[i].duration);
+			}
+		}
+	}
+}
+
+TEST_F(Mp4DemuxTests, LargeTrunBenchmark)
+{
+	const int iterations = 2000;
+	Bytes fragment = MakeFragment(0xb00, 1000, expected, trunOffset);
+	const uint8_t *moof = fragment.data() + 16; // after styp
+	const uint8_t *trun = fragment.data() + trunOffset;
+
+	// both decoders work on the same trun box only, against the same traf defaults
+	LegacyTrunDecoder legacy;
+	auto start = std::chrono::steady_clock::now();
+	for (int i = 0; i < iterations; i++)
+	{
+		legacy.Decode(trun, moof);
+	}
+	auto legacyTime = std::chrono::steady_clock::now() - start;
+
+	Mp4Demux demux(kTimescale);
+	demux.Parse(fragment.data(), fragment.size());
+	start = std::chrono::steady_clock::now();
+	for (int i = 0; i < iterations; i++)
+	{
+		demux.ParseTrackFragmentRun(trun, moof);
+	}
+	auto demuxTime = std::chrono::steady_clock::now() - start;
+
+	ASSERT_EQ(demux.count(), (int)legacy.samples.size());
+	for (int i = 0; i < demux.count(); i++)
+	{
+		EXPECT_EQ(demux.getPtr(i), legacy.samples[i].ptr);
+		EXPECT_EQ(demux.getLen(i), legacy.samples[i].len);
+		EXPECT_DOUBLE_EQ(demux.getPts(i), legacy.samples[i].pts);
+		EXPECT_DOUBLE_EQ(demux.getDts(i), legacy.samples[i].dts);
+	}
+	std::cout << "1000 sample trun x" << iterations << ": byte reader "
+		<< std::chrono::duration_cast<std::chrono::microseconds>(legacyTime).count() << "us, templated decoder "
+		<< std::chrono::duration_cast<std::chrono::microseconds>(demuxTime).count() << "us" << std::endl;
+}
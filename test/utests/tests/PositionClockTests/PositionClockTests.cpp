@@ -0,0 +1,182 @@
+/*
+* If not stated otherwise in this file or this component's license file the
+* following copyright and licenses apply:
+*
+* Copyright 2025 RDK Management
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+#include <gtest/gtest.h>
+#include <thread>
+#include <vector>
+#include <atomic>
+#include <cstdlib>
+#include "PlayerPositionClock.h"
+
+class PositionClockTests : public ::testing::Test
+{
+protected:
+	PlayerPositionClock mClock;
+
+	void Sample(long long positionMs, int64_t timestampUs, double slope)
+	{
+		ASSERT_TRUE(mClock.TryBeginRefresh());
+		mClock.Publish(positionMs, timestampUs, slope);
+		mClock.EndRefresh();
+	}
+};
+
+TEST_F(PositionClockTests, NoSampleBeforePublish)
+{
+	long long position = -1;
+	int64_t age = -1;
+	EXPECT_FALSE(mClock.Read(PlayerPositionClock::NowUs(), position, age));
+	EXPECT_EQ(-1, position);
+	EXPECT_EQ(-1, age);
+}
+
+TEST_F(PositionClockTests, ExtrapolatesWhilePlaying)
+{
+	long long position = 0;
+	int64_t age = 0;
+	Sample(10000, 1000000, 1.0);
+	ASSERT_TRUE(mClock.Read(1250000, position, age));
+	EXPECT_EQ(10250, position);
+	EXPECT_EQ(250000, age);
+}
+
+TEST_F(PositionClockTests, HoldsWhilePaused)
+{
+	long long position = 0;
+	int64_t age = 0;
+	Sample(10000, 1000000, 0.0);
+	ASSERT_TRUE(mClock.Read(5000000, position, age));
+	EXPECT_EQ(10000, position);
+}
+
+TEST_F(PositionClockTests, ReadBeforeSampleTimeIsNotExtrapolatedBackwards)
+{
+	long long position = 0;
+	int64_t age = -1;
+	Sample(10000, 1000000, 1.0);
+	ASSERT_TRUE(mClock.Read(900000, position, age));
+	EXPECT_EQ(10000, position);
+	EXPECT_EQ(0, age);
+}
+
+TEST_F(PositionClockTests, InvalidateDiscardsSample)
+{
+	long long position = 0;
+	int64_t age = 0;
+	Sample(10000, 1000000, 1.0);
+	mClock.Invalidate();
+	EXPECT_FALSE(mClock.Read(1000000, position, age));
+}
+
+TEST_F(PositionClockTests, RefreshRacingInvalidateIsDropped)
+{
+	long long position = 0;
+	int64_t age = 0;
+	ASSERT_TRUE(mClock.TryBeginRefresh());
+	mClock.Invalidate();	// e.g. a seek while the position query was running
+	mClock.Publish(10000, 1000000, 1.0);
+	mClock.EndRefresh();
+	EXPECT_FALSE(mClock.Read(1000000, position, age));
+	Sample(20000, 2000000, 1.0);
+	ASSERT_TRUE(mClock.Read(2000000, position, age));
+	EXPECT_EQ(20000, position);
+}
+
+TEST_F(PositionClockTests, SingleRefresher)
+{
+	ASSERT_TRUE(mClock.TryBeginRefresh());
+	EXPECT_FALSE(mClock.TryBeginRefresh());
+	mClock.EndRefresh();
+	EXPECT_TRUE(mClock.TryBeginRefresh());
+	mClock.EndRefresh();
+}
+
+/* A playhead running 2% fast or slow, sampled every 100ms, must never be off by more than
+ * 2% of the sampling interval plus the millisecond truncation of sample and extrapolation */
+TEST_F(PositionClockTests, ErrorBoundedBySamplingInterval)
+{
+	const int64_t intervalUs = 100000;
+	const double speeds[] = {0.98, 1.0, 1.02};
+	for (double speed : speeds)
+	{
+		PlayerPositionClock clock;
+		int64_t lastSampleUs = -intervalUs;
+		for (int64_t nowUs = 0; nowUs <= 10000000; nowUs += 7000)
+		{
+			long long actualMs = (long long)(speed * (double)nowUs / 1000.0);
+			if (nowUs - lastSampleUs >= intervalUs)
+			{
+				ASSERT_TRUE(clock.TryBeginRefresh());
+				clock.Publish(actualMs, nowUs, 1.0);
+				clock.EndRefresh();
+				lastSampleUs = nowUs;
+			}
+			long long position = 0;
+			int64_t age = 0;
+			ASSERT_TRUE(clock.Read(nowUs, position, age));
+			ASSERT_LT(age, intervalUs);
+			long long bound = (long long)(0.02 * (double)intervalUs / 1000.0) + 2;
+			ASSERT_LE(std::llabs(position - actualMs), bound) << "speed " << speed << " at " << nowUs << "us";
+		}
+	}
+}
+
+/* Every published sample satisfies position == timestamp / 1000; a torn read would break it */
+TEST_F(PositionClockTests, ConcurrentReadsNeverTorn)
+{
+	std::atomic<bool> stop(false);
+	std::atomic<long> torn(0);
+	std::atomic<long> reads(0);
+	Sample(0, 0, 0.0);
+	std::vector<std::thread> readers;
+	for (int i = 0; i < 4; i++)
+	{
+		readers.emplace_back([this, &stop, &torn, &reads]()
+		{
+			while (!stop.load())
+			{
+				long long position = 0;
+				int64_t age = 0;
+				int64_t nowUs = (int64_t)1 << 40;
+				if (mClock.Read(nowUs, position, age) && position != (nowUs - age) / 1000)
+				{
+					torn++;
+				}
+				reads++;
+			}
+		});
+	}
+	for (long long k = 1; k <= 200000; k++)
+	{
+		ASSERT_TRUE(mClock.TryBeginRefresh());
+		mClock.Publish(k, k * 1000, 0.0);
+		mClock.EndRefresh();
+		if ((k % 1000) == 0)
+		{
+			mClock.Invalidate();
+		}
+	}
+	stop = true;
+	for (auto &reader : readers)
+	{
+		reader.join();
+	}
+	EXPECT_EQ(0, torn.load());
+	EXPECT_GT(reads.load(), 0);
+}